@@ -3,6 +3,10 @@
 #include <string.h>
 #include <ctype.h>
 
+#ifdef SCREEN_RENDERER
+#include "screen_stdio.h"  /* redraw only what changed instead of clearing the screen */
+#endif
+
 //check if windows or linux for the clear screen
 #ifdef _WIN32
 #define CLEAR "cls"
@@ -1,7 +1,18 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
+#if defined(SCREEN_RENDERER) && !defined(AGENT_PROTOCOL)
+#include "screen_stdio.h"  /* redraw only what changed instead of clearing the screen */
+#endif
+
+#ifdef AGENT_PROTOCOL
+#include "agent.h"
+static agent *session = NULL;  /* set by --agent; the screen is not cleared for an agent */
+#define system(command) (session != NULL ? 0 : system(command))
+#endif
+
 //check if windows or linux for the clear screen
 #ifdef _WIN32
 #define CLEAR "cls"
@@ -36,12 +47,127 @@ void instuctions(){
     printf("Good luck!\n");
 }
 
+/**
+ * @brief Tells an agent, if there is one, that the game is over, and closes the session.
+ */
+void finish(int account){
+#ifdef AGENT_PROTOCOL
+    if(session != NULL){
+        agent_field fields[] = {{"account", account, NULL}};
+        agent_finish(session, fields, 1);
+        agent_close(session);
+        session = NULL;
+    }
+#else
+    (void)account;
+#endif
+}
+
+#ifdef AGENT_PROTOCOL
+/**
+ * @brief Ends the game when the agent quits, the way every other game over does.
+ */
+void walk_away(int account){
+    finish(account);
+    exit(0);
+}
+#endif
+
+/**
+ * @brief Asks whether to show the instructions.
+ *
+ * @return 'y' or 'n', or anything else the player typed
+ */
+char read_choice(){
+    char choice;
+#ifdef AGENT_PROTOCOL
+    if(session != NULL){
+        static const char *const choices[] = {"y", "n"};
+        agent_field fields[] = {{"account", 500, NULL}};
+        const char *answer = agent_choose(session, fields, 1, choices, 2);
+        if(answer == NULL){
+            walk_away(500);
+        }
+        return answer[0];
+    }
+#endif
+    scanf("%c",&choice);
+    return choice;
+}
+
+/**
+ * @brief Asks for a wager until it is no more than the account.
+ */
+int read_wager(int account){
+    int wager;
+#ifdef AGENT_PROTOCOL
+    if(session != NULL){
+        agent_field fields[] = {{"account", account, NULL}};
+        long long answer = agent_choose_int(session, fields, 1, 0, account);
+        if(answer == AGENT_QUIT){
+            walk_away(account);
+        }
+        return (int)answer;
+    }
+#endif
+    scanf("%d",&wager);
+    while(wager > account){
+        system(CLEAR);
+        printf("You do not have that much money in your account.\n");
+        printf("How much do you want to wager? ");
+        scanf("%d",&wager);
+    }
+    return wager;
+}
+
+/**
+ * @brief Asks for the next location.
+ *
+ * An agent is offered every location the rules accept from here: inside
+ * the cube, with coordinates summing to at most one more or less.
+ */
+void read_move(coords *player, int account, int wager){
+#ifdef AGENT_PROTOCOL
+    if(session != NULL){
+        static char moves[27][6];
+        const char *choices[27];
+        int count = 0, sum = player->x + player->y + player->z;
+        agent_field fields[] = {
+            {"account", account, NULL}, {"wager", wager, NULL},
+            {"x", player->x, NULL}, {"y", player->y, NULL}, {"z", player->z, NULL},
+        };
+        for(int x = 1; x <= 3; x++){
+            for(int y = 1; y <= 3; y++){
+                for(int z = 1; z <= 3; z++){
+                    if(x + y + z >= sum - 1 && x + y + z <= sum + 1){
+                        snprintf(moves[count], sizeof(moves[count]), "%d,%d,%d", x, y, z);
+                        choices[count] = moves[count];
+                        count++;
+                    }
+                }
+            }
+        }
+        const char *move = agent_choose(session, fields, 5, choices, count);
+        if(move == NULL){
+            walk_away(account);
+        }
+        sscanf(move, "%d,%d,%d", &player->x, &player->y, &player->z);
+        return;
+    }
+#else
+    (void)account;
+    (void)wager;
+#endif
+    scanf("%d,%d,%d",&player->x,&player->y,&player->z);
+}
+
 void game(int money){
     coords player,playerold,mines[5];
     int wager,account = money;
     char choice;
     if(money == 0){
         printf("You have no money left. See ya next time.\n");
+        finish(0);
         exit(0);
     }
     player.x = 1;
@@ -50,13 +176,7 @@ void game(int money){
     
     printf("You have $%d in your account.\n",account);
     printf("How much do you want to wager? ");
-    scanf("%d",&wager);
-    while(wager > account){
-        system(CLEAR);
-        printf("You do not have that much money in your account.\n");
-        printf("How much do you want to wager? ");
-        scanf("%d",&wager);
-    }
+    wager = read_wager(account);
     srand(time(NULL));
     for(int i=0;i<5;i++){
         mines[i].x = rand()%3+1;
@@ -74,7 +194,7 @@ void game(int money){
         playerold.x = player.x;
         playerold.y = player.y;
         playerold.z = player.z;
-        scanf("%d,%d,%d",&player.x,&player.y,&player.z);
+        read_move(&player, account, wager);
         if(((player.x + player.y + player.z) > (playerold.x + playerold.y + playerold.z + 1)) || ((player.x + player.y + player.z) < (playerold.x + playerold.y + playerold.z -1))){
             system(CLEAR);
             printf("Illegal move!\n");
@@ -101,6 +221,7 @@ void game(int money){
             system(CLEAR);
             printf("You have no money left!\n");
             printf("Game over!\n");
+            finish(0);
             exit(0);
         }
     }
@@ -118,7 +239,7 @@ void init(){
 
     printf("Welcome to the game of Cube!\n");
     printf("wanna see the instructions? (y/n): ");
-    scanf("%c",&choice);
+    choice = read_choice();
     if(choice == 'y'){
         system(CLEAR);
         instuctions();
@@ -137,6 +258,22 @@ void init(){
     exit(0);
 }
 
-void main(){
+/**
+ * @brief Plays Cube. With --agent TRANSPORT (when built with AGENT_PROTOCOL) an agent plays instead of the console.
+ */
+int main(int argc, char *argv[]){
+#ifdef AGENT_PROTOCOL
+    if(argc == 3 && strcmp(argv[1], "--agent") == 0){
+        session = agent_open(argv[2], "cube");
+        if(session == NULL){
+            perror("agent");
+            return 1;
+        }
+    }
+#else
+    (void)argc;
+    (void)argv;
+#endif
     init();
+    return 0;
 }
\ No newline at end of file
@@ -1,26 +1,328 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <signal.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
+#include <unistd.h>
 
-float percent(int number, int total){
+#define MAX_DICE 100
+#define MAX_SIDES 1000
+#define CHUNK (1 << 20)  /* rolls between checks for an interrupt */
+#define MAGIC 0x3143454349444e52ULL  /* "RNDICEC1" */
+
+/**
+ * @brief A run in progress: its configuration, generator state and histogram.
+ *
+ * This is exactly what is checkpointed, so a run resumed from a checkpoint
+ * continues the same random sequence and ends with the same counts as one
+ * that was never interrupted.
+ */
+typedef struct{
+    uint64_t magic;
+    uint64_t dice;
+    uint64_t sides;
+    uint64_t seed;
+    uint64_t state;        /* generator state after `done` rolls */
+    uint64_t done;         /* rolls counted so far */
+    uint64_t rolls[MAX_DICE * MAX_SIDES + 1];
+}run_state;
+
+static volatile sig_atomic_t interrupted = 0;
+
+static void on_interrupt(int signal){
+    (void)signal;
+    interrupted = 1;
+}
+
+float percent(uint64_t number, uint64_t total){
     float percent;
     percent = (float)number / (float)total * 100;
     return percent;
 }
 
-int main(){
-    int dice1,dice2,times,rolls[13] = {0};
-    srand(time(NULL));
+/**
+ * @brief splitmix64: a small generator whose whole state is one integer, so it can be saved.
+ */
+static uint64_t next_random(uint64_t *state){
+    uint64_t z = (*state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief Number of histogram entries in use: sums 0 to dice * sides.
+ */
+static size_t histogram_size(const run_state *run){
+    return (size_t)(run->dice * run->sides + 1);
+}
+
+/**
+ * @brief Checksum over the used part of a run, FNV-1a.
+ */
+static uint64_t checksum(const run_state *run){
+    const unsigned char *p = (const unsigned char *)run;
+    size_t n = offsetof(run_state, rolls) + histogram_size(run) * sizeof(uint64_t);
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for(size_t i = 0; i < n; i++){
+        h = (h ^ p[i]) * 0x100000001b3ULL;
+    }
+    return h;
+}
+
+/**
+ * @brief Store file for a (dice, sides, seed) result.
+ */
+static void result_path(char *out, size_t size, const char *store, const run_state *run){
+    snprintf(out, size, "%s/dice-%" PRIu64 "x%" PRIu64 "-%" PRIu64 ".ckpt", store, run->dice, run->sides, run->seed);
+}
+
+/**
+ * @brief Makes a rename in the directory durable.
+ *
+ * @return 0 on success, -1 with errno set on failure
+ */
+static int sync_directory(const char *dir){
+    int fd = open(dir, O_RDONLY), rc;
+    if(fd < 0){
+        return -1;
+    }
+    rc = fsync(fd);
+    if(rc != 0){
+        int err = errno;
+        close(fd);
+        errno = err;
+        return -1;
+    }
+    return close(fd);
+}
+
+/**
+ * @brief Writes the run to its store file, atomically.
+ *
+ * The checkpoint goes to a temporary file that is synced and then renamed
+ * over the old one, so a crash at any point leaves either the old or the
+ * new checkpoint, never a torn one. The directory is synced after the
+ * rename, so the new checkpoint survives a crash once save returns.
+ *
+ * @return 0 on success, -1 with errno set on failure
+ */
+static int save(const char *store, const run_state *run){
+    char path[4096], temp[4200];
+    uint64_t sum = checksum(run);
+    size_t n = offsetof(run_state, rolls) + histogram_size(run) * sizeof(uint64_t);
+    FILE *f;
+
+    result_path(path, sizeof(path), store, run);
+    snprintf(temp, sizeof(temp), "%s.tmp", path);
+    f = fopen(temp, "wb");
+    if(f == NULL){
+        return -1;
+    }
+    if(fwrite(run, 1, n, f) != n || fwrite(&sum, sizeof(sum), 1, f) != 1 || fflush(f) != 0 || fsync(fileno(f)) != 0){
+        int err = errno;
+        fclose(f);
+        remove(temp);
+        errno = err;
+        return -1;
+    }
+    if(fclose(f) != 0 || rename(temp, path) != 0){
+        int err = errno;
+        remove(temp);
+        errno = err;
+        return -1;
+    }
+    return sync_directory(store);
+}
+
+/**
+ * @brief Loads the stored result for the run's (dice, sides, seed), if there is one.
+ *
+ * @return 1 if a valid result was loaded, 0 if there is none, -1 if the file is damaged
+ */
+static int load(const char *store, run_state *run){
+    char path[4096];
+    static run_state stored;
+    uint64_t sum;
+    size_t n;
+    FILE *f;
+
+    result_path(path, sizeof(path), store, run);
+    f = fopen(path, "rb");
+    if(f == NULL){
+        return 0;
+    }
+    n = offsetof(run_state, rolls);
+    if(fread(&stored, 1, n, f) != n || stored.magic != MAGIC || stored.dice != run->dice || stored.sides != run->sides
+       || stored.seed != run->seed){
+        fclose(f);
+        return -1;
+    }
+    n = histogram_size(&stored) * sizeof(uint64_t);
+    if(fread(stored.rolls, 1, n, f) != n || fread(&sum, sizeof(sum), 1, f) != 1 || sum != checksum(&stored)){
+        fclose(f);
+        return -1;
+    }
+    fclose(f);
+    memcpy(run, &stored, offsetof(run_state, rolls) + n);
+    return 1;
+}
+
+/**
+ * @brief Rolls until `target` rolls have been counted, checkpointing every `every` rolls.
+ *
+ * The finished run is checkpointed too, so it can be extended later.
+ * Checks for SIGINT between chunks of rolls; on one it checkpoints and stops early.
+ *
+ * @return Seconds spent writing checkpoints
+ */
+static double roll(run_state *run, uint64_t target, const char *store, uint64_t every, int *checkpoints){
+    uint64_t state = run->state;
+    uint64_t next_checkpoint = run->done + every;
+    double checkpoint_seconds = 0;
+
+    while(run->done < target && !interrupted){
+        uint64_t end = run->done + CHUNK < target ? run->done + CHUNK : target;
+        if(store != NULL && end > next_checkpoint){
+            end = next_checkpoint;
+        }
+        for(uint64_t i = run->done; i < end; i++){
+            uint64_t sum = 0;
+            for(uint64_t d = 0; d < run->dice; d++){
+                sum += ((next_random(&state) >> 32) * run->sides >> 32) + 1;
+            }
+            run->rolls[sum]++;
+        }
+        run->done = end;
+        run->state = state;
+
+        if(store != NULL && (run->done == next_checkpoint || run->done == target || interrupted)){
+            struct timespec a, b;
+            clock_gettime(CLOCK_MONOTONIC, &a);
+            if(save(store, run) != 0){
+                fprintf(stderr, "Error: cannot write checkpoint: %s\n", strerror(errno));
+                exit(EXIT_FAILURE);
+            }
+            clock_gettime(CLOCK_MONOTONIC, &b);
+            checkpoint_seconds += (b.tv_sec - a.tv_sec) + (b.tv_nsec - a.tv_nsec) / 1e9;
+            (*checkpoints)++;
+            next_checkpoint = run->done + every;
+        }
+    }
+    return checkpoint_seconds;
+}
+
+static void usage(void){
+    fprintf(stderr, "Usage: dice [--rolls N] [--dice N] [--sides N] [--seed N] [--store DIR] [--every N]\n");
+    exit(EXIT_FAILURE);
+}
+
+/**
+ * @brief Rolls dice and prints how often each sum came up.
+ *
+ * With no --rolls the count is asked for, as in the original. With --store
+ * the run is checkpointed to DIR every --every rolls and on Ctrl-C, and a
+ * later run with the same dice, sides and seed resumes from the checkpoint;
+ * asking for more rolls than are stored extends the stored result instead
+ * of starting again. Without --seed the seed is taken from the clock and
+ * printed, so the run can be resumed or extended.
+ */
+int main(int argc, char *argv[]){
+    static run_state run;
+    uint64_t times = 0, every = 100000000;
+    const char *store = NULL;
+    int have_seed = 0, checkpoints = 0, loaded;
+    struct timespec start, end;
+    double seconds, checkpoint_seconds;
+
+    run.magic = MAGIC;
+    run.dice = 2;
+    run.sides = 6;
+    for(int i = 1; i < argc; i += 2){
+        if(i + 1 >= argc){
+            usage();
+        }
+        if(strcmp(argv[i], "--rolls") == 0){
+            times = strtoull(argv[i + 1], NULL, 10);
+        }else if(strcmp(argv[i], "--dice") == 0){
+            run.dice = strtoull(argv[i + 1], NULL, 10);
+        }else if(strcmp(argv[i], "--sides") == 0){
+            run.sides = strtoull(argv[i + 1], NULL, 10);
+        }else if(strcmp(argv[i], "--seed") == 0){
+            run.seed = strtoull(argv[i + 1], NULL, 10);
+            have_seed = 1;
+        }else if(strcmp(argv[i], "--store") == 0){
+            store = argv[i + 1];
+        }else if(strcmp(argv[i], "--every") == 0){
+            every = strtoull(argv[i + 1], NULL, 10);
+        }else{
+            usage();
+        }
+    }
+    if(run.dice < 1 || run.dice > MAX_DICE || run.sides < 1 || run.sides > MAX_SIDES || every < 1){
+        fprintf(stderr, "Error: need 1 to %d dice of 1 to %d sides, and --every of at least 1\n", MAX_DICE, MAX_SIDES);
+        return EXIT_FAILURE;
+    }
+    if(!have_seed){
+        run.seed = (uint64_t)time(NULL);
+    }
+    run.state = run.seed;
+
     printf("This program simulates the rolling of a pair of dice\n");
-    printf("How many times do you want to roll the dice?(Higher the number longer the waiting time): ");
-    scanf("%d",&times);
-    for(int i = 0; i < times; i++){
-        dice1 = rand() % 6 + 1;
-        dice2 = rand() % 6 + 1;
-        rolls[dice1 + dice2]+=1;
+    if(times == 0){
+        int asked = 0;
+        printf("How many times do you want to roll the dice?(Higher the number longer the waiting time): ");
+        if(scanf("%d",&asked) != 1 || asked < 1){
+            return EXIT_FAILURE;
+        }
+        times = (uint64_t)asked;
+    }
+
+    loaded = store != NULL ? load(store, &run) : 0;
+    if(loaded < 0){
+        fprintf(stderr, "Error: stored result for this seed is damaged; remove it to start again\n");
+        return EXIT_FAILURE;
+    }
+    if(loaded){
+        printf("Resuming seed %" PRIu64 " from %" PRIu64 " stored rolls\n", run.seed, run.done);
+        if(run.done > times){
+            printf("The stored result has more rolls than asked for; showing all %" PRIu64 "\n", run.done);
+            times = run.done;
+        }
+    }else if(store != NULL || !have_seed){
+        printf("Seed %" PRIu64 "\n", run.seed);
+    }
+
+    signal(SIGINT, on_interrupt);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    {
+        uint64_t before = run.done;
+        checkpoint_seconds = roll(&run, times, store, every, &checkpoints);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+        if(interrupted){
+            printf("\nInterrupted after %" PRIu64 " rolls", run.done);
+            if(store != NULL){
+                printf("; run again with --store %s --dice %" PRIu64 " --sides %" PRIu64 " --seed %" PRIu64
+                       " --rolls %" PRIu64 " to resume", store, run.dice, run.sides, run.seed, times);
+            }
+            printf("\n");
+            return 130;
+        }
+        if(store != NULL && run.done > before){
+            printf("%" PRIu64 " rolls in %.2fs (%.1f million/s), %d checkpoints taking %.4fs (%.3f%% of the run)\n",
+                   run.done - before, seconds, (run.done - before) / seconds / 1e6, checkpoints, checkpoint_seconds,
+                   100 * checkpoint_seconds / seconds);
+        }
     }
+
     printf("The number of times each sum was rolled is:\n");
-    for(int i = 2; i <= 12; i++){
-        printf("%d: rolled %d times, or %f%c of the times\n",i,rolls[i],percent(rolls[i],times),(char)37);
+    for(uint64_t i = run.dice; i <= run.dice * run.sides; i++){
+        printf("%" PRIu64 ": rolled %" PRIu64 " times, or %f%c of the times\n",i,run.rolls[i],percent(run.rolls[i],times),(char)37);
     }
-}
\ No newline at end of file
+    return 0;
+}
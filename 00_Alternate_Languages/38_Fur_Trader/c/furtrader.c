@@ -28,6 +28,44 @@ const char *FUR_NAMES[FUR_TYPE_COUNT] = { "MINK", "BEAVER", "ERMINE", "FOX" };
 const char *FORT_NAMES[FORT_TYPE_COUNT] = { "HOCHELAGA (MONTREAL)", "STADACONA (QUEBEC)", "NEW YORK" };
 
 
+#ifdef AGENT_PROTOCOL
+#include "agent.h"
+
+/* Set by --agent; the player's status is reported to the agent at every decision */
+static agent       *session       = NULL;
+static const float *session_funds = NULL;
+static const int   *session_furs  = NULL;
+
+/* Fill in what the player can see: savings in cents and the fur inventory */
+int agentFields( agent_field *fields, const char *question )
+{
+    int i;
+    fields[0].name  = "question";
+    fields[0].text  = question;
+    fields[1].name  = "funds_cents";
+    fields[1].value = (long long)( *session_funds * 100 + ( *session_funds < 0 ? -0.5 : 0.5 ) );
+    fields[1].text  = NULL;
+    for ( i=0; i<FUR_TYPE_COUNT; i++ )
+    {
+        fields[2+i].name  = FUR_NAMES[i];
+        fields[2+i].value = session_furs[i];
+        fields[2+i].text  = NULL;
+    }
+    return 2 + FUR_TYPE_COUNT;
+}
+
+/* Every way the game ends goes through exit(), so the final status is sent from an exit handler */
+void finishAgent( void )
+{
+    agent_field fields[2 + FUR_TYPE_COUNT];
+    int count = agentFields( fields, "" );
+    agent_finish( session, fields + 1, count - 1 );
+    agent_close( session );
+    session = NULL;
+}
+#endif
+
+
 
 /* Print the words at the specified column */
 void printAtColumn( int column, const char *words )
@@ -88,11 +126,25 @@ int getNumericInput()
  * And convert to a single upper-case letter
  * Returns a character of 'Y' or 'N'.
  */
-char getYesOrNo()
+char getYesOrNo( const char *question )
 {
     char result = '!';
     char buffer[64];   /* somewhere to store user input */
 
+    print( question );
+#ifdef AGENT_PROTOCOL
+    if ( session != NULL )
+    {
+        static const char *const answers[] = { "YES", "NO" };
+        agent_field fields[2 + FUR_TYPE_COUNT];
+        int count = agentFields( fields, question );
+        const char *answer = agent_choose( session, fields, count, answers, 2 );
+        if ( answer == NULL )
+            exit( 0 );  /* the agent quit: STOP */
+        return answer[0];
+    }
+#endif
+
     while ( !( result == 'Y' || result == 'N' ) )       /* While the answer was not Yes or No */
     {
         print( "ANSWER YES OR NO" );
@@ -119,6 +171,19 @@ int getFortChoice()
 {
     int result = 0;
 
+#ifdef AGENT_PROTOCOL
+    if ( session != NULL )
+    {
+        static const char *const forts[] = { "1", "2", "3" };
+        agent_field fields[2 + FUR_TYPE_COUNT];
+        int count = agentFields( fields, "FORT" );
+        const char *answer = agent_choose( session, fields, count, forts, FORT_TYPE_COUNT );
+        if ( answer == NULL )
+            exit( 0 );  /* the agent quit: STOP */
+        return answer[0] - '0';
+    }
+#endif
+
     while ( result == 0 )
     {
         print( "" );
@@ -190,6 +255,18 @@ void getFursPurchase( int *furs )
     for ( i=0; i<FUR_TYPE_COUNT; i++ )
     {
         printf( "HOW MANY %s DO YOU HAVE\n", FUR_NAMES[i] );
+#ifdef AGENT_PROTOCOL
+        if ( session != NULL )
+        {
+            agent_field fields[2 + FUR_TYPE_COUNT];
+            int count = agentFields( fields, FUR_NAMES[i] );
+            long long answer = agent_choose_int( session, fields, count, 0, MAX_FURS );
+            if ( answer == AGENT_QUIT )
+                exit( 0 );  /* the agent quit: STOP */
+            furs[i] = (int)answer;
+            continue;
+        }
+#endif
         furs[i] = getNumericInput();
     }
 }
@@ -245,7 +322,11 @@ float randFloat()
 #define STATE_TRAVELLING    3
 #define STATE_TRADING       4
 
-int main( void )
+/*
+ * With --agent TRANSPORT (when built with AGENT_PROTOCOL) an agent
+ * plays instead of the console.
+ */
+int main( int argc, char *argv[] )
 {
     /* variables for storing player's status */
     float player_funds = 0;                              /* no money */
@@ -271,6 +352,24 @@ int main( void )
     float fox_value;      /* for calculating sales results */
 
 
+#ifdef AGENT_PROTOCOL
+    if ( argc == 3 && strcmp( argv[1], "--agent" ) == 0 )
+    {
+        session = agent_open( argv[2], "furtrader" );
+        if ( session == NULL )
+        {
+            perror( "agent" );
+            return 1;
+        }
+        session_funds = &player_funds;
+        session_furs  = player_furs;
+        atexit( finishAgent );
+    }
+#else
+    (void)argc;
+    (void)argv;
+#endif
+
     srand( time( NULL ) );  /* seed the random number generator */
 
     printAtColumn( 31, "FUR TRADER" );
@@ -288,8 +387,7 @@ int main( void )
             player_funds = 600;            /* Initial player start money */
             zeroInventory( player_furs );  /* Player fur inventory */
 
-            print( "DO YOU WISH TO TRADE FURS?" );
-            yes_or_no = getYesOrNo();
+            yes_or_no = getYesOrNo( "DO YOU WISH TO TRADE FURS?" );
             if ( yes_or_no == 'N' )
                 exit( 0 );                 /* STOP */
             game_state = STATE_TRADING;
@@ -321,8 +419,7 @@ int main( void )
         {
             which_fort = getFortChoice();
             showFortComment( which_fort );
-            print( "DO YOU WANT TO TRADE AT ANOTHER FORT?" );
-            yes_or_no = getYesOrNo();
+            yes_or_no = getYesOrNo( "DO YOU WANT TO TRADE AT ANOTHER FORT?" );
             if ( yes_or_no == 'N' )
                 game_state = STATE_TRAVELLING;
         }
@@ -460,8 +557,7 @@ int main( void )
             printf( "YOU NOW HAVE $ %1.2f INCLUDING YOUR PREVIOUS SAVINGS\n", player_funds );
 
             print( "" );
-            print( "DO YOU WANT TO TRADE FURS NEXT YEAR?" );
-            yes_or_no = getYesOrNo();
+            yes_or_no = getYesOrNo( "DO YOU WANT TO TRADE FURS NEXT YEAR?" );
             if ( yes_or_no == 'N' )
                 exit( 0 );             /* STOP */
             else
@@ -0,0 +1,804 @@
+/*
+ * Hangman host: many games of Hangman served by one process.
+ *
+ * compile with:
+ *    gcc -O2 -Wall host.c -o hangman_host
+ *
+ * A game needs no more than its word, the letters guessed, the positions
+ * showing and the number of misses, so every game is one 16-byte record
+ * in a flat table, and the gallows and the hidden word are drawn from the
+ * record only when asked for. One poll() loop serves every connection;
+ * a connection may play any number of games, but only the ones it
+ * started, and those it leaves unfinished end when it closes.
+ *
+ * Usage:
+ *    hangman_host --port PORT [--sessions N] [--words FILE]
+ *    hangman_host --bench N [--words FILE]
+ *    hangman_host --load PORT [--sessions N] [--connections N]
+ *
+ * --port serves on 127.0.0.1:PORT with room for --sessions games (default
+ * one million). --bench plays N games in process and reports memory per
+ * game and guesses per second. --load plays --sessions games against a
+ * running host over --connections connections, every round of guesses
+ * for a connection sent in one write.
+ *
+ * Protocol, one line per request and per reply:
+ *    NEW                 SESSION id
+ *    GUESS id letter     STATE id pattern misses PLAYING|WON|LOST
+ *    SHOW id             the gallows and the pattern, then a line "."
+ *    END id              ENDED id
+ *    anything else       ERROR reason
+ *
+ * A GUESS, SHOW or END for a game this connection did not start is
+ * answered ERROR NO SUCH GAME, as for one that does not exist.
+ */
+#define _POSIX_C_SOURCE 200809L
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MAX_LETTERS 32         /* one bit per position in session.revealed */
+#define MAX_MISSES 6
+#define MAX_WORDS 65536        /* session.word is 16 bits */
+#define NO_SESSION UINT32_MAX
+#define LINE_MAX_LENGTH 4096   /* longer request lines close the connection */
+#define MAX_CONNECTIONS 16384  /* the listener is not polled while this many are open */
+
+enum{ FREE, PLAYING, WON, LOST };
+static const char *const STATE_NAMES[] = { "FREE", "PLAYING", "WON", "LOST" };
+
+/* Guessing order used by --bench and --load: the commonest English letters first */
+static const char GUESS_ORDER[] = "etaoinshrdlcumwfgypbvkjxqz";
+
+/** One game: all that is needed to carry on playing it or draw it. */
+typedef struct{
+    uint32_t guessed;    /* bit n: letter 'a' + n has been guessed */
+    uint32_t revealed;   /* bit n: position n of the word is showing */
+    uint16_t word;       /* index into the dictionary */
+    uint8_t misses;      /* wrong guesses so far */
+    uint8_t state;       /* FREE, PLAYING, WON or LOST */
+    union{
+        uint32_t next_free;  /* next free record while this one is FREE */
+        uint32_t owner;      /* otherwise the connection that started it; 0 for --bench */
+    };
+}session;
+
+_Static_assert(sizeof(session) == 16, "a session record is 16 bytes");
+
+/** A dictionary word with, for each letter, the positions it fills. */
+typedef struct{
+    char text[MAX_LETTERS + 1];
+    uint32_t all;            /* every position */
+    uint32_t shown;          /* positions that are not letters, such as the hyphen in x-ray */
+    uint32_t positions[26];
+}word_entry;
+
+/** The flat session table and its free list. */
+typedef struct{
+    session *records;
+    uint32_t capacity;
+    uint32_t used;           /* records ever handed out; those above are untouched */
+    uint32_t free_head;
+    uint32_t live;
+    uint64_t guesses;
+}table;
+
+static word_entry *words;
+static uint32_t word_count;
+static uint32_t random_state = 2463534242u;
+
+/**
+ * @brief Loads the dictionary, keeping words of 1 to 32 letters, hyphens and apostrophes.
+ *
+ * @param path Word list, one word per line
+ */
+void load_words(const char *path){
+    char line[256];
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL){
+        printf("Error opening %s\n", path);
+        exit(1);
+    }
+    words = calloc(MAX_WORDS, sizeof(word_entry));
+    while (word_count < MAX_WORDS && fscanf(fp, "%255s", line) == 1){
+        size_t length = strlen(line);
+        word_entry *w = &words[word_count];
+        int ok = length > 0 && length <= MAX_LETTERS;
+        for (size_t i = 0; ok && i < length; i++){
+            char c = (char)(line[i] | 0x20);
+            if (c >= 'a' && c <= 'z'){
+                w->positions[c - 'a'] |= 1u << i;
+            }else if (line[i] == '-' || line[i] == '\''){
+                c = line[i];
+                w->shown |= 1u << i;
+            }else{
+                ok = 0;
+            }
+            w->text[i] = c;
+        }
+        if (ok){
+            w->text[length] = '\0';
+            w->all = length == 32 ? UINT32_MAX : (1u << length) - 1;
+            word_count++;
+        }else{
+            memset(w, 0, sizeof(*w));
+        }
+    }
+    fclose(fp);
+    if (word_count == 0){
+        printf("No words in %s\n", path);
+        exit(1);
+    }
+}
+
+/** @brief xorshift32: picking a word must not cost more than playing it. */
+uint32_t next_random(void){
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    return random_state;
+}
+
+/**
+ * @brief Allocates the table up front; records are only touched once handed out.
+ */
+void table_init(table *t, uint32_t capacity){
+    memset(t, 0, sizeof(*t));
+    t->records = calloc(capacity, sizeof(session));
+    if (t->records == NULL){
+        printf("Cannot allocate %u sessions\n", capacity);
+        exit(1);
+    }
+    t->capacity = capacity;
+    t->free_head = NO_SESSION;
+}
+
+/**
+ * @brief Starts a game with a random word.
+ *
+ * @param owner Id of the connection starting it
+ * @return The session id, or NO_SESSION if the table is full
+ */
+uint32_t session_new(table *t, uint32_t owner){
+    uint32_t id;
+    session *s;
+    if (t->free_head != NO_SESSION){
+        id = t->free_head;
+        t->free_head = t->records[id].next_free;
+    }else if (t->used < t->capacity){
+        id = t->used++;
+    }else{
+        return NO_SESSION;
+    }
+    s = &t->records[id];
+    s->word = (uint16_t)(next_random() % word_count);
+    s->guessed = 0;
+    s->revealed = words[s->word].shown;
+    s->misses = 0;
+    s->state = PLAYING;
+    s->owner = owner;
+    t->live++;
+    return id;
+}
+
+/** @brief Returns the session, or NULL if id is not a game in progress or finished. */
+session *session_get(table *t, uint32_t id){
+    if (id >= t->used || t->records[id].state == FREE){
+        return NULL;
+    }
+    return &t->records[id];
+}
+
+void session_end(table *t, uint32_t id){
+    session *s = &t->records[id];
+    s->state = FREE;
+    s->next_free = t->free_head;
+    t->free_head = id;
+    t->live--;
+}
+
+/**
+ * @brief Applies one guess. A letter guessed before changes nothing.
+ *
+ * @return 0, or -1 if the game is over or letter is not a to z
+ */
+int session_guess(table *t, session *s, char letter){
+    uint32_t bit, hits;
+    letter = (char)(letter | 0x20);
+    if (s->state != PLAYING || letter < 'a' || letter > 'z'){
+        return -1;
+    }
+    t->guesses++;
+    bit = 1u << (letter - 'a');
+    if (s->guessed & bit){
+        return 0;
+    }
+    s->guessed |= bit;
+    hits = words[s->word].positions[letter - 'a'];
+    if (hits){
+        s->revealed |= hits;
+        if (s->revealed == words[s->word].all){
+            s->state = WON;
+        }
+    }else if (++s->misses == MAX_MISSES){
+        s->state = LOST;
+    }
+    return 0;
+}
+
+/**
+ * @brief Writes the word as the player sees it, '_' for each hidden letter.
+ *
+ * @return Its length
+ */
+size_t render_pattern(const session *s, char *out){
+    const word_entry *w = &words[s->word];
+    size_t i;
+    for (i = 0; w->text[i] != '\0'; i++){
+        out[i] = (s->revealed >> i) & 1 ? w->text[i] : '_';
+    }
+    out[i] = '\0';
+    return i;
+}
+
+/* The gallows after 0 to 5 misses, as main.c draws them */
+static const char *const GALLOWS[6][4] = {
+    { "|",         "|",          "|",          "|" },
+    { "|        O", "|        |", "|",          "|" },
+    { "|        o", "|       /|", "|",          "|" },
+    { "|        o", "|       /|\\", "|",         "|" },
+    { "|        o", "|       /|\\", "|       /",  "|" },
+    { "|        o", "|       /|\\", "|       / \\", "|" },
+};
+
+/**
+ * @brief Draws the gallows, the hidden word and, once the game is lost, the word.
+ *
+ * @return Bytes written, at most 256
+ */
+size_t render_show(const session *s, char *out){
+    int stage = s->misses < 5 ? s->misses : 5;
+    size_t n = (size_t)sprintf(out, "----------\n|        |\n%s\n%s\n%s\n%s\n", GALLOWS[stage][0],
+                               GALLOWS[stage][1], GALLOWS[stage][2], GALLOWS[stage][3]);
+    n += render_pattern(s, out + n);
+    out[n++] = '\n';
+    if (s->state == LOST){
+        n += (size_t)sprintf(out + n, "You lose! The word was %s\n", words[s->word].text);
+    }else if (s->state == WON){
+        n += (size_t)sprintf(out + n, "You win!\n");
+    }
+    return n;
+}
+
+double seconds_now(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/** @brief Peak resident set in megabytes. */
+double peak_rss_mb(void){
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return (double)usage.ru_maxrss / (1024.0 * 1024.0);
+#else
+    return (double)usage.ru_maxrss / 1024.0;
+#endif
+}
+
+/**
+ * @brief Plays n games in process, every live game one guess per round.
+ */
+void bench(uint32_t n){
+    table t;
+    char buffer[256];
+    size_t rendered = 0;
+    uint64_t won = 0;
+    double start, created, played, drawn;
+    double rss_before = peak_rss_mb();
+
+    table_init(&t, n);
+    start = seconds_now();
+    for (uint32_t i = 0; i < n; i++){
+        session_new(&t, 0);
+    }
+    created = seconds_now();
+    for (int round = 0; round < 26; round++){
+        for (uint32_t id = 0; id < n; id++){
+            session *s = &t.records[id];
+            if (s->state == PLAYING){
+                session_guess(&t, s, GUESS_ORDER[(round + id % 4) % 26]);
+            }
+        }
+    }
+    played = seconds_now();
+    for (uint32_t id = 0; id < n; id++){
+        rendered += render_show(&t.records[id], buffer);
+        won += t.records[id].state == WON;
+    }
+    drawn = seconds_now();
+
+    printf("SESSIONS: %u  WORDS: %u  WON: %llu  LOST: %llu\n", n, word_count, (unsigned long long)won,
+           (unsigned long long)(n - won));
+    printf("MEMORY: %zu BYTES/SESSION  TABLE: %.1f MB  PEAK RSS: %.1f MB (+%.1f MB)\n", sizeof(session),
+           (double)n * sizeof(session) / (1024.0 * 1024.0), peak_rss_mb(), peak_rss_mb() - rss_before);
+    printf("NEW: %.0f SESSIONS/SEC  GUESSES: %llu  GUESSES/SEC: %.0f  (%.1f NS/GUESS)\n", n / (created - start),
+           (unsigned long long)t.guesses, t.guesses / (played - created), 1e9 * (played - created) / t.guesses);
+    printf("SHOW: %.0f RENDERS/SEC  (%.0f BYTES EACH)\n", n / (drawn - played), (double)rendered / n);
+}
+
+/* ---- serving ---- */
+
+typedef struct{
+    int fd;
+    uint32_t id;     /* from 1, never reused while the host runs */
+    uint32_t games;  /* games it started that are still in the table */
+    char in[LINE_MAX_LENGTH];
+    size_t in_length;
+    char *out;
+    size_t out_length, out_sent, out_capacity;
+}connection;
+
+static volatile sig_atomic_t stopping = 0;
+
+void stop(int signal_number){
+    (void)signal_number;
+    stopping = 1;
+}
+
+void append_output(connection *c, const char *data, size_t n){
+    if (c->out_length + n > c->out_capacity){
+        size_t capacity = c->out_capacity ? c->out_capacity : 4096;
+        while (capacity < c->out_length + n){
+            capacity *= 2;
+        }
+        c->out = realloc(c->out, capacity);
+        if (c->out == NULL){
+            abort();
+        }
+        c->out_capacity = capacity;
+    }
+    memcpy(c->out + c->out_length, data, n);
+    c->out_length += n;
+}
+
+/**
+ * @brief Parses "<id>" and returns its session, or NULL after replying with
+ * an error if there is no such game or another connection started it.
+ */
+session *find_session(table *t, connection *c, const char *arguments, uint32_t *id, char **rest){
+    unsigned long value = strtoul(arguments, rest, 10);
+    session *s = *rest == arguments || value > UINT32_MAX ? NULL : session_get(t, (uint32_t)value);
+    if (s == NULL || s->owner != c->id){
+        append_output(c, "ERROR NO SUCH GAME\n", 19);
+        s = NULL;
+    }
+    *id = (uint32_t)value;
+    return s;
+}
+
+/**
+ * @brief Answers one request line.
+ */
+void handle_line(table *t, connection *c, char *line){
+    char reply[320], pattern[MAX_LETTERS + 1], *rest;
+    uint32_t id;
+    session *s;
+    size_t n;
+
+    if (strcmp(line, "NEW") == 0){
+        id = session_new(t, c->id);
+        if (id == NO_SESSION){
+            n = (size_t)sprintf(reply, "ERROR TABLE FULL\n");
+        }else{
+            c->games++;
+            n = (size_t)sprintf(reply, "SESSION %u\n", id);
+        }
+    }else if (strncmp(line, "GUESS ", 6) == 0){
+        if ((s = find_session(t, c, line + 6, &id, &rest)) == NULL){
+            return;
+        }
+        while (*rest == ' '){
+            rest++;
+        }
+        if (rest[0] == '\0' || rest[1] != '\0' || session_guess(t, s, rest[0]) != 0){
+            n = (size_t)sprintf(reply, s->state == PLAYING ? "ERROR GUESS ONE LETTER\n" : "ERROR GAME OVER\n");
+        }else{
+            render_pattern(s, pattern);
+            n = (size_t)sprintf(reply, "STATE %u %s %u %s\n", id, pattern, s->misses, STATE_NAMES[s->state]);
+        }
+    }else if (strncmp(line, "SHOW ", 5) == 0){
+        if ((s = find_session(t, c, line + 5, &id, &rest)) == NULL){
+            return;
+        }
+        n = render_show(s, reply);
+        reply[n++] = '.';
+        reply[n++] = '\n';
+    }else if (strncmp(line, "END ", 4) == 0){
+        if (find_session(t, c, line + 4, &id, &rest) == NULL){
+            return;
+        }
+        session_end(t, id);
+        c->games--;
+        n = (size_t)sprintf(reply, "ENDED %u\n", id);
+    }else{
+        n = (size_t)sprintf(reply, "ERROR UNKNOWN REQUEST\n");
+    }
+    append_output(c, reply, n);
+}
+
+/**
+ * @brief Ends the games a closing connection left unfinished, so their
+ * records can be reused; no other connection could reach them.
+ */
+void end_games(table *t, connection *c){
+    for (uint32_t id = 0; id < t->used && c->games > 0; id++){
+        if (t->records[id].state != FREE && t->records[id].owner == c->id){
+            session_end(t, id);
+            c->games--;
+        }
+    }
+}
+
+/**
+ * @brief Reads what has arrived and answers every complete line.
+ *
+ * @return -1 if the connection should be closed
+ */
+int read_requests(table *t, connection *c){
+    for (;;){
+        char *start, *end;
+        ssize_t r = read(c->fd, c->in + c->in_length, sizeof(c->in) - c->in_length);
+        if (r < 0 && errno == EINTR){
+            continue;
+        }
+        if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)){
+            return 0;
+        }
+        if (r <= 0){
+            return -1;
+        }
+        c->in_length += (size_t)r;
+        start = c->in;
+        while ((end = memchr(start, '\n', c->in_length - (size_t)(start - c->in))) != NULL){
+            *end = '\0';
+            if (end > start && end[-1] == '\r'){
+                end[-1] = '\0';
+            }
+            handle_line(t, c, start);
+            start = end + 1;
+        }
+        c->in_length -= (size_t)(start - c->in);
+        memmove(c->in, start, c->in_length);
+        if (c->in_length == sizeof(c->in)){
+            return -1;
+        }
+    }
+}
+
+/**
+ * @brief Writes as much pending output as the socket takes.
+ *
+ * @return -1 if the connection should be closed
+ */
+int write_replies(connection *c){
+    while (c->out_sent < c->out_length){
+        ssize_t w = write(c->fd, c->out + c->out_sent, c->out_length - c->out_sent);
+        if (w < 0 && errno == EINTR){
+            continue;
+        }
+        if (w < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)){
+            return 0;
+        }
+        if (w <= 0){
+            return -1;
+        }
+        c->out_sent += (size_t)w;
+    }
+    c->out_length = c->out_sent = 0;
+    return 0;
+}
+
+/**
+ * @brief Makes room for n poll entries and n connections, doubling the arrays as needed.
+ */
+static void reserve(struct pollfd **polls, connection ***connections, size_t *allocated, size_t n){
+    if (n <= *allocated){
+        return;
+    }
+    while (*allocated < n){
+        *allocated = *allocated ? *allocated * 2 : 64;
+    }
+    *polls = realloc(*polls, *allocated * sizeof(**polls));
+    *connections = realloc(*connections, *allocated * sizeof(**connections));
+    if (*polls == NULL || *connections == NULL){
+        perror("realloc");
+        exit(1);
+    }
+}
+
+/**
+ * @brief Serves games on 127.0.0.1:port until interrupted.
+ *
+ * The listener is left out of the poll while MAX_CONNECTIONS are open or
+ * the process is out of file descriptors, so a full host waits for a
+ * connection to close instead of spinning on a listener it cannot accept from.
+ */
+void serve(int port, uint32_t capacity){
+    table t;
+    int one = 1, listener;
+    struct sockaddr_in address;
+    struct pollfd *polls = NULL;
+    connection **connections = NULL;
+    size_t count = 0, allocated = 0;
+    int out_of_fds = 0;
+    uint32_t connection_ids = 0;
+    double start;
+
+    table_init(&t, capacity);
+    listener = socket(AF_INET, SOCK_STREAM, 0);
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons((uint16_t)port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    if (listener < 0 || bind(listener, (struct sockaddr *)&address, sizeof(address)) != 0 || listen(listener, 128) != 0){
+        perror("listen");
+        exit(1);
+    }
+    fcntl(listener, F_SETFL, O_NONBLOCK);
+    signal(SIGPIPE, SIG_IGN);
+    signal(SIGINT, stop);
+    signal(SIGTERM, stop);
+    printf("HANGMAN HOST ON 127.0.0.1:%d  %u SESSIONS x %zu BYTES = %.1f MB  %u WORDS\n", port, capacity,
+           sizeof(session), (double)capacity * sizeof(session) / (1024.0 * 1024.0), word_count);
+    fflush(stdout);
+    start = seconds_now();
+
+    reserve(&polls, &connections, &allocated, 1);
+    while (!stopping){
+        polls[0].fd = count < MAX_CONNECTIONS && !out_of_fds ? listener : -1;
+        polls[0].events = POLLIN;
+        for (size_t i = 0; i < count; i++){
+            polls[i + 1].fd = connections[i]->fd;
+            polls[i + 1].events = (short)(POLLIN | (connections[i]->out_length > 0 ? POLLOUT : 0));
+        }
+        if (poll(polls, count + 1, -1) < 0){
+            continue;
+        }
+        for (size_t i = count; i-- > 0;){
+            connection *c = connections[i];
+            short events = polls[i + 1].revents;
+            int closing = 0;
+            if (events & (POLLIN | POLLHUP | POLLERR)){
+                closing = read_requests(&t, c) != 0;
+            }
+            if (!closing && c->out_length > 0){
+                closing = write_replies(c) != 0;
+            }
+            if (closing){
+                end_games(&t, c);
+                close(c->fd);
+                free(c->out);
+                free(c);
+                connections[i] = connections[--count];
+                out_of_fds = 0;
+            }
+        }
+        if (polls[0].revents & POLLIN){
+            int fd;
+            while (count < MAX_CONNECTIONS && (fd = accept(listener, NULL, NULL)) >= 0){
+                connection *c;
+                reserve(&polls, &connections, &allocated, count + 2);  /* the listener and one more */
+                c = calloc(1, sizeof(connection));
+                fcntl(fd, F_SETFL, O_NONBLOCK);
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+                c->fd = fd;
+                c->id = ++connection_ids;
+                connections[count++] = c;
+            }
+            if (count < MAX_CONNECTIONS && (errno == EMFILE || errno == ENFILE)){
+                out_of_fds = 1;
+            }
+        }
+    }
+    printf("\nGUESSES: %llu  GUESSES/SEC: %.0f  LIVE SESSIONS: %u  PEAK RSS: %.1f MB\n",
+           (unsigned long long)t.guesses, t.guesses / (seconds_now() - start), t.live, peak_rss_mb());
+}
+
+/* ---- load generator ---- */
+
+typedef struct{
+    int fd;
+    char in[65536];
+    size_t in_start, in_length;
+    uint32_t *ids;           /* this connection's games */
+    uint32_t *playing;       /* those still being played */
+    uint32_t active, total;
+}load_connection;
+
+/** @brief Returns the next reply line, reading more as needed; exits if the host goes away. */
+char *next_line(load_connection *c){
+    for (;;){
+        char *start = c->in + c->in_start;
+        char *end = memchr(start, '\n', c->in_length - c->in_start);
+        ssize_t r;
+        if (end != NULL){
+            *end = '\0';
+            c->in_start = (size_t)(end + 1 - c->in);
+            return start;
+        }
+        c->in_length -= c->in_start;
+        memmove(c->in, start, c->in_length);
+        c->in_start = 0;
+        r = read(c->fd, c->in + c->in_length, sizeof(c->in) - c->in_length);
+        if (r <= 0){
+            printf("Host closed the connection\n");
+            exit(1);
+        }
+        c->in_length += (size_t)r;
+    }
+}
+
+void send_all(int fd, const char *data, size_t n){
+    while (n > 0){
+        ssize_t w = write(fd, data, n);
+        if (w <= 0){
+            perror("write");
+            exit(1);
+        }
+        data += w;
+        n -= (size_t)w;
+    }
+}
+
+/**
+ * @brief Plays games against a running host, one round of guesses per connection per write.
+ */
+void load(int port, uint32_t sessions, uint32_t connection_count){
+    load_connection *c = calloc(connection_count, sizeof(load_connection));
+    char *request = malloc((size_t)(sessions / connection_count + 1) * 24);
+    uint64_t guesses = 0, bytes = 0, won = 0;
+    double start, finish;
+    struct sockaddr_in address;
+
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons((uint16_t)port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    for (uint32_t i = 0; i < connection_count; i++){
+        int one = 1;
+        c[i].fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (c[i].fd < 0 || connect(c[i].fd, (struct sockaddr *)&address, sizeof(address)) != 0){
+            perror("connect");
+            exit(1);
+        }
+        setsockopt(c[i].fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        c[i].total = sessions / connection_count + (i < sessions % connection_count);
+        c[i].ids = malloc((c[i].total + 1) * sizeof(uint32_t));
+        c[i].playing = malloc((c[i].total + 1) * sizeof(uint32_t));
+    }
+
+    /* Start every game: all of a connection's NEW requests in one write */
+    for (uint32_t i = 0; i < connection_count; i++){
+        size_t n = 0;
+        for (uint32_t k = 0; k < c[i].total; k++){
+            memcpy(request + n, "NEW\n", 4);
+            n += 4;
+        }
+        send_all(c[i].fd, request, n);
+    }
+    for (uint32_t i = 0; i < connection_count; i++){
+        for (uint32_t k = 0; k < c[i].total; k++){
+            char *line = next_line(&c[i]);
+            if (sscanf(line, "SESSION %u", &c[i].ids[k]) != 1){
+                printf("Host refused a game: %s\n", line);
+                exit(1);
+            }
+            c[i].playing[k] = c[i].ids[k];
+        }
+        c[i].active = c[i].total;
+    }
+
+    start = seconds_now();
+    for (int round = 0; round < 26; round++){
+        for (uint32_t i = 0; i < connection_count; i++){
+            size_t n = 0;
+            for (uint32_t k = 0; k < c[i].active; k++){
+                uint32_t id = c[i].playing[k];
+                n += (size_t)sprintf(request + n, "GUESS %u %c\n", id, GUESS_ORDER[(round + id % 4) % 26]);
+            }
+            send_all(c[i].fd, request, n);
+            bytes += n;
+            guesses += c[i].active;
+        }
+        for (uint32_t i = 0; i < connection_count; i++){
+            uint32_t still = 0, asked = c[i].active;
+            for (uint32_t k = 0; k < asked; k++){
+                char *line = next_line(&c[i]);
+                bytes += strlen(line) + 1;
+                if (strstr(line, " PLAYING") != NULL){
+                    c[i].playing[still++] = c[i].playing[k];
+                }else{
+                    won += strstr(line, " WON") != NULL;
+                }
+            }
+            c[i].active = still;
+        }
+    }
+    finish = seconds_now();
+
+    /* End the games, so the next run finds the host's table empty */
+    for (uint32_t i = 0; i < connection_count; i++){
+        size_t n = 0;
+        for (uint32_t k = 0; k < c[i].total; k++){
+            n += (size_t)sprintf(request + n, "END %u\n", c[i].ids[k]);
+        }
+        send_all(c[i].fd, request, n);
+    }
+    for (uint32_t i = 0; i < connection_count; i++){
+        for (uint32_t k = 0; k < c[i].total; k++){
+            next_line(&c[i]);
+        }
+        close(c[i].fd);
+    }
+    printf("SESSIONS: %u  CONNECTIONS: %u  WON: %llu  LOST: %llu\n", sessions, connection_count,
+           (unsigned long long)won, (unsigned long long)(sessions - won));
+    printf("GUESSES: %llu  GUESSES/SEC: %.0f  BYTES/GUESS: %.1f  TIME: %.2fs\n", (unsigned long long)guesses,
+           guesses / (finish - start), (double)bytes / guesses, finish - start);
+}
+
+void usage(void){
+    printf("Usage: hangman_host --port PORT [--sessions N] [--words FILE]\n");
+    printf("       hangman_host --bench N [--words FILE]\n");
+    printf("       hangman_host --load PORT [--sessions N] [--connections N]\n");
+    exit(1);
+}
+
+int main(int argc, char *argv[]){
+    const char *mode = NULL, *words_path = "dictionary.txt";
+    long value = 0, sessions = 1000000, connections = 16;
+
+    for (int i = 1; i + 1 < argc; i += 2){
+        if (strcmp(argv[i], "--port") == 0 || strcmp(argv[i], "--bench") == 0 || strcmp(argv[i], "--load") == 0){
+            mode = argv[i];
+            value = atol(argv[i + 1]);
+        }else if (strcmp(argv[i], "--sessions") == 0){
+            sessions = atol(argv[i + 1]);
+        }else if (strcmp(argv[i], "--connections") == 0){
+            connections = atol(argv[i + 1]);
+        }else if (strcmp(argv[i], "--words") == 0){
+            words_path = argv[i + 1];
+        }else{
+            usage();
+        }
+    }
+    if (mode == NULL || value <= 0 || sessions <= 0 || sessions > (long)NO_SESSION - 1 || connections <= 0){
+        usage();
+    }
+
+    if (strcmp(mode, "--load") == 0){
+        load((int)value, (uint32_t)sessions, (uint32_t)(connections < sessions ? connections : sessions));
+        return 0;
+    }
+    load_words(words_path);
+    if (strcmp(mode, "--bench") == 0){
+        bench((uint32_t)value);
+    }else{
+        serve((int)value, (uint32_t)sessions);
+    }
+    return 0;
+}
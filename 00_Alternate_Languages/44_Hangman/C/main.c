@@ -4,6 +4,15 @@
 #include <time.h>
 #define MAX_WORDS 100
 
+#if defined(SCREEN_RENDERER) && !defined(AGENT_PROTOCOL)
+#include "screen_stdio.h"  /* redraw only what changed instead of clearing the screen */
+#endif
+
+#ifdef AGENT_PROTOCOL
+#include "agent.h"
+static agent *session = NULL;  /* set by --agent */
+#endif
+
 //check if windows or linux for the clear screen
 #ifdef _WIN32
 #define CLEAR "cls"
@@ -11,6 +20,11 @@
 #define CLEAR "clear"
 #endif
 
+#if defined(SCREEN_RENDERER) && !defined(AGENT_PROTOCOL)
+#undef CLEAR
+#define CLEAR system("clear")  /* starts a new frame; in the other builds CLEAR stays the no-op it always was */
+#endif
+
 /**
  * @brief Prints the stage of the hangman based on the number of wrong guesses.
  * 
@@ -96,7 +110,72 @@ char* random_word_picker(){
 
 
 
-void main(void){
+/**
+ * @brief Reads the player's guess into guess.
+ *
+ * An agent is offered one letter at a time and sees the word as guessed so far.
+ *
+ * @return 0 if the agent quit, 1 otherwise
+ */
+int read_guess(char* guess, const char* hidden_word, int wrong_guesses, int correct_guesses){
+#ifdef AGENT_PROTOCOL
+    if (session != NULL){
+        static const char *const letters[] = {
+            "a", "b", "c", "d", "e", "f", "g", "h", "i", "j", "k", "l", "m",
+            "n", "o", "p", "q", "r", "s", "t", "u", "v", "w", "x", "y", "z",
+        };
+        agent_field fields[] = {
+            {"word", 0, hidden_word}, {"wrong", wrong_guesses, NULL}, {"correct", correct_guesses, NULL},
+        };
+        const char* letter = agent_choose(session, fields, 3, letters, 26);
+        if (letter == NULL){
+            return 0;
+        }
+        strcpy(guess, letter);
+        return 1;
+    }
+#else
+    (void)hidden_word;
+    (void)wrong_guesses;
+    (void)correct_guesses;
+#endif
+    scanf("%s", guess);
+    return 1;
+}
+
+/**
+ * @brief Tells an agent, if there is one, how the game ended, and closes the session.
+ */
+void finish(const char* word, int wrong_guesses){
+#ifdef AGENT_PROTOCOL
+    if (session != NULL){
+        agent_field fields[] = {{"word", 0, word}, {"wrong", wrong_guesses, NULL}, {"won", wrong_guesses < 6, NULL}};
+        agent_finish(session, fields, 3);
+        agent_close(session);
+        session = NULL;
+    }
+#else
+    (void)word;
+    (void)wrong_guesses;
+#endif
+}
+
+/**
+ * @brief Plays Hangman. With --agent TRANSPORT (when built with AGENT_PROTOCOL) an agent plays instead of the console.
+ */
+int main(int argc, char* argv[]){
+#ifdef AGENT_PROTOCOL
+    if (argc == 3 && strcmp(argv[1], "--agent") == 0){
+        session = agent_open(argv[2], "hangman");
+        if (session == NULL){
+            perror("agent");
+            return 1;
+        }
+    }
+#else
+    (void)argc;
+    (void)argv;
+#endif
     char* word = malloc(sizeof(char) * 100);
     word = random_word_picker();
     char* hidden_word = malloc(sizeof(char) * 100);
@@ -113,7 +192,10 @@ void main(void){
         print_hangman(stage);
         printf("%s\n", hidden_word);
         printf("Enter a guess: ");
-        scanf("%s", guess);
+        if (!read_guess(guess, hidden_word, wrong_guesses, correct_guesses)){
+            finish(word, wrong_guesses);  /* the agent quit */
+            return 0;
+        }
         for (int i = 0; i < strlen(word); i++){
             if (strcmp(guess,word) == 0){
                 correct_guesses = strlen(word);
@@ -134,4 +216,6 @@ void main(void){
     else {
         printf("You win!\n");
     }
+    finish(word, wrong_guesses);
+    return 0;
 }
\ No newline at end of file
@@ -0,0 +1,323 @@
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <print>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+#include <netinet/in.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+/**
+ * @brief A decision as decoded from an observation: the legal actions, or none once the game is over.
+ */
+struct Decision {
+  std::uint8_t flags = 0;
+  std::uint8_t kind = 0;  ///< 0 none, 1 choice, 2 range
+  std::vector<std::string> choices;
+  std::int64_t min = 0, max = 0;
+};
+
+constexpr std::uint8_t ACTED = 1, DONE = 2, REJECTED = 4;
+
+/**
+ * @brief Reads fields of a frame in the protocol's encoding.
+ */
+class Reader {
+public:
+  explicit Reader(std::string_view data) : data(data) {}
+
+  std::uint64_t integer(std::size_t bytes) {
+    need(bytes);
+    std::uint64_t v = 0;
+    for (std::size_t i = 0; i < bytes; ++i) v |= std::uint64_t{static_cast<std::uint8_t>(data[at + i])} << (8 * i);
+    at += bytes;
+    return v;
+  }
+
+  std::string string() {
+    const std::size_t n = integer(1);
+    need(n);
+    std::string s(data.substr(at, n));
+    at += n;
+    return s;
+  }
+
+private:
+  void need(std::size_t n) const {
+    if (at + n > data.size()) throw std::runtime_error("truncated frame");
+  }
+
+  std::string_view data;
+  std::size_t at = 0;
+};
+
+/**
+ * @brief One end of a protocol connection.
+ */
+class Connection {
+public:
+  Connection(int in, int out) : in(in), out(out) {}
+
+  /**
+   * @brief Reads one frame, type byte first.
+   *
+   * @throws std::runtime_error if the game closed the connection
+   */
+  std::string receive() {
+    unsigned char header[4];
+    read_exactly(header, 4);
+    const std::uint32_t n = header[0] | header[1] << 8 | header[2] << 16 | std::uint32_t{header[3]} << 24;
+    std::string frame(n, '\0');
+    read_exactly(frame.data(), n);
+    received += 4 + n;
+    return frame;
+  }
+
+  void send(const std::string& payload) {
+    std::string frame(4, '\0');
+    for (int i = 0; i < 4; ++i) frame[i] = static_cast<char>(payload.size() >> (8 * i));
+    frame += payload;
+    for (std::size_t done = 0; done < frame.size();) {
+      const ssize_t n = ::write(out, frame.data() + done, frame.size() - done);
+      if (n < 0 && errno == EINTR) continue;
+      if (n <= 0) throw std::system_error(errno, std::generic_category(), "write to game");
+      done += static_cast<std::size_t>(n);
+    }
+    sent += frame.size();
+  }
+
+  std::uint64_t received = 0, sent = 0;
+
+private:
+  void read_exactly(void* p, std::size_t n) {
+    auto* bytes = static_cast<char*>(p);
+    while (n > 0) {
+      const ssize_t r = ::read(in, bytes, n);
+      if (r < 0 && errno == EINTR) continue;
+      if (r <= 0) throw std::runtime_error("game closed the connection");
+      bytes += r;
+      n -= static_cast<std::size_t>(r);
+    }
+  }
+
+  int in, out;
+};
+
+/**
+ * @brief Decodes an observations frame and returns its last observation, the one the game is waiting on.
+ *
+ * @param acted Incremented for every observation answered from the batch
+ */
+Decision last_decision(std::string_view frame, std::uint64_t& acted) {
+  if (frame.empty() || frame[0] != 'O') throw std::runtime_error("expected an observations frame");
+  Reader r(frame.substr(1));
+  const std::size_t count = r.integer(2);
+  Decision d;
+  for (std::size_t i = 0; i < count; ++i) {
+    d = Decision{};
+    r.integer(4);  // step
+    d.flags = static_cast<std::uint8_t>(r.integer(1));
+    for (std::size_t fields = r.integer(1); fields > 0; --fields) {
+      r.string();
+      if (r.integer(1) == 1) {
+        r.string();
+      } else {
+        r.integer(8);
+      }
+    }
+    d.kind = static_cast<std::uint8_t>(r.integer(1));
+    if (d.kind == 1) {
+      for (std::size_t n = r.integer(1); n > 0; --n) d.choices.push_back(r.string());
+    } else if (d.kind == 2) {
+      d.min = static_cast<std::int64_t>(r.integer(8));
+      d.max = static_cast<std::int64_t>(r.integer(8));
+    }
+    if (d.flags & ACTED) {
+      r.string();
+      acted += !(d.flags & REJECTED);
+    }
+  }
+  if (count == 0) throw std::runtime_error("empty observations frame");
+  return d;
+}
+
+struct Totals {
+  std::uint64_t games = 0, steps = 0, frames = 0, rejected = 0;
+};
+
+/**
+ * @brief Plays one game with uniformly random legal actions, batch actions per message.
+ *
+ * Later actions in a batch are drawn from the legal set of the decision
+ * the game is waiting on, on the guess that the next decisions look alike.
+ */
+void play(Connection& game, std::size_t batch, std::mt19937_64& rng, Totals& totals) {
+  const std::string hello = game.receive();
+  if (hello.size() < 2 || hello[0] != 'H' || hello[1] != 1) throw std::runtime_error("not a version 1 agent protocol game");
+
+  auto pick = [&](const Decision& d) {
+    if (d.kind == 1) return d.choices[std::uniform_int_distribution<std::size_t>(0, d.choices.size() - 1)(rng)];
+    // Keep integers near the bottom of a wide range, where the games' decisions usually are.
+    const std::int64_t top = d.max - d.min > 1000 ? d.min + 1000 : d.max;
+    return std::to_string(std::uniform_int_distribution<std::int64_t>(d.min, top)(rng));
+  };
+
+  while (true) {
+    const Decision d = last_decision(game.receive(), totals.steps);
+    ++totals.frames;
+    if (d.flags & REJECTED) ++totals.rejected;
+    if (d.flags & DONE) break;
+    if (d.kind == 0) throw std::runtime_error("decision without legal actions");
+
+    std::string actions = "A";
+    actions += static_cast<char>(batch & 0xff);
+    actions += static_cast<char>(batch >> 8);
+    for (std::size_t i = 0; i < batch; ++i) {
+      const std::string a = pick(d);
+      actions += static_cast<char>(a.size());
+      actions += a;
+    }
+    game.send(actions);
+    ++totals.steps;  // the first action answers the decision just shown
+  }
+  ++totals.games;
+}
+
+/**
+ * @brief Starts the game with --agent - and returns its pid, with pipes to and from it.
+ */
+pid_t spawn(std::vector<char*> argv, int& to_game, int& from_game) {
+  int down[2], up[2];
+  if (::pipe(down) != 0 || ::pipe(up) != 0) throw std::system_error(errno, std::generic_category(), "pipe");
+  static char flag[] = "--agent", stdio[] = "-";
+  argv.push_back(flag);
+  argv.push_back(stdio);
+  argv.push_back(nullptr);
+  const pid_t pid = ::fork();
+  if (pid < 0) throw std::system_error(errno, std::generic_category(), "fork");
+  if (pid == 0) {
+    ::dup2(down[0], STDIN_FILENO);
+    ::dup2(up[1], STDOUT_FILENO);
+    for (int fd : {down[0], down[1], up[0], up[1]}) ::close(fd);
+    ::execvp(argv[0], argv.data());
+    _exit(127);
+  }
+  ::close(down[0]);
+  ::close(up[1]);
+  to_game = down[1];
+  from_game = up[0];
+  return pid;
+}
+
+/**
+ * @brief Connects to a game waiting on "tcp:PORT" or "unix:PATH".
+ */
+int connect_to(std::string_view address) {
+  int fd = -1;
+  if (address.starts_with("tcp:")) {
+    sockaddr_in a{};
+    a.sin_family = AF_INET;
+    a.sin_port = htons(static_cast<std::uint16_t>(std::stoul(std::string(address.substr(4)))));
+    a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd >= 0 && ::connect(fd, reinterpret_cast<sockaddr*>(&a), sizeof(a)) != 0) fd = (::close(fd), -1);
+  } else if (address.starts_with("unix:") && address.size() - 5 < sizeof(sockaddr_un::sun_path)) {
+    sockaddr_un a{};
+    a.sun_family = AF_UNIX;
+    address.substr(5).copy(a.sun_path, address.size() - 5);
+    fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd >= 0 && ::connect(fd, reinterpret_cast<sockaddr*>(&a), sizeof(a)) != 0) fd = (::close(fd), -1);
+  } else {
+    throw std::invalid_argument("address must be tcp:PORT or unix:PATH");
+  }
+  if (fd < 0) throw std::system_error(errno, std::generic_category(), std::string(address));
+  return fd;
+}
+
+}  // namespace
+
+/**
+ * @brief Reference agent: plays games with random legal actions and reports the protocol's throughput.
+ *
+ * Starts the game command given after "--" with "--agent -" appended, once
+ * per game, or with --connect plays one game against a game already
+ * waiting on a socket. --batch sets how many actions go in each message.
+ *
+ * Usage: agent_play [--games N] [--batch N] [--seed N] (-- GAME ARGS... | --connect ADDRESS)
+ */
+int main(int argc, char* argv[]) {
+  std::uint64_t games = 100;
+  std::size_t batch = 1;
+  std::uint64_t seed = 1;
+  std::string connect;
+  std::vector<char*> command;
+
+  int i = 1;
+  for (; i + 1 < argc && std::string_view(argv[i]) != "--"; i += 2) {
+    std::string_view flag = argv[i];
+    if (flag == "--games") {
+      games = std::stoull(argv[i + 1]);
+    } else if (flag == "--batch") {
+      batch = std::clamp<std::size_t>(std::stoull(argv[i + 1]), 1, 65535);
+    } else if (flag == "--seed") {
+      seed = std::stoull(argv[i + 1]);
+    } else if (flag == "--connect") {
+      connect = argv[i + 1];
+    } else {
+      break;
+    }
+  }
+  if (i < argc && std::string_view(argv[i]) == "--") command.assign(argv + i + 1, argv + argc);
+  if (command.empty() == connect.empty()) {
+    std::println(stderr, "Usage: agent_play [--games N] [--batch N] [--seed N] (-- GAME ARGS... | --connect ADDRESS)");
+    return EXIT_FAILURE;
+  }
+
+  try {
+    ::signal(SIGPIPE, SIG_IGN);
+    std::mt19937_64 rng(seed);
+    Totals totals;
+    std::uint64_t bytes = 0;
+    const auto start = std::chrono::steady_clock::now();
+    if (!connect.empty()) {
+      const int fd = connect_to(connect);
+      Connection game(fd, fd);
+      play(game, batch, rng, totals);
+      bytes = game.received + game.sent;
+      ::close(fd);
+    } else {
+      for (std::uint64_t g = 0; g < games; ++g) {
+        int to_game = -1, from_game = -1;
+        const pid_t pid = spawn(command, to_game, from_game);
+        Connection game(from_game, to_game);
+        play(game, batch, rng, totals);
+        bytes += game.received + game.sent;
+        ::close(to_game);
+        ::close(from_game);
+        ::waitpid(pid, nullptr, 0);
+      }
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::println("GAMES: {}  STEPS: {}  MESSAGES: {}  REJECTED: {}  BATCH: {}", totals.games, totals.steps,
+                 totals.frames, totals.rejected, batch);
+    std::println("STEPS/SEC: {:.0f}  STEPS/MESSAGE: {:.2f}  BYTES/STEP: {:.1f}  TIME: {:.2f}s", totals.steps / seconds,
+                 static_cast<double>(totals.steps) / static_cast<double>(totals.frames),
+                 static_cast<double>(bytes) / static_cast<double>(totals.steps), seconds);
+  } catch (const std::exception& e) {
+    std::println(stderr, "Error: {}", e.what());
+    return EXIT_FAILURE;
+  }
+}
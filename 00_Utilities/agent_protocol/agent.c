@@ -0,0 +1,436 @@
+#define _GNU_SOURCE
+#include "agent.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#define FLAG_ACTED 1
+#define FLAG_DONE 2
+#define FLAG_REJECTED 4
+
+#define LEGAL_NONE 0
+#define LEGAL_CHOICE 1
+#define LEGAL_RANGE 2
+
+struct agent{
+    int in;
+    int out;
+    int finished;
+    int quit;              /* the agent quit or went away; decisions return at once */
+    unsigned long step;
+
+    /* observations frame being built */
+    unsigned char *frame;
+    size_t length;
+    size_t capacity;
+    unsigned count;
+    size_t flags_at;       /* offset of the last observation's flags byte */
+
+    /* last actions frame and the actions in it not yet used */
+    unsigned char *actions;
+    size_t actions_capacity;
+    size_t next_action;
+    unsigned actions_left;
+
+    char chosen[256];
+};
+
+static agent *open_agent = NULL;  /* for the exit handler */
+
+static void put(agent *a, const void *data, size_t n){
+    if(a->length + n > a->capacity){
+        size_t capacity = a->capacity ? a->capacity : 4096;
+        while(capacity < a->length + n){
+            capacity *= 2;
+        }
+        a->frame = realloc(a->frame, capacity);
+        if(a->frame == NULL){
+            abort();
+        }
+        a->capacity = capacity;
+    }
+    memcpy(a->frame + a->length, data, n);
+    a->length += n;
+}
+
+static void put_u8(agent *a, unsigned v){
+    unsigned char b = (unsigned char)v;
+    put(a, &b, 1);
+}
+
+static void put_u32(agent *a, uint32_t v){
+    unsigned char b[4] = {(unsigned char)v, (unsigned char)(v >> 8), (unsigned char)(v >> 16), (unsigned char)(v >> 24)};
+    put(a, b, 4);
+}
+
+static void put_i64(agent *a, long long value){
+    uint64_t v = (uint64_t)value;
+    unsigned char b[8];
+    for(int i = 0; i < 8; i++){
+        b[i] = (unsigned char)(v >> (8 * i));
+    }
+    put(a, b, 8);
+}
+
+static void put_string(agent *a, const char *s){
+    size_t n = strlen(s);
+    if(n > 255){
+        n = 255;
+    }
+    put_u8(a, (unsigned)n);
+    put(a, s, n);
+}
+
+static void write_all(agent *a, const unsigned char *p, size_t n){
+    while(n > 0){
+        ssize_t w = write(a->out, p, n);
+        if(w < 0 && errno == EINTR){
+            continue;
+        }
+        if(w <= 0){
+            a->quit = 1;  /* the agent went away */
+            return;
+        }
+        p += w;
+        n -= (size_t)w;
+    }
+}
+
+static int read_all(agent *a, unsigned char *p, size_t n){
+    while(n > 0){
+        ssize_t r = read(a->in, p, n);
+        if(r < 0 && errno == EINTR){
+            continue;
+        }
+        if(r <= 0){
+            return -1;
+        }
+        p += r;
+        n -= (size_t)r;
+    }
+    return 0;
+}
+
+/* Starts a frame of the given type; the length is filled in by send_frame. */
+static void begin_frame(agent *a, unsigned type){
+    a->length = 0;
+    a->count = 0;
+    put_u32(a, 0);
+    put_u8(a, type);
+    if(type == 'O'){
+        put_u8(a, 0);
+        put_u8(a, 0);
+    }
+}
+
+static void send_frame(agent *a){
+    uint32_t n = (uint32_t)(a->length - 4);
+    unsigned char *f = a->frame;
+    f[0] = (unsigned char)n;
+    f[1] = (unsigned char)(n >> 8);
+    f[2] = (unsigned char)(n >> 16);
+    f[3] = (unsigned char)(n >> 24);
+    if(f[4] == 'O'){
+        f[5] = (unsigned char)a->count;
+        f[6] = (unsigned char)(a->count >> 8);
+    }
+    write_all(a, f, a->length);
+    begin_frame(a, 'O');
+}
+
+/*
+ * Waits for the next actions frame. Returns -1, marking the agent as quit,
+ * for a quit, the end of input or a malformed frame.
+ */
+static int receive_actions(agent *a){
+    unsigned char header[4];
+    uint32_t n;
+    if(a->quit || read_all(a, header, 4) != 0){
+        a->quit = 1;
+        return -1;
+    }
+    n = header[0] | header[1] << 8 | header[2] << 16 | (uint32_t)header[3] << 24;
+    if(n < 1 || n > (1u << 24)){
+        a->quit = 1;
+        return -1;
+    }
+    if(n > a->actions_capacity){
+        a->actions = realloc(a->actions, n);
+        if(a->actions == NULL){
+            abort();
+        }
+        a->actions_capacity = n;
+    }
+    if(read_all(a, a->actions, n) != 0 || a->actions[0] != 'A' || n < 3){
+        a->quit = 1;
+        return -1;
+    }
+    a->actions_left = a->actions[1] | a->actions[2] << 8;
+    a->next_action = 3;
+    /* Check the strings fit before any is used. */
+    for(size_t at = 3, i = 0; i < a->actions_left; i++){
+        if(at >= n || at + 1 + a->actions[at] > n){
+            a->actions_left = 0;
+            break;
+        }
+        at += 1 + a->actions[at];
+    }
+    if(a->actions_left == 0){
+        a->quit = 1;
+        return -1;
+    }
+    return 0;
+}
+
+static const char *pop_action(agent *a){
+    size_t n = a->actions[a->next_action];
+    memcpy(a->chosen, a->actions + a->next_action + 1, n);
+    a->chosen[n] = '\0';
+    a->next_action += 1 + n;
+    a->actions_left--;
+    return a->chosen;
+}
+
+static void put_observation(agent *a, unsigned flags, const agent_field *fields, int field_count){
+    put_u32(a, (uint32_t)a->step);
+    a->flags_at = a->length;
+    put_u8(a, flags);
+    put_u8(a, (unsigned)field_count);
+    for(int i = 0; i < field_count; i++){
+        put_string(a, fields[i].name);
+        if(fields[i].text != NULL){
+            put_u8(a, 1);
+            put_string(a, fields[i].text);
+        }else{
+            put_u8(a, 0);
+            put_i64(a, fields[i].value);
+        }
+    }
+    a->count++;
+}
+
+static void put_legal(agent *a, unsigned kind, const char *const *choices, int choice_count, long long min,
+                      long long max){
+    put_u8(a, kind);
+    if(kind == LEGAL_CHOICE){
+        put_u8(a, (unsigned)choice_count);
+        for(int i = 0; i < choice_count; i++){
+            put_string(a, choices[i]);
+        }
+    }else if(kind == LEGAL_RANGE){
+        put_i64(a, min);
+        put_i64(a, max);
+    }
+}
+
+static int parse_int(const char *s, long long min, long long max, long long *out){
+    char *end;
+    long long v;
+    if(*s == '\0'){
+        return 0;
+    }
+    errno = 0;
+    v = strtoll(s, &end, 10);
+    if(*end != '\0' || errno != 0 || v < min || v > max){
+        return 0;
+    }
+    *out = v;
+    return 1;
+}
+
+/*
+ * The decision loop shared by both kinds of decision. The observation is
+ * added to the frame being built; if actions are queued the first one
+ * answers it and is echoed, otherwise the frame is sent and the reply
+ * waited for. Returns the accepted action, or NULL once the agent has quit.
+ */
+static const char *decide(agent *a, const agent_field *fields, int field_count, unsigned kind,
+                          const char *const *choices, int choice_count, long long min, long long max,
+                          long long *number){
+    int shown = 0;  /* the observation has been sent, so the answer needs no echo */
+
+    if(a->quit){
+        return NULL;
+    }
+    put_observation(a, 0, fields, field_count);
+    put_legal(a, kind, choices, choice_count, min, max);
+    for(;;){
+        const char *action;
+        int legal = 0;
+
+        if(a->actions_left == 0){
+            send_frame(a);
+            if(receive_actions(a) != 0){
+                return NULL;
+            }
+            shown = 1;
+        }
+        action = pop_action(a);
+        if(kind == LEGAL_CHOICE){
+            for(int i = 0; i < choice_count && !legal; i++){
+                legal = strcmp(action, choices[i]) == 0;
+            }
+        }else{
+            legal = parse_int(action, min, max, number);
+        }
+        if(legal){
+            if(!shown){
+                a->frame[a->flags_at] |= FLAG_ACTED;
+                put_string(a, action);
+            }
+            a->step++;
+            return action;
+        }
+        /* Not legal: drop the rest of the batch and send this decision (again) as the one waiting. */
+        a->actions_left = 0;
+        if(shown){
+            put_observation(a, FLAG_REJECTED, fields, field_count);
+            put_legal(a, kind, choices, choice_count, min, max);
+        }else{
+            a->frame[a->flags_at] |= FLAG_REJECTED;
+        }
+        shown = 0;
+    }
+}
+
+const char *agent_choose(agent *a, const agent_field *fields, int field_count, const char *const *choices,
+                         int choice_count){
+    return decide(a, fields, field_count, LEGAL_CHOICE, choices, choice_count, 0, 0, NULL);
+}
+
+long long agent_choose_int(agent *a, const agent_field *fields, int field_count, long long min, long long max){
+    long long number = 0;
+    if(decide(a, fields, field_count, LEGAL_RANGE, NULL, 0, min, max, &number) == NULL){
+        return AGENT_QUIT;
+    }
+    return number;
+}
+
+void agent_finish(agent *a, const agent_field *fields, int field_count){
+    if(a->finished){
+        return;
+    }
+    a->finished = 1;
+    put_observation(a, FLAG_DONE, fields, field_count);
+    put_legal(a, LEGAL_NONE, NULL, 0, 0, 0);
+    send_frame(a);
+    close(a->out);
+    if(a->in != a->out){
+        close(a->in);
+    }
+}
+
+void agent_close(agent *a){
+    if(a == NULL){
+        return;
+    }
+    agent_finish(a, NULL, 0);
+    if(open_agent == a){
+        open_agent = NULL;
+    }
+    free(a->frame);
+    free(a->actions);
+    free(a);
+}
+
+unsigned long agent_steps(const agent *a){
+    return a->step;
+}
+
+static void finish_at_exit(void){
+    if(open_agent != NULL){
+        agent_finish(open_agent, NULL, 0);
+    }
+}
+
+/* Listens on the address and returns the first connection. */
+static int accept_one(int domain, const struct sockaddr *address, socklen_t size){
+    int one = 1, listener, connection;
+    listener = socket(domain, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if(listener < 0){
+        return -1;
+    }
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    if(bind(listener, address, size) != 0 || listen(listener, 1) != 0){
+        int err = errno;
+        close(listener);
+        errno = err;
+        return -1;
+    }
+    connection = accept(listener, NULL, NULL);
+    close(listener);
+    if(connection >= 0 && domain == AF_INET){
+        setsockopt(connection, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    return connection;
+}
+
+agent *agent_open(const char *transport, const char *game){
+    agent *a = calloc(1, sizeof(agent));
+    int null_fd;
+    if(a == NULL){
+        return NULL;
+    }
+
+    if(strcmp(transport, "-") == 0){
+        a->in = dup(STDIN_FILENO);
+        a->out = dup(STDOUT_FILENO);
+    }else if(strncmp(transport, "tcp:", 4) == 0){
+        struct sockaddr_in address;
+        memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_port = htons((uint16_t)atoi(transport + 4));
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        fprintf(stderr, "WAITING FOR AN AGENT ON 127.0.0.1:%s\n", transport + 4);
+        a->in = a->out = accept_one(AF_INET, (struct sockaddr *)&address, sizeof(address));
+    }else if(strncmp(transport, "unix:", 5) == 0 && strlen(transport + 5) < sizeof(((struct sockaddr_un *)0)->sun_path)){
+        struct sockaddr_un address;
+        memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        strcpy(address.sun_path, transport + 5);
+        unlink(address.sun_path);
+        fprintf(stderr, "WAITING FOR AN AGENT ON %s\n", address.sun_path);
+        a->in = a->out = accept_one(AF_UNIX, (struct sockaddr *)&address, sizeof(address));
+    }else{
+        free(a);
+        errno = EINVAL;
+        return NULL;
+    }
+    if(a->in < 0 || a->out < 0){
+        int err = errno;
+        free(a);
+        errno = err;
+        return NULL;
+    }
+
+    /* A closed connection should end the game quietly, not with SIGPIPE. */
+    signal(SIGPIPE, SIG_IGN);
+
+    /* The game's own prompts and its console input are not part of the protocol. */
+    fflush(stdout);
+    null_fd = open("/dev/null", O_RDWR);
+    if(null_fd >= 0){
+        dup2(null_fd, STDIN_FILENO);
+        dup2(null_fd, STDOUT_FILENO);
+        close(null_fd);
+    }
+
+    begin_frame(a, 'H');
+    put_u8(a, AGENT_PROTOCOL_VERSION);
+    put_string(a, game);
+    send_frame(a);
+
+    open_agent = a;
+    atexit(finish_at_exit);
+    return a;
+}
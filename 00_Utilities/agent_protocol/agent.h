@@ -0,0 +1,104 @@
+/*
+ * Headless agent protocol shared by the native games.
+ *
+ * A game started with --agent TRANSPORT plays against a program instead of
+ * a person. At every decision the game reports what the player can see
+ * and what the player may do, and the agent answers with the action to
+ * take. The messages are the same for every game; only the field names
+ * and actions differ.
+ *
+ * TRANSPORT is "-" for the game's stdin and stdout, "tcp:PORT" to accept
+ * one connection on 127.0.0.1:PORT, or "unix:PATH" to accept one on a
+ * Unix socket. In agent mode the game's own text goes to /dev/null.
+ *
+ * Every message is a frame: a 4-byte little-endian length, then that many
+ * bytes, the first of which is the frame type. Integers are little-endian;
+ * a string is a 1-byte length and its bytes.
+ *
+ *   game to agent
+ *     'H' hello         u8 version (1), string game
+ *     'O' observations  u16 count, count observations
+ *   agent to game
+ *     'A' actions       u16 count (at least 1), count strings
+ *     'Q' quit          ends the game as if the player walked away
+ *
+ *   observation  u32 step, u8 flags, u8 field count, fields, legal actions,
+ *                then the string action taken if flags has ACTED
+ *   field        string name, u8 type, then i64 value (type 0) or string (type 1)
+ *   legal        u8 kind: 0 none, 1 choice (u8 count, strings), 2 range (i64 min, i64 max)
+ *   flags        1 ACTED, 2 DONE, 4 REJECTED
+ *
+ * An actions frame may carry several actions. The first answers the
+ * decision the agent was last shown, and the rest answer the decisions
+ * that follow, in order, without a round trip each. The next observations
+ * frame then has one ACTED observation for each of those later decisions,
+ * showing the state the action was applied to, followed by the decision
+ * now waiting (or the final DONE observation). An action that is not
+ * legal is not applied: the remaining actions are dropped and the
+ * decision is sent again with REJECTED set. A range action is a decimal
+ * integer; a choice action must match one of the choices exactly.
+ */
+#ifndef AGENT_PROTOCOL_H
+#define AGENT_PROTOCOL_H
+
+#include <limits.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AGENT_PROTOCOL_VERSION 1
+
+/* Returned by agent_choose_int once the agent has quit; agent_choose returns NULL instead. */
+#define AGENT_QUIT LLONG_MIN
+
+typedef struct agent agent;
+
+/* One named value the player can see. text, if not NULL, makes it a string field. */
+typedef struct{
+    const char *name;
+    long long value;
+    const char *text;
+}agent_field;
+
+/*
+ * Connects to the agent, sends the hello frame and silences the game's
+ * output. Returns NULL with errno set on failure.
+ *
+ * If the agent sends 'Q', disconnects or sends a malformed frame, the
+ * decision waiting and every one after it returns AGENT_QUIT (or NULL)
+ * at once. The game should then end as if the player walked away and
+ * call agent_finish, so it can clean up on its normal path.
+ */
+agent *agent_open(const char *transport, const char *game);
+
+/*
+ * Reports a decision among choices and returns the chosen one, which stays
+ * valid until the next call, or NULL if the agent has quit.
+ */
+const char *agent_choose(agent *a, const agent_field *fields, int field_count, const char *const *choices,
+                         int choice_count);
+
+/* Reports a decision for an integer in [min, max] and returns the chosen integer, or AGENT_QUIT. */
+long long agent_choose_int(agent *a, const agent_field *fields, int field_count, long long min, long long max);
+
+/*
+ * Sends the final observation, marked DONE, and closes the connection.
+ * A game that exits without calling it sends a DONE observation with no fields.
+ */
+void agent_finish(agent *a, const agent_field *fields, int field_count);
+
+/*
+ * Finishes the game if agent_finish has not been called, with a DONE
+ * observation that has no fields, and frees the session. a may be NULL.
+ */
+void agent_close(agent *a);
+
+/* Decisions reported so far. */
+unsigned long agent_steps(const agent *a);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
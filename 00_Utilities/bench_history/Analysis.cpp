@@ -0,0 +1,236 @@
+#include "Analysis.hpp"
+#include <algorithm>
+#include <cmath>
+#include <format>
+#include <map>
+#include <string_view>
+#include <utility>
+
+namespace {
+
+double normal_upper_tail(double z) { return 0.5 * std::erfc(z / std::sqrt(2.0)); }
+
+double median(std::vector<double> v) {
+  if (v.empty()) return 0;
+  const std::size_t mid = v.size() / 2;
+  std::ranges::nth_element(v, v.begin() + static_cast<std::ptrdiff_t>(mid));
+  const double upper = v[mid];
+  if (v.size() % 2) return upper;
+  return (*std::max_element(v.begin(), v.begin() + static_cast<std::ptrdiff_t>(mid)) + upper) / 2;
+}
+
+/**
+ * @brief Samples of one run of one benchmark.
+ */
+struct Run {
+  std::string id;
+  std::string commit;
+  std::vector<double> values;
+};
+
+/**
+ * @brief All runs of one benchmark on one machine, in the order they were recorded.
+ */
+struct Series {
+  std::string unit;
+  bool higher_is_better = false;
+  std::vector<Run> runs;
+};
+
+std::string_view to_string(Verdict v) {
+  switch (v) {
+  case Verdict::TooFewSamples: return "TOO FEW SAMPLES";
+  case Verdict::Unchanged: return "UNCHANGED";
+  case Verdict::Slower: return "SLOWER";
+  case Verdict::Faster: return "FASTER";
+  }
+  return "?";
+}
+
+/**
+ * @brief Signed relative change from before to after, positive when worse.
+ */
+double worsening(double before, double after, bool higher_is_better) {
+  if (before == 0) return 0;
+  const double change = (after - before) / std::abs(before);
+  return higher_is_better ? -change : change;
+}
+
+}  // namespace
+
+/**
+ * @brief Mann-Whitney U test of a against b.
+ *
+ * @param a First sample
+ * @param b Second sample
+ * @return z statistic and one-sided p-values; p is 1 if either sample is empty
+ */
+RankTest mann_whitney(std::span<const double> a, std::span<const double> b) {
+  RankTest result;
+  const std::size_t n = a.size() + b.size();
+  if (a.empty() || b.empty()) return result;
+
+  std::vector<std::pair<double, bool>> all;  // value, from a
+  all.reserve(n);
+  for (double x : a) all.emplace_back(x, true);
+  for (double x : b) all.emplace_back(x, false);
+  std::ranges::sort(all, {}, &std::pair<double, bool>::first);
+
+  double rank_sum_a = 0, tie_term = 0;
+  for (std::size_t i = 0; i < n;) {
+    std::size_t j = i;
+    while (j < n && all[j].first == all[i].first) ++j;
+    const double rank = (static_cast<double>(i + j) + 1) / 2;  // average of ranks i+1..j
+    for (std::size_t k = i; k < j; ++k) rank_sum_a += all[k].second ? rank : 0;
+    const double t = static_cast<double>(j - i);
+    tie_term += t * t * t - t;
+    i = j;
+  }
+
+  const double na = static_cast<double>(a.size()), nb = static_cast<double>(b.size()), nn = static_cast<double>(n);
+  const double u = rank_sum_a - na * (na + 1) / 2;
+  const double mean = na * nb / 2;
+  const double variance = na * nb / 12 * ((nn + 1) - (n > 1 ? tie_term / (nn * (nn - 1)) : 0));
+  if (variance <= 0) return result;
+  const double sd = std::sqrt(variance);
+  result.z = (u - mean) / sd;
+  result.p_larger = normal_upper_tail((u - mean - 0.5) / sd);
+  result.p_smaller = normal_upper_tail((mean - u - 0.5) / sd);
+  return result;
+}
+
+/**
+ * @brief Pettitt's change-point test.
+ *
+ * U(t) sums sign(x_i - x_j) over every i before t and j from t on, built
+ * up one position at a time; the split with the largest |U(t)| is the
+ * likeliest change, with p approximately 2 exp(-6K^2 / (T^3 + T^2)).
+ *
+ * @param values Values in time order
+ * @param splits Allowed split positions
+ * @return The best split and its p-value; p is 1 if there are no splits
+ */
+ChangePoint pettitt(std::span<const double> values, std::span<const std::size_t> splits) {
+  ChangePoint best;
+  const std::size_t n = values.size();
+  if (n < 2 || splits.empty()) return best;
+
+  std::vector<double> u(n, 0);  // u[t]: statistic for a split before position t
+  double running = 0;
+  for (std::size_t t = 1; t < n; ++t) {
+    double row = 0;
+    for (std::size_t j = 0; j < n; ++j) {
+      row += (values[t - 1] > values[j]) - (values[t - 1] < values[j]);
+    }
+    running += row;
+    u[t] = running;
+  }
+  double k = -1;
+  for (std::size_t s : splits) {
+    if (s == 0 || s >= n || std::abs(u[s]) <= k) continue;
+    k = std::abs(u[s]);
+    best.split = s;
+  }
+  const double t = static_cast<double>(n);
+  best.p = std::min(1.0, 2 * std::exp(-6 * k * k / (t * t * t + t * t)));
+  return best;
+}
+
+/**
+ * @brief Analyzes every benchmark series in the history and writes the text report.
+ *
+ * @param records The whole history
+ * @param options Thresholds and window sizes
+ * @param report Receives the report
+ * @return One finding per benchmark and machine, in report order
+ */
+std::vector<Finding> analyze(const std::vector<Record>& records, const AnalysisOptions& options, std::string& report) {
+  std::map<std::pair<std::string, std::string>, Series> series;  // (machine, benchmark)
+  for (const Record& r : records) {
+    Series& s = series[{r.machine, r.benchmark}];
+    s.unit = r.unit;
+    s.higher_is_better = r.higher_is_better;
+    if (s.runs.empty() || s.runs.back().id != r.run) {
+      // Runs are appended whole, but concurrent runs may interleave.
+      auto earlier = std::ranges::find(s.runs, r.run, &Run::id);
+      if (earlier == s.runs.end()) {
+        s.runs.push_back(Run{r.run, r.commit, {}});
+        earlier = s.runs.end() - 1;
+      }
+      earlier->values.push_back(r.value);
+    } else {
+      s.runs.back().values.push_back(r.value);
+    }
+  }
+
+  std::vector<Finding> findings;
+  std::string machine;
+  report += std::format("BENCHMARK HISTORY: {} RECORDS, {} SERIES\n", records.size(), series.size());
+  for (const auto& [key, s] : series) {
+    if (key.first != machine) {
+      machine = key.first;
+      report += std::format("\nMACHINE {}\n", machine);
+    }
+    Finding finding{key.first, key.second, Verdict::TooFewSamples};
+    report += std::format("\n  {} ({}, {} IS BETTER)\n", key.second, s.unit.empty() ? "NO UNIT" : s.unit,
+                          s.higher_is_better ? "HIGHER" : "LOWER");
+
+    const Run& latest = s.runs.back();
+    std::vector<double> baseline;
+    const std::size_t first = s.runs.size() - 1 > options.baseline_runs ? s.runs.size() - 1 - options.baseline_runs : 0;
+    for (std::size_t i = first; i + 1 < s.runs.size(); ++i) {
+      baseline.insert(baseline.end(), s.runs[i].values.begin(), s.runs[i].values.end());
+    }
+    if (latest.values.size() >= 3 && baseline.size() >= 3) {
+      const RankTest test = mann_whitney(latest.values, baseline);
+      const double before = median(baseline), after = median(latest.values);
+      const double worse = worsening(before, after, s.higher_is_better);
+      const double p_worse = s.higher_is_better ? test.p_smaller : test.p_larger;
+      const double p_better = s.higher_is_better ? test.p_larger : test.p_smaller;
+      finding.verdict = p_worse < options.alpha && worse >= options.min_effect     ? Verdict::Slower
+                        : p_better < options.alpha && -worse >= options.min_effect ? Verdict::Faster
+                                                                                   : Verdict::Unchanged;
+      report += std::format("    LATEST {} ({} SAMPLES) MEDIAN {:.6g}  BASELINE {} RUNS ({} SAMPLES) MEDIAN {:.6g}\n",
+                            latest.commit, latest.values.size(), after, s.runs.size() - 1 - first, baseline.size(),
+                            before);
+      report += std::format("    CHANGE {:+.2f}% {}  P {:.4f}  {}\n", 100 * (after - before) / std::abs(before),
+                            worse > 0 ? "WORSE" : "BETTER", std::min(p_worse, p_better), to_string(finding.verdict));
+    } else {
+      report += std::format("    LATEST {} ({} SAMPLES), BASELINE {} SAMPLES: {}\n", latest.commit,
+                            latest.values.size(), baseline.size(), to_string(finding.verdict));
+    }
+
+    report += "    TREND ";
+    for (std::size_t i = s.runs.size() > options.trend_runs ? s.runs.size() - options.trend_runs : 0;
+         i < s.runs.size(); ++i) {
+      report += std::format(" {:.4g}", median(s.runs[i].values));
+    }
+    report += std::format("  (MEDIAN OF EACH OF THE LAST {} RUNS)\n", std::min(s.runs.size(), options.trend_runs));
+
+    std::vector<double> all;
+    std::vector<std::size_t> splits;
+    for (const Run& run : s.runs) {
+      if (!all.empty()) splits.push_back(all.size());
+      all.insert(all.end(), run.values.begin(), run.values.end());
+    }
+    const ChangePoint shift = pettitt(all, splits);
+    if (shift.p < options.alpha) {
+      const auto at = static_cast<std::size_t>(std::ranges::find(splits, shift.split) - splits.begin()) + 1;
+      const auto split = all.begin() + static_cast<std::ptrdiff_t>(shift.split);
+      const double before = median(std::vector<double>(all.begin(), split));
+      const double after = median(std::vector<double>(split, all.end()));
+      report += std::format("    SHIFT AT RUN {} OF {} ({}): {:.6g} -> {:.6g} ({:+.2f}%)  P {:.4f}\n", at + 1,
+                            s.runs.size(), s.runs[at].commit, before, after, 100 * (after - before) / std::abs(before),
+                            shift.p);
+    } else {
+      report += "    NO SHIFT IN LEVEL\n";
+    }
+    findings.push_back(std::move(finding));
+  }
+
+  std::size_t counts[4] = {};
+  for (const Finding& f : findings) ++counts[static_cast<int>(f.verdict)];
+  report += std::format("\nSLOWER: {}  FASTER: {}  UNCHANGED: {}  TOO FEW SAMPLES: {}\n", counts[2], counts[3],
+                        counts[1], counts[0]);
+  return findings;
+}
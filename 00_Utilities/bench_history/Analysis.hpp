@@ -0,0 +1,72 @@
+#pragma once
+
+#include "History.hpp"
+#include <cstddef>
+#include <span>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Result of a Mann-Whitney U test of sample a against sample b.
+ */
+struct RankTest {
+  double z = 0;        ///< Positive when values in a tend to be larger than in b
+  double p_larger = 1; ///< One-sided p-value for "a tends to be larger"
+  double p_smaller = 1;
+};
+
+/**
+ * @brief Mann-Whitney U test with the normal approximation, corrected for ties and continuity.
+ *
+ * Compares ranks rather than means, so one wild sample cannot produce or
+ * hide a difference on its own.
+ */
+RankTest mann_whitney(std::span<const double> a, std::span<const double> b);
+
+/**
+ * @brief A single shift in level found by Pettitt's test.
+ */
+struct ChangePoint {
+  std::size_t split = 0;  ///< Number of values before the shift
+  double p = 1;           ///< Approximate p-value of a shift at all
+};
+
+/**
+ * @brief Pettitt's rank-based test for one change in level, with splits allowed only at the given positions.
+ *
+ * @param values Values in time order
+ * @param splits Candidate split positions, each in 1..values.size()-1
+ */
+ChangePoint pettitt(std::span<const double> values, std::span<const std::size_t> splits);
+
+struct AnalysisOptions {
+  double alpha = 0.01;      ///< Significance level
+  double min_effect = 0.02; ///< Smallest relative change of medians worth flagging
+  std::size_t baseline_runs = 5;
+  std::size_t trend_runs = 12;
+};
+
+enum class Verdict { TooFewSamples, Unchanged, Slower, Faster };
+
+/**
+ * @brief What the analysis found for one benchmark on one machine.
+ */
+struct Finding {
+  std::string machine;
+  std::string benchmark;
+  Verdict verdict = Verdict::TooFewSamples;
+};
+
+/**
+ * @brief Compares each benchmark's latest run with the runs before it and looks for shifts over its whole history.
+ *
+ * For every benchmark on every machine, the latest run's samples are
+ * tested against the pooled samples of the previous baseline_runs runs;
+ * a benchmark is Slower if the test is significant at alpha in the worse
+ * direction and the medians differ by at least min_effect. Separately,
+ * Pettitt's test over all samples reports where in the history the level
+ * shifted, if anywhere. The text report goes to `report`.
+ *
+ * @return One finding per benchmark and machine
+ */
+std::vector<Finding> analyze(const std::vector<Record>& records, const AnalysisOptions& options, std::string& report);
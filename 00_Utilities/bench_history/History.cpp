@@ -0,0 +1,219 @@
+#include "History.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <charconv>
+#include <cstdio>
+#include <cstdlib>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <print>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <fcntl.h>
+#include <sys/utsname.h>
+#include <unistd.h>
+#if defined(__APPLE__)
+#include <sys/sysctl.h>
+#endif
+
+namespace {
+
+constexpr std::string_view HEADER = "# time\trun\tcommit\tmachine\tbenchmark\tvalue\tunit\tbetter\n";
+
+void check_field(std::string_view field) {
+  if (field.empty() || field.find_first_of("\t\n") != std::string_view::npos) {
+    throw std::invalid_argument("field must be non-empty and free of tabs and newlines: \"" + std::string(field) + "\"");
+  }
+}
+
+/**
+ * @brief Splits a line at tabs.
+ */
+std::vector<std::string_view> split(std::string_view line) {
+  std::vector<std::string_view> fields;
+  for (std::size_t start = 0;;) {
+    const std::size_t tab = line.find('\t', start);
+    fields.push_back(line.substr(start, tab - start));
+    if (tab == std::string_view::npos) return fields;
+    start = tab + 1;
+  }
+}
+
+/**
+ * @brief Output of a shell command with trailing whitespace removed, or "" if it failed.
+ */
+std::string command_output(const char* command) {
+  std::unique_ptr<FILE, int (*)(FILE*)> pipe(::popen(command, "r"), ::pclose);
+  if (!pipe) return "";
+  std::string out;
+  char buffer[256];
+  while (std::fgets(buffer, sizeof(buffer), pipe.get())) out += buffer;
+  while (!out.empty() && std::isspace(static_cast<unsigned char>(out.back()))) out.pop_back();
+  return out;
+}
+
+#if defined(__APPLE__)
+/**
+ * @brief The CPU's marketing name, e.g. "Apple M2 Pro", or "" if unknown.
+ */
+std::string cpu_model() {
+  char brand[256] = {};
+  std::size_t size = sizeof(brand) - 1;
+  if (::sysctlbyname("machdep.cpu.brand_string", brand, &size, nullptr, 0) != 0) return "";
+  return brand;
+}
+
+/**
+ * @brief Installed memory in bytes, or 0 if unknown.
+ */
+unsigned long long memory_bytes() {
+  std::uint64_t bytes = 0;
+  std::size_t size = sizeof(bytes);
+  return ::sysctlbyname("hw.memsize", &bytes, &size, nullptr, 0) == 0 ? bytes : 0;
+}
+#else
+/**
+ * @brief Text after "key" and the colon on the first matching line of a /proc file.
+ */
+std::string proc_field(const char* file, std::string_view key) {
+  std::ifstream in(file);
+  for (std::string line; std::getline(in, line);) {
+    if (!line.starts_with(key)) continue;
+    std::string_view value(line);
+    value.remove_prefix(std::min(value.find(':') + 1, value.size()));
+    while (!value.empty() && std::isspace(static_cast<unsigned char>(value.front()))) value.remove_prefix(1);
+    return std::string(value);
+  }
+  return "";
+}
+
+std::string cpu_model() {
+  return proc_field("/proc/cpuinfo", "model name");
+}
+
+unsigned long long memory_bytes() {
+  return std::strtoull(proc_field("/proc/meminfo", "MemTotal").c_str(), nullptr, 10) * 1024;  // in kB
+}
+#endif
+
+}  // namespace
+
+History::History(const std::filesystem::path& path) {
+  fd = ::open(path.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+  if (fd < 0) throw std::system_error(errno, std::generic_category(), path.string());
+  if (::lseek(fd, 0, SEEK_END) == 0 && ::write(fd, HEADER.data(), HEADER.size()) != static_cast<ssize_t>(HEADER.size())) {
+    const int err = errno;
+    ::close(fd);
+    throw std::system_error(err, std::generic_category(), path.string());
+  }
+}
+
+History::~History() {
+  if (fd >= 0) ::close(fd);
+}
+
+/**
+ * @brief Appends one record as a single line.
+ *
+ * @param r The record
+ */
+void History::append(const Record& r) {
+  for (std::string_view field : {r.run, r.commit, r.machine, r.benchmark}) check_field(field);
+  if (r.unit.find_first_of("\t\n") != std::string::npos) check_field(r.unit);
+  const std::string line = std::format("{}\t{}\t{}\t{}\t{}\t{}\t{}\t{}\n", r.time, r.run, r.commit, r.machine,
+                                       r.benchmark, r.value, r.unit, r.higher_is_better ? "higher" : "lower");
+  if (::write(fd, line.data(), line.size()) != static_cast<ssize_t>(line.size())) {
+    throw std::system_error(errno, std::generic_category(), "append to benchmark history");
+  }
+}
+
+void History::sync() {
+  if (::fsync(fd) != 0) throw std::system_error(errno, std::generic_category(), "fsync benchmark history");
+}
+
+/**
+ * @brief Reads every complete record in the store.
+ *
+ * @param path The store
+ * @return Records in the order they were appended
+ */
+std::vector<Record> History::load(const std::filesystem::path& path) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) throw std::system_error(errno, std::generic_category(), path.string());
+  std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  // A line without its newline was cut short by a crash mid-append.
+  text.resize(text.rfind('\n') == std::string::npos ? 0 : text.rfind('\n') + 1);
+
+  std::vector<Record> records;
+  std::size_t number = 0;
+  for (std::size_t start = 0; start < text.size();) {
+    const std::size_t end = text.find('\n', start);
+    const std::string_view line(text.data() + start, end - start);
+    start = end + 1;
+    ++number;
+    if (line.empty() || line.front() == '#') continue;
+
+    const std::vector<std::string_view> f = split(line);
+    Record r;
+    auto parsed_time = [&r](std::string_view s) {
+      const auto [ptr, ec] = std::from_chars(s.data(), s.data() + s.size(), r.time);
+      return ec == std::errc() && ptr == s.data() + s.size();
+    };
+    // strtod, not from_chars: libc++ 18 has no floating-point from_chars.
+    auto parsed_value = [&r](std::string_view s) {
+      const std::string text(s);
+      char* end = nullptr;
+      errno = 0;
+      r.value = std::strtod(text.c_str(), &end);
+      return !text.empty() && errno == 0 && end == text.c_str() + text.size();
+    };
+    if (f.size() != 8 || !parsed_time(f[0]) || !parsed_value(f[5]) || (f[7] != "higher" && f[7] != "lower")) {
+      std::println(stderr, "Warning: {}:{}: skipping malformed record", path.string(), number);
+      continue;
+    }
+    r.run = f[1];
+    r.commit = f[2];
+    r.machine = f[3];
+    r.benchmark = f[4];
+    r.unit = f[6];
+    r.higher_is_better = f[7] == "higher";
+    records.push_back(std::move(r));
+  }
+  return records;
+}
+
+/**
+ * @brief Describes this machine, with spaces replaced so it fits one field.
+ *
+ * @return e.g. "x86_64/Intel(R)_Xeon(R)_CPU_@_2.20GHz/8cpu/31GB/linux-6.8.0"
+ */
+std::string machine_fingerprint() {
+  utsname u{};
+  ::uname(&u);
+  std::string cpu = cpu_model();
+  if (cpu.empty()) cpu = "unknown-cpu";
+  const unsigned long long gb = (memory_bytes() + (1ULL << 29)) >> 30;
+
+  std::string fingerprint = std::format("{}/{}/{}cpu/{}GB/{}-{}", u.machine, cpu, std::thread::hardware_concurrency(),
+                                        gb, u.sysname, u.release);
+  std::ranges::transform(fingerprint, fingerprint.begin(), [](unsigned char c) {
+    return std::isspace(c) ? '_' : static_cast<char>(std::tolower(c));
+  });
+  return fingerprint;
+}
+
+/**
+ * @brief The checked-out commit as a short hash.
+ *
+ * @return The hash, with "-dirty" if tracked files have changes, or "unknown"
+ */
+std::string current_commit() {
+  std::string commit = command_output("git rev-parse --short=12 HEAD 2>/dev/null");
+  if (commit.empty()) return "unknown";
+  if (!command_output("git status --porcelain --untracked-files=no 2>/dev/null").empty()) commit += "-dirty";
+  return commit;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+/**
+ * @brief One measured value from one benchmark run.
+ *
+ * A run is one invocation of `bench_history record` or `add`, and usually
+ * holds several samples of each benchmark; the samples of a run share its
+ * id, time, commit and machine.
+ */
+struct Record {
+  std::int64_t time = 0;  ///< Unix seconds when the run started
+  std::string run;        ///< Run id, unique per run
+  std::string commit;     ///< git commit, with "-dirty" if the tree had changes
+  std::string machine;    ///< Machine fingerprint, see machine_fingerprint()
+  std::string benchmark;  ///< e.g. "TraceBench/PLAY"
+  double value = 0;
+  std::string unit;
+  bool higher_is_better = false;
+};
+
+/**
+ * @brief Append-only store of benchmark results.
+ *
+ * One tab-separated line per record. Each line goes to the file in a
+ * single O_APPEND write, so concurrent runs interleave whole lines, and a
+ * line cut short by a crash is ignored when the file is read back.
+ */
+class History {
+public:
+  /**
+   * @brief Opens the store for appending, creating it if needed.
+   *
+   * @throws std::system_error if the file cannot be opened
+   */
+  explicit History(const std::filesystem::path& path);
+  ~History();
+
+  History(const History&) = delete;
+  History& operator=(const History&) = delete;
+
+  /**
+   * @brief Appends one record.
+   *
+   * @throws std::invalid_argument if a text field holds a tab or newline
+   * @throws std::system_error if the write fails
+   */
+  void append(const Record& r);
+
+  /**
+   * @brief Makes everything appended so far durable.
+   */
+  void sync();
+
+  /**
+   * @brief Reads every complete record in the store, in the order appended.
+   *
+   * A malformed line, such as one torn by a crash and followed by later
+   * appends, is skipped with a warning on stderr.
+   *
+   * @throws std::system_error if the file cannot be read
+   */
+  static std::vector<Record> load(const std::filesystem::path& path);
+
+private:
+  int fd = -1;
+};
+
+/**
+ * @brief Describes this machine: architecture, CPU model, CPU count, memory and kernel.
+ *
+ * Results are only compared between runs with the same fingerprint.
+ */
+std::string machine_fingerprint();
+
+/**
+ * @brief The checked-out git commit, or "unknown" outside a work tree.
+ */
+std::string current_commit();
@@ -0,0 +1,235 @@
+#include "Analysis.hpp"
+#include "History.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <format>
+#include <fstream>
+#include <optional>
+#include <print>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr std::string_view USAGE =
+  "Usage: bench_history record --store FILE --name NAME [--samples N] [--metric LABEL]... [--higher LABEL]... -- COMMAND...\n"
+  "       bench_history add --store FILE --name NAME [--unit UNIT] [--higher-is-better yes] --values V,V,...\n"
+  "       bench_history analyze --store FILE [--report FILE] [--alpha P] [--min-effect F] [--baseline-runs N]";
+
+struct Metric {
+  std::string label;
+  bool higher_is_better = false;
+};
+
+/**
+ * @brief Runs a command with its output captured.
+ *
+ * @return The command's standard output
+ * @throws std::runtime_error if it cannot be started or does not exit with status 0
+ */
+std::string run_command(const std::vector<char*>& argv) {
+  int out[2];
+  if (::pipe(out) != 0) throw std::system_error(errno, std::generic_category(), "pipe");
+  const pid_t pid = ::fork();
+  if (pid < 0) throw std::system_error(errno, std::generic_category(), "fork");
+  if (pid == 0) {
+    ::dup2(out[1], STDOUT_FILENO);
+    ::close(out[0]);
+    ::close(out[1]);
+    ::execvp(argv[0], argv.data());
+    _exit(127);
+  }
+  ::close(out[1]);
+  std::string output;
+  char buffer[4096];
+  for (ssize_t n; (n = ::read(out[0], buffer, sizeof(buffer))) != 0;) {
+    if (n < 0 && errno == EINTR) continue;
+    if (n < 0) break;
+    output.append(buffer, static_cast<std::size_t>(n));
+  }
+  ::close(out[0]);
+  int status = 0;
+  while (::waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+  }
+  if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+    throw std::runtime_error(std::format("{} failed with status {}", argv[0], status));
+  }
+  return output;
+}
+
+/**
+ * @brief Finds "LABEL: number unit" in a benchmark's output, the way the benchmarks print results.
+ *
+ * The unit is what follows the number up to the next double space or line end.
+ *
+ * @return The number and unit
+ * @throws std::runtime_error if the label is missing or not followed by a number
+ */
+std::pair<double, std::string> find_metric(std::string_view output, std::string_view label) {
+  const std::string key = std::string(label) + ":";
+  for (std::size_t at = output.find(key); at != std::string_view::npos; at = output.find(key, at + 1)) {
+    if (at > 0 && output[at - 1] != ' ' && output[at - 1] != '\n') continue;
+    const std::string rest(output.substr(at + key.size(), 64));
+    char* end = nullptr;
+    const double value = std::strtod(rest.c_str(), &end);
+    if (end == rest.c_str()) continue;
+    std::string_view unit(end);
+    while (unit.starts_with(' ')) unit.remove_prefix(1);
+    unit = unit.substr(0, std::min(unit.find("  "), unit.find('\n')));
+    return {value, std::string(unit)};
+  }
+  throw std::runtime_error(std::format("no \"{}\" followed by a number in the benchmark output", key));
+}
+
+/**
+ * @brief A run id: start time in nanoseconds and the process id, so concurrent runs differ.
+ */
+std::string new_run_id() {
+  const auto ns = std::chrono::system_clock::now().time_since_epoch() / std::chrono::nanoseconds(1);
+  return std::format("{:x}-{}", ns, ::getpid());
+}
+
+}  // namespace
+
+/**
+ * @brief Entry point for the benchmark history tool.
+ *
+ * `record` runs a benchmark command --samples times and appends, for each
+ * sample, its wall time as NAME/WALL and every --metric LABEL found in its
+ * output as NAME/LABEL, tagged with the commit and machine. `add` appends
+ * values measured elsewhere. `analyze` reads the whole store, prints the
+ * per-benchmark trend report (also to --report), and exits with failure if
+ * any benchmark is significantly slower than its recent history.
+ */
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    std::println(stderr, "{}", USAGE);
+    return EXIT_FAILURE;
+  }
+  const std::string_view command = argv[1];
+  std::optional<std::string> store, name, report_path, values;
+  std::string unit;
+  bool higher_is_better = false;
+  std::size_t samples = 5;
+  std::vector<Metric> metrics;
+  AnalysisOptions options;
+  std::vector<char*> benchmark;
+
+  try {
+    int i = 2;
+    for (; i < argc && std::string_view(argv[i]) != "--"; i += 2) {
+      const std::string_view flag = argv[i];
+      if (i + 1 >= argc) throw std::invalid_argument("missing value");
+      const char* value = argv[i + 1];
+      if (flag == "--store") {
+        store = value;
+      } else if (flag == "--name") {
+        name = value;
+      } else if (flag == "--samples") {
+        samples = std::stoull(value);
+      } else if (flag == "--metric") {
+        metrics.push_back(Metric{value, false});
+      } else if (flag == "--higher") {
+        metrics.push_back(Metric{value, true});
+      } else if (flag == "--unit") {
+        unit = value;
+      } else if (flag == "--higher-is-better") {
+        higher_is_better = std::string_view(value) == "yes";
+      } else if (flag == "--values") {
+        values = value;
+      } else if (flag == "--report") {
+        report_path = value;
+      } else if (flag == "--alpha") {
+        options.alpha = std::stod(value);
+      } else if (flag == "--min-effect") {
+        options.min_effect = std::stod(value);
+      } else if (flag == "--baseline-runs") {
+        options.baseline_runs = std::stoull(value);
+      } else {
+        throw std::invalid_argument("unknown flag");
+      }
+    }
+    for (++i; i < argc; ++i) benchmark.push_back(argv[i]);
+    benchmark.push_back(nullptr);
+    const bool ok = store && (command == "analyze" || (name && (command == "add" ? values.has_value()
+                                                                 : command == "record" && benchmark.size() > 1)));
+    if (!ok) throw std::invalid_argument("missing argument");
+  } catch (const std::exception&) {
+    std::println(stderr, "{}", USAGE);
+    return EXIT_FAILURE;
+  }
+
+  try {
+    if (command == "analyze") {
+      std::string report;
+      const std::vector<Finding> findings = analyze(History::load(*store), options, report);
+      std::print("{}", report);
+      if (report_path) {
+        std::ofstream out(*report_path);
+        out << report;
+        if (!out) throw std::system_error(errno, std::generic_category(), *report_path);
+      }
+      for (const Finding& f : findings) {
+        if (f.verdict == Verdict::Slower) return EXIT_FAILURE;
+      }
+      return EXIT_SUCCESS;
+    }
+
+    Record r;
+    r.time = static_cast<std::int64_t>(std::time(nullptr));
+    r.run = new_run_id();
+    r.commit = current_commit();
+    r.machine = machine_fingerprint();
+    History history(*store);
+
+    if (command == "add") {
+      r.benchmark = *name;
+      r.unit = unit;
+      r.higher_is_better = higher_is_better;
+      std::size_t added = 0;
+      for (std::size_t start = 0; start <= values->size();) {
+        const std::size_t comma = std::min(values->find(',', start), values->size());
+        r.value = std::stod(values->substr(start, comma - start));
+        history.append(r);
+        ++added;
+        start = comma + 1;
+      }
+      history.sync();
+      std::println("ADDED {} SAMPLES OF {} AT {} ON {}", added, *name, r.commit, r.machine);
+      return EXIT_SUCCESS;
+    }
+
+    std::println("RECORDING {} AT {} ON {}", *name, r.commit, r.machine);
+    for (std::size_t sample = 1; sample <= samples; ++sample) {
+      const auto start = std::chrono::steady_clock::now();
+      const std::string output = run_command(benchmark);
+      const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+      std::string line = std::format("SAMPLE {}/{}: WALL {:.4g} S", sample, samples, wall);
+      r.benchmark = *name + "/WALL";
+      r.value = wall;
+      r.unit = "S";
+      r.higher_is_better = false;
+      history.append(r);
+      for (const Metric& m : metrics) {
+        const auto [value, metric_unit] = find_metric(output, m.label);
+        r.benchmark = *name + "/" + m.label;
+        r.value = value;
+        r.unit = metric_unit;
+        r.higher_is_better = m.higher_is_better;
+        history.append(r);
+        line += std::format("  {} {:.6g} {}", m.label, value, metric_unit);
+      }
+      std::println("{}", line);
+    }
+    history.sync();
+  } catch (const std::exception& e) {
+    std::println(stderr, "Error: {}", e.what());
+    return EXIT_FAILURE;
+  }
+}
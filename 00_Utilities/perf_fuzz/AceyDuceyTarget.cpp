@@ -0,0 +1,18 @@
+#include "PerfFuzz.hpp"
+#include "AceyDucey.hpp"
+
+/**
+ * @brief Performance fuzzer for the C++ Acey Ducey.
+ *
+ * Plays the classic rules with a fixed deck seed. A bet that is all
+ * digits but too long for an int makes std::stoi throw.
+ */
+int main(int argc, char* argv[]) {
+  return perf_fuzz::main(argc, argv,
+                         perf_fuzz::Target{
+                           .name = "aceyducey",
+                           .run = [] { run_game(acey_ducey::Variant{}); },
+                           .seeds = {"10\n20\n0\n50\n5\nYES\n", "100\nNO\n", "abc\n-5\n1000\n0\n0\n"},
+                           .tokens = {"0\n", "1\n", "100\n", "YES\n", "NO\n", "99999999999\n", " \n"},
+                         });
+}
@@ -0,0 +1,26 @@
+#include "PerfFuzz.hpp"
+
+extern "C" int fuzz_target_main(int argc, char* argv[]);  // main() of 30_Cube/C/cube.c, renamed by the build
+
+/**
+ * @brief Performance fuzzer for the C port of Cube.
+ *
+ * Losing a round calls game() again from inside the round, so the stack
+ * grows with every round played; a negative wager keeps the account
+ * from ever running out.
+ */
+int main(int argc, char* argv[]) {
+  return perf_fuzz::main(argc, argv,
+                         perf_fuzz::Target{
+                           .name = "cube",
+                           .run = [] {
+                             char name[] = "cube";
+                             char* args[] = {name, nullptr};
+                             fuzz_target_main(1, args);
+                           },
+                           .seeds = {"n\n100\n1,1,2\n1,1,3\n1,2,3\n1,3,3\n2,3,3\n3,3,3\n",
+                                     "y\n500\n2,1,1\n3,1,1\n3,2,1\n3,3,1\n3,3,2\n3,3,3\n",
+                                     "n\n-1000\n3,3,3\n"},
+                           .tokens = {"y\n", "n\n", "1,1,2\n", "2,1,1\n", "3,3,3\n", "-100000\n", "0\n", ","},
+                         });
+}
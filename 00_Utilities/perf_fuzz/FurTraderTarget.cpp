@@ -0,0 +1,24 @@
+#include "PerfFuzz.hpp"
+
+extern "C" int fuzz_target_main(int argc, char* argv[]);  // main() of 38_Fur_Trader/c/furtrader.c, renamed by the build
+
+/**
+ * @brief Performance fuzzer for the C port of Fur Trader.
+ *
+ * Every prompt repeats until it gets an answer it accepts, so input that
+ * is never accepted keeps the game printing prompts.
+ */
+int main(int argc, char* argv[]) {
+  return perf_fuzz::main(argc, argv,
+                         perf_fuzz::Target{
+                           .name = "furtrader",
+                           .run = [] {
+                             char name[] = "furtrader";
+                             char* args[] = {name, nullptr};
+                             fuzz_target_main(1, args);
+                           },
+                           .seeds = {"YES\n1\nYES\n10\n10\n10\n10\nYES\n2\nYES\n50\n50\n50\n50\nNO\n",
+                                     "YES\n3\nYES\n100\n0\n0\n0\nYES\n3\nNO\nYES\n0\n0\n0\n0\nNO\n"},
+                           .tokens = {"YES\n", "NO\n", "1\n", "2\n", "3\n", "190\n", "-1\n", "X\n"},
+                         });
+}
@@ -0,0 +1,25 @@
+#include "PerfFuzz.hpp"
+
+extern "C" int fuzz_target_main(int argc, char* argv[]);  // main() of 44_Hangman/C/main.c, renamed by the build
+
+/**
+ * @brief Performance fuzzer for the C port of Hangman.
+ *
+ * Runs in the game's own directory, where it reads dictionary.txt. With
+ * the fixed seed the word is always "piece". Guesses are read with
+ * scanf("%s") into a 100-byte buffer, so long guesses overrun it.
+ */
+int main(int argc, char* argv[]) {
+  return perf_fuzz::main(argc, argv,
+                         perf_fuzz::Target{
+                           .name = "hangman",
+                           .run = [] {
+                             char name[] = "hangman";
+                             char* args[] = {name, nullptr};
+                             fuzz_target_main(1, args);
+                           },
+                           .seeds = {"p\ni\ne\nc\n", "a\nb\nd\nf\ng\nh\n", "piece\n", "e\ne\ne\ne\ne\ne\n"},
+                           .tokens = {"e\n", "p\n", "z\n", "piece\n", "\n", " "},
+                           .directory = HANGMAN_DIRECTORY,
+                         });
+}
@@ -0,0 +1,733 @@
+#include "PerfFuzz.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <print>
+#include <random>
+#include <sstream>
+#include <streambuf>
+#include <string_view>
+#include <system_error>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#endif
+
+namespace perf_fuzz {
+
+namespace {
+
+constexpr std::size_t MAP_SIZE = 1 << 16;  ///< Edge counters, indexed by a hash of (previous block, block)
+
+/**
+ * @brief What a run leaves behind for the fuzzer: shared between the fuzzer and the forked child.
+ */
+struct Shared {
+  std::uint64_t blocks;
+  std::uint64_t budget;
+  std::uint64_t instructions;
+  std::uint64_t start_rss_kb;
+  std::uint64_t peak_rss_kb;  ///< 0 if the run did not get to record it
+  Status status;
+  bool recorded;
+  std::uint32_t hits[MAP_SIZE];
+};
+
+Shared* shared = nullptr;
+bool in_child = false;
+std::uintptr_t previous_block = 0;
+std::string_view input;
+std::size_t position = 0;
+FILE* input_stream = nullptr;
+int counter_fd = -1;
+
+/**
+ * @brief getrusage's ru_maxrss in kB: Linux reports kB, macOS bytes.
+ */
+std::uint64_t maxrss_kb(long maxrss) {
+#ifdef __APPLE__
+  return static_cast<std::uint64_t>(maxrss) / 1024;
+#else
+  return static_cast<std::uint64_t>(maxrss);
+#endif
+}
+
+#ifdef __linux__
+/**
+ * @brief A "Vm...:" figure from /proc/self/status, in kB; 0 if it cannot be read.
+ *
+ * Uses only system calls, as it runs in the child's exit path.
+ */
+std::uint64_t status_kb(std::string_view field) {
+  char text[4096];
+  const int fd = ::open("/proc/self/status", O_RDONLY);
+  if (fd < 0) return 0;
+  const ssize_t n = ::read(fd, text, sizeof(text) - 1);
+  ::close(fd);
+  if (n <= 0) return 0;
+  const std::string_view status(text, static_cast<std::size_t>(n));
+  const std::size_t at = status.find(field);
+  return at == std::string_view::npos ? 0 : std::strtoull(text + at + field.size(), nullptr, 10);
+}
+
+std::uint64_t resident_kb() { return status_kb("VmRSS:"); }
+std::uint64_t peak_resident_kb() { return status_kb("VmHWM:"); }
+
+/**
+ * @brief Resets the high-water mark the fork inherited, so the peak counts from here.
+ */
+void reset_peak_resident() {
+  if (std::FILE* clear = std::fopen("/proc/self/clear_refs", "w")) {
+    std::fputs("5", clear);
+    std::fclose(clear);
+  }
+}
+#else
+/**
+ * @brief Without /proc the only figure is getrusage's high-water mark,
+ * which cannot be reset: the peak the fork inherited is the baseline, and
+ * a run only counts the memory it uses beyond it.
+ */
+std::uint64_t peak_resident_kb() {
+  rusage usage{};
+  return ::getrusage(RUSAGE_SELF, &usage) == 0 ? maxrss_kb(usage.ru_maxrss) : 0;
+}
+
+std::uint64_t resident_kb() { return peak_resident_kb(); }
+void reset_peak_resident() {}
+#endif
+
+/**
+ * @brief Stores the run's final counts and status, once.
+ */
+void record(Status status) {
+  if (shared->recorded) return;
+  shared->recorded = true;
+  shared->peak_rss_kb = peak_resident_kb();
+#ifdef __linux__
+  if (counter_fd >= 0) {
+    ioctl(counter_fd, PERF_EVENT_IOC_DISABLE, 0);
+    std::uint64_t count = 0;
+    if (::read(counter_fd, &count, sizeof(count)) == sizeof(count)) shared->instructions = count;
+  }
+#endif
+  shared->status = status;
+}
+
+[[noreturn]] void input_exhausted() {
+  record(Status::Exhausted);
+  _exit(0);
+}
+
+void record_exit() { record(Status::Exited); }
+
+ssize_t read_input(void*, char* buffer, std::size_t size) {
+  if (position == input.size()) input_exhausted();
+  const std::size_t n = std::min(size, input.size() - position);
+  std::memcpy(buffer, input.data() + position, n);
+  position += n;
+  return static_cast<ssize_t>(n);
+}
+
+#ifndef __linux__
+/**
+ * @brief read_input with the signature funopen() takes.
+ */
+int read_input_chunk(void* cookie, char* buffer, int size) {
+  return static_cast<int>(read_input(cookie, buffer, static_cast<std::size_t>(size)));
+}
+#endif
+
+/**
+ * @brief std::cin's buffer in the child, for the C++ games.
+ */
+class InputBuffer : public std::streambuf {
+protected:
+  int_type underflow() override {
+    if (gptr() < egptr()) return traits_type::to_int_type(*gptr());
+    if (position == input.size()) input_exhausted();
+    char* begin = const_cast<char*>(input.data()) + position;
+    char* end = const_cast<char*>(input.data()) + input.size();
+    position = input.size();
+    setg(begin, begin, end);
+    return traits_type::to_int_type(*gptr());
+  }
+};
+
+/**
+ * @brief Opens a disabled counter of this process's user-space
+ * instructions; -1 where there is none, as everywhere but Linux.
+ */
+int open_instruction_counter() {
+#ifndef __linux__
+  return -1;
+#else
+  perf_event_attr attr{};
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.size = sizeof(attr);
+  attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+}
+
+struct Options {
+  std::uint64_t runs = 0;  ///< 0 means until seconds have passed
+  double seconds = 60;
+  std::size_t max_len = 1024;
+  std::uint64_t seed = 1;
+  std::uint64_t budget = 5'000'000;
+  unsigned timeout = 2;
+  std::size_t top = 8;
+  std::filesystem::path out = "perf_fuzz_results";
+  bool count_instructions = false;
+};
+
+/**
+ * @brief Runs the target on one input in a forked child and measures it.
+ *
+ * Edge hit counts are left in shared->hits.
+ */
+Measurement run(const Target& target, std::string_view data, const Options& options) {
+  std::memset(shared->hits, 0, sizeof(shared->hits));
+  shared->blocks = 0;
+  shared->budget = options.budget;
+  shared->instructions = 0;
+  shared->start_rss_kb = 0;
+  shared->peak_rss_kb = 0;
+  shared->status = Status::Exited;
+  shared->recorded = false;
+  std::fflush(stdout);
+  std::fflush(stderr);
+
+  const pid_t pid = fork();
+  if (pid < 0) throw std::system_error(errno, std::generic_category(), "fork");
+  if (pid == 0) {
+    const int null = ::open("/dev/null", O_WRONLY);
+    ::dup2(null, STDOUT_FILENO);
+    ::dup2(null, STDERR_FILENO);
+    const rlimit cpu{options.timeout, options.timeout + 1};
+    ::setrlimit(RLIMIT_CPU, &cpu);
+    if (!target.directory.empty() && ::chdir(target.directory.c_str()) != 0) _exit(EXIT_FAILURE);
+
+    input = data;
+    position = 0;
+#ifdef __linux__
+    input_stream = fopencookie(nullptr, "r", cookie_io_functions_t{read_input, nullptr, nullptr, nullptr});
+#else
+    input_stream = funopen(nullptr, read_input_chunk, nullptr, nullptr, nullptr);
+#endif
+    static InputBuffer buffer;
+    std::cin.rdbuf(&buffer);
+    std::atexit(record_exit);
+
+    // Peak memory counts from here.
+    reset_peak_resident();
+    shared->start_rss_kb = resident_kb();
+#ifdef __linux__
+    if (options.count_instructions && (counter_fd = open_instruction_counter()) >= 0) {
+      ioctl(counter_fd, PERF_EVENT_IOC_RESET, 0);
+      ioctl(counter_fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+    previous_block = 0;
+    in_child = true;
+    try {
+      target.run();
+    } catch (...) {
+      // Outside the fuzzer an exception escaping the game ends in std::terminate.
+      std::abort();
+    }
+    in_child = false;
+    record(Status::Exited);
+    _exit(0);
+  }
+
+  int wait_status = 0;
+  rusage usage{};
+  while (::wait4(pid, &wait_status, 0, &usage) < 0) {
+    if (errno != EINTR) throw std::system_error(errno, std::generic_category(), "wait4");
+  }
+
+  Measurement m;
+  m.blocks = std::min(shared->blocks, options.budget);
+  m.instructions = shared->instructions;
+  // The child's own high-water mark leaves out the process teardown that
+  // follows it; a child that crashed has only the kernel's figure.
+  const auto peak = shared->peak_rss_kb ? shared->peak_rss_kb : maxrss_kb(usage.ru_maxrss);
+  m.peak_rss_kb = peak > shared->start_rss_kb ? peak - shared->start_rss_kb : 0;
+  if (WIFSIGNALED(wait_status)) {
+    m.signal = WTERMSIG(wait_status);
+    m.status = m.signal == SIGXCPU || m.signal == SIGKILL ? Status::Timeout : Status::Crashed;
+  } else {
+    m.status = shared->status;
+  }
+  return m;
+}
+
+bool failed(Status s) { return s == Status::Crashed || s == Status::Timeout || s == Status::Budget; }
+
+/**
+ * @brief AFL-style hit-count bucket, as a bit: 1, 2, 3, 4-7, 8-15, 16-31, 32-127, 128+.
+ */
+std::uint8_t bucket(std::uint32_t hits) {
+  if (hits <= 3) return static_cast<std::uint8_t>(1u << (hits - 1));
+  if (hits < 8) return 1 << 3;
+  if (hits < 16) return 1 << 4;
+  if (hits < 32) return 1 << 5;
+  if (hits < 128) return 1 << 6;
+  return 1 << 7;
+}
+
+/**
+ * @brief Coverage seen so far, and the most any input has hit each edge.
+ */
+struct Feedback {
+  std::vector<std::uint8_t> buckets = std::vector<std::uint8_t>(MAP_SIZE);
+  std::vector<std::uint32_t> max_hits = std::vector<std::uint32_t>(MAP_SIZE);
+  std::uint64_t max_rss_kb = 0;
+
+  /**
+   * @brief Folds the last run into the feedback.
+   *
+   * @return Whether the run reached a new bucket, hit an edge more often than any run before, or used more memory
+   */
+  bool update(const Measurement& m) {
+    bool interesting = false;
+    for (std::size_t e = 0; e < MAP_SIZE; ++e) {
+      const std::uint32_t hits = shared->hits[e];
+      if (!hits) continue;
+      const std::uint8_t b = bucket(hits);
+      if (!(buckets[e] & b)) {
+        buckets[e] |= b;
+        interesting = true;
+      }
+      if (hits > max_hits[e]) {
+        max_hits[e] = hits;
+        interesting = true;
+      }
+    }
+    if (m.peak_rss_kb > max_rss_kb) {
+      max_rss_kb = m.peak_rss_kb;
+      interesting = true;
+    }
+    return interesting;
+  }
+
+  std::size_t edges() const {
+    return static_cast<std::size_t>(std::ranges::count_if(buckets, [](std::uint8_t b) { return b != 0; }));
+  }
+};
+
+/**
+ * @brief A hash of which edges the last run hit, to tell different failures apart.
+ */
+std::uint64_t coverage_signature() {
+  std::uint64_t h = 0xcbf29ce484222325ULL;
+  for (std::size_t e = 0; e < MAP_SIZE; ++e) {
+    if (shared->hits[e]) h = (h ^ e) * 0x100000001b3ULL;
+  }
+  return h;
+}
+
+struct Finding {
+  std::string input;
+  Measurement m;
+};
+
+/**
+ * @brief Keeps the k findings with the highest key, in descending order.
+ */
+template <class Key>
+void keep_top(std::vector<Finding>& top, std::size_t k, const std::string& input, const Measurement& m, Key key) {
+  if (top.size() == k && key(m) <= key(top.back().m)) return;
+  if (std::ranges::any_of(top, [&](const Finding& f) { return f.input == input; })) return;
+  auto at = std::ranges::find_if(top, [&](const Finding& f) { return key(m) > key(f.m); });
+  top.insert(at, Finding{input, m});
+  if (top.size() > k) top.pop_back();
+}
+
+/**
+ * @brief Produces a variant of an input from the corpus.
+ *
+ * Besides byte edits, the mutations favour what makes these games slow:
+ * long digit strings, repeated chunks (more prompts answered the same way)
+ * and the target's own answer tokens.
+ */
+class Mutator {
+public:
+  Mutator(std::uint64_t seed, const Target& target, std::size_t max_len)
+    : rng(seed), tokens(target.tokens), max_len(max_len) {}
+
+  std::string mutate(std::string s, const std::vector<std::string>& corpus) {
+    static constexpr std::string_view INTERESTING = "0123456789-+,. \nYNynyes";
+    const int edits = 1 + static_cast<int>(below(4));
+    for (int i = 0; i < edits; ++i) {
+      const std::size_t at = below(s.size() + 1);
+      switch (below(7)) {
+      case 0:
+        if (!s.empty()) s[below(s.size())] ^= static_cast<char>(1 << below(8));
+        break;
+      case 1:
+        if (!s.empty()) s[below(s.size())] = INTERESTING[below(INTERESTING.size())];
+        break;
+      case 2: {
+        std::string digits(1 + below(48), '9');
+        for (char& c : digits) c = static_cast<char>('0' + below(10));
+        s.insert(at, digits);
+        break;
+      }
+      case 3:
+        if (!s.empty()) {
+          const std::size_t from = below(s.size());
+          const std::string chunk = s.substr(from, 1 + below(std::min<std::size_t>(s.size() - from, 32)));
+          for (std::size_t n = 1 + below(16); n > 0; --n) s.insert(at, chunk);
+        }
+        break;
+      case 4:
+        if (!s.empty()) {
+          const std::size_t from = below(s.size());
+          s.erase(from, 1 + below(std::min<std::size_t>(s.size() - from, 32)));
+        }
+        break;
+      case 5:
+        if (!tokens.empty()) s.insert(at, tokens[below(tokens.size())]);
+        break;
+      case 6:
+        if (!corpus.empty()) {
+          const std::string& other = corpus[below(corpus.size())];
+          s = s.substr(0, at) + other.substr(below(other.size() + 1));
+        }
+        break;
+      }
+    }
+    if (s.size() > max_len) s.resize(max_len);
+    return s;
+  }
+
+  std::size_t below(std::size_t n) { return n ? static_cast<std::size_t>(rng() % n) : 0; }
+
+private:
+  std::mt19937_64 rng;
+  std::vector<std::string> tokens;
+  std::size_t max_len;
+};
+
+constexpr std::string_view INDEX_HEADER = "file\tkind\tstatus\tsignal\tblocks\tinstructions\tpeak_rss_kb\tbytes";
+
+std::string read_file(const std::filesystem::path& path) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) throw std::system_error(errno, std::generic_category(), path.string());
+  std::ostringstream s;
+  s << in.rdbuf();
+  return s.str();
+}
+
+void write_file(const std::filesystem::path& path, std::string_view data) {
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  out.write(data.data(), static_cast<std::streamsize>(data.size()));
+  if (!out) throw std::system_error(errno, std::generic_category(), path.string());
+}
+
+struct Stored {
+  std::string file;
+  std::string kind;
+  Measurement m;
+};
+
+Status parse_status(std::string_view s) {
+  for (Status st : {Status::Exhausted, Status::Exited, Status::Crashed, Status::Timeout, Status::Budget}) {
+    if (s == to_string(st)) return st;
+  }
+  throw std::runtime_error("unknown status in index: " + std::string(s));
+}
+
+/**
+ * @brief Reads index.tsv in dir; an absent index is an empty one.
+ */
+std::vector<Stored> read_index(const std::filesystem::path& dir) {
+  std::vector<Stored> stored;
+  std::ifstream in(dir / "index.tsv");
+  std::string line;
+  if (!in || !std::getline(in, line)) return stored;
+  while (std::getline(in, line)) {
+    std::istringstream fields(line);
+    Stored s;
+    std::string status;
+    fields >> s.file >> s.kind >> status >> s.m.signal >> s.m.blocks >> s.m.instructions >> s.m.peak_rss_kb;
+    if (!fields) throw std::runtime_error("malformed line in " + (dir / "index.tsv").string() + ": " + line);
+    s.m.status = parse_status(status);
+    stored.push_back(std::move(s));
+  }
+  return stored;
+}
+
+void write_results(const std::filesystem::path& dir, const std::vector<std::pair<std::string, std::vector<Finding>*>>& kinds) {
+  std::filesystem::create_directories(dir);
+  for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+    if (entry.path().extension() == ".in") std::filesystem::remove(entry.path());
+  }
+  std::string index = std::string(INDEX_HEADER) + "\n";
+  for (const auto& [kind, findings] : kinds) {
+    for (std::size_t i = 0; i < findings->size(); ++i) {
+      const Finding& f = (*findings)[i];
+      const std::string file = std::format("{}-{:02}.in", kind, i + 1);
+      write_file(dir / file, f.input);
+      index += std::format("{}\t{}\t{}\t{}\t{}\t{}\t{}\t{}\n", file, kind, to_string(f.m.status), f.m.signal, f.m.blocks,
+                           f.m.instructions, f.m.peak_rss_kb, f.input.size());
+    }
+  }
+  write_file(dir / "index.tsv", index);
+}
+
+std::string describe(const Measurement& m) {
+  std::string s = std::format("{} BLOCKS", m.blocks);
+  if (m.instructions) s += std::format(", {} INSTRUCTIONS", m.instructions);
+  s += std::format(", {} KB", m.peak_rss_kb);
+  if (m.signal) s += std::format(", SIGNAL {}", m.signal);
+  return s;
+}
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * @brief Fuzzes the target and writes the worst inputs found to options.out / target.name.
+ *
+ * Inputs stored by earlier sessions are used as seeds, so sessions build on each other.
+ */
+int fuzz(const Target& target, const Options& options) {
+  const std::filesystem::path dir = options.out / target.name;
+  std::vector<std::string> corpus(target.seeds);
+  for (const Stored& s : read_index(dir)) corpus.push_back(read_file(dir / s.file));
+  if (corpus.empty()) corpus.emplace_back();
+
+  Feedback feedback;
+  Mutator mutator(options.seed, target, options.max_len);
+  std::vector<Finding> by_cost, by_memory, failures;
+  std::vector<std::uint64_t> failure_signatures;
+  std::uint64_t runs = 0;
+  const auto start = std::chrono::steady_clock::now();
+  auto last_report = start;
+
+  auto consider = [&](const std::string& input, bool seed) {
+    const Measurement m = run(target, input, options);
+    ++runs;
+    const bool interesting = feedback.update(m);
+    if (failed(m.status)) {
+      const std::uint64_t signature = coverage_signature() ^ (static_cast<std::uint64_t>(m.status) << 56) ^ m.signal;
+      if (failures.size() < options.top && std::ranges::find(failure_signatures, signature) == failure_signatures.end()) {
+        failure_signatures.push_back(signature);
+        failures.push_back(Finding{input, m});
+        std::println("NEW {}: {} ({} BYTES)", to_string(m.status), describe(m), input.size());
+      }
+      return;
+    }
+    keep_top(by_cost, options.top, input, m, [](const Measurement& x) { return x.cost(); });
+    keep_top(by_memory, options.top, input, m, [](const Measurement& x) { return x.peak_rss_kb; });
+    if (interesting && !seed) corpus.push_back(input);
+  };
+
+  for (std::size_t i = 0, seeds = corpus.size(); i < seeds; ++i) consider(corpus[i], true);
+  while (options.runs ? runs < options.runs : seconds_since(start) < options.seconds) {
+    // Mostly work from the costliest inputs, sometimes from anywhere in the corpus.
+    const std::string& parent = !by_cost.empty() && mutator.below(2) == 0 ? by_cost[mutator.below(by_cost.size())].input
+                                                                          : corpus[mutator.below(corpus.size())];
+    consider(mutator.mutate(parent, corpus), false);
+    if (seconds_since(last_report) >= 5) {
+      last_report = std::chrono::steady_clock::now();
+      std::println("RUNS: {}  EXECS/SEC: {:.0f}  CORPUS: {}  EDGES: {}  WORST: {}  FAILURES: {}", runs,
+                   runs / seconds_since(start), corpus.size(), feedback.edges(),
+                   by_cost.empty() ? 0 : by_cost.front().m.cost(), failures.size());
+    }
+  }
+
+  write_results(dir, {{"cost", &by_cost}, {"memory", &by_memory}, {"crash", &failures}});
+  std::println("{}: {} RUNS IN {:.1f} SECONDS, CORPUS {}, EDGES {}", target.name, runs, seconds_since(start),
+               corpus.size(), feedback.edges());
+  std::println("RANKED BY {}", options.count_instructions ? "INSTRUCTIONS" : "BASIC BLOCKS (NO HARDWARE COUNTER)");
+  for (std::size_t i = 0; i < by_cost.size(); ++i) {
+    std::println("COST {:2}: {} ({} BYTES)", i + 1, describe(by_cost[i].m), by_cost[i].input.size());
+  }
+  for (std::size_t i = 0; i < by_memory.size(); ++i) {
+    std::println("MEMORY {:2}: {} ({} BYTES)", i + 1, describe(by_memory[i].m), by_memory[i].input.size());
+  }
+  for (std::size_t i = 0; i < failures.size(); ++i) {
+    std::println("{} {:2}: {} ({} BYTES)", to_string(failures[i].m.status), i + 1, describe(failures[i].m),
+                 failures[i].input.size());
+  }
+  std::println("SAVED TO {}", dir.string());
+  return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Reruns stored inputs and compares them with their recorded measurements.
+ *
+ * A run regresses if it now fails where it used to finish, or costs or uses
+ * more than 10% above the recorded figure; memory also gets 128 kB of
+ * slack, as the allocator's starting point varies with the fuzzer's heap.
+ *
+ * @return EXIT_FAILURE if anything regressed
+ */
+int replay(const Target& target, std::filesystem::path dir, const Options& options) {
+  if (!std::filesystem::exists(dir / "index.tsv")) dir /= target.name;
+  const std::vector<Stored> stored = read_index(dir);
+  if (stored.empty()) throw std::runtime_error("no index.tsv in " + dir.string());
+
+  int regressions = 0;
+  for (const Stored& s : stored) {
+    const std::string input = read_file(dir / s.file);
+    const auto start = std::chrono::steady_clock::now();
+    const Measurement m = run(target, input, options);
+    const double ms = seconds_since(start) * 1e3;
+
+    const bool by_instructions = s.m.instructions && m.instructions;
+    const std::uint64_t was = by_instructions ? s.m.instructions : s.m.blocks;
+    const std::uint64_t now = by_instructions ? m.instructions : m.blocks;
+    std::string_view verdict = "SAME";
+    if (failed(m.status) && !failed(s.m.status)) {
+      verdict = "REGRESSED";
+    } else if (!failed(m.status) && failed(s.m.status)) {
+      verdict = "FIXED";
+    } else if (now * 10 > was * 11 || m.peak_rss_kb > s.m.peak_rss_kb + s.m.peak_rss_kb / 10 + 128) {
+      verdict = "REGRESSED";
+    } else if (now * 10 < was * 9) {
+      verdict = "IMPROVED";
+    }
+    regressions += verdict == "REGRESSED";
+    std::println("{:12} {:9} {:>12} (WAS {:>12}) {:>7} KB (WAS {:>7}) {:8.2f} MS  {}", s.file, to_string(m.status), now,
+                 was, m.peak_rss_kb, s.m.peak_rss_kb, ms, verdict);
+  }
+  std::println("{}: {} INPUTS, {} REGRESSED", target.name, stored.size(), regressions);
+  return regressions ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+}  // namespace
+
+const char* to_string(Status s) {
+  switch (s) {
+  case Status::Exhausted: return "EXHAUSTED";
+  case Status::Exited: return "EXITED";
+  case Status::Crashed: return "CRASHED";
+  case Status::Timeout: return "TIMEOUT";
+  case Status::Budget: return "BUDGET";
+  }
+  return "?";
+}
+
+/**
+ * @brief Parses the fuzzer's options and fuzzes the target, or replays stored inputs.
+ *
+ * @param argc Argument count
+ * @param argv Arguments
+ * @param target The game to fuzz
+ * @return Process exit status
+ */
+int main(int argc, char* argv[], const Target& target) {
+  Options options;
+  std::optional<std::filesystem::path> replay_dir;
+  const std::string usage = std::format("Usage: perf_fuzz_{} [--runs N] [--seconds N] [--max-len N] [--seed N] "
+                                        "[--budget N] [--timeout N] [--top N] [--out DIR] | --replay DIR",
+                                        target.name);
+
+  try {
+    for (int i = 1; i + 1 < argc; i += 2) {
+      std::string_view flag = argv[i];
+      if (flag == "--runs") {
+        options.runs = std::stoull(argv[i + 1]);
+      } else if (flag == "--seconds") {
+        options.seconds = std::stod(argv[i + 1]);
+      } else if (flag == "--max-len") {
+        options.max_len = std::stoull(argv[i + 1]);
+      } else if (flag == "--seed") {
+        options.seed = std::stoull(argv[i + 1]);
+      } else if (flag == "--budget") {
+        options.budget = std::stoull(argv[i + 1]);
+      } else if (flag == "--timeout") {
+        options.timeout = static_cast<unsigned>(std::stoul(argv[i + 1]));
+      } else if (flag == "--top") {
+        options.top = std::stoull(argv[i + 1]);
+      } else if (flag == "--out") {
+        options.out = argv[i + 1];
+      } else if (flag == "--replay") {
+        replay_dir = argv[i + 1];
+      } else {
+        std::println(stderr, "{}", usage);
+        return EXIT_FAILURE;
+      }
+    }
+  } catch (const std::exception&) {
+    std::println(stderr, "{}", usage);
+    return EXIT_FAILURE;
+  }
+  if (argc % 2 == 0) {
+    std::println(stderr, "{}", usage);
+    return EXIT_FAILURE;
+  }
+
+  try {
+    void* map = mmap(nullptr, sizeof(Shared), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (map == MAP_FAILED) throw std::system_error(errno, std::generic_category(), "mmap");
+    shared = static_cast<Shared*>(map);
+    if (const int fd = open_instruction_counter(); fd >= 0) {
+      options.count_instructions = true;
+      ::close(fd);
+    }
+    return replay_dir ? replay(target, *replay_dir, options) : fuzz(target, options);
+  } catch (const std::exception& e) {
+    std::println(stderr, "Error: {}", e.what());
+    return EXIT_FAILURE;
+  }
+}
+
+}  // namespace perf_fuzz
+
+/**
+ * @brief Input stream the C games read through fuzz_stdio.h: the current input in a run, else stdin.
+ */
+extern "C" FILE* fuzz_stdin(void) { return perf_fuzz::input_stream ? perf_fuzz::input_stream : stdin; }
+
+/**
+ * @brief srand() for the C games: always the same seed, so a stored input replays the same game.
+ */
+extern "C" void fuzz_srand(unsigned) { std::srand(1); }
+
+/**
+ * @brief system() for the C games, which only use it to clear the screen.
+ */
+extern "C" int fuzz_system(const char*) { return 0; }
+
+/**
+ * @brief Called by -fsanitize-coverage=trace-pc at every basic block of the instrumented game.
+ *
+ * Counts the block, and the edge from the previous block in the shared
+ * map. A run that goes over the block budget is ended here, so a loop
+ * that never reads input still stops.
+ */
+extern "C" void __sanitizer_cov_trace_pc(void) {
+  using namespace perf_fuzz;
+  if (!in_child) return;
+  const std::uintptr_t block = (reinterpret_cast<std::uintptr_t>(__builtin_return_address(0)) * 0x9e3779b97f4a7c15ULL) >> 48;
+  ++shared->hits[(block ^ previous_block) & (MAP_SIZE - 1)];
+  previous_block = block >> 1;
+  if (++shared->blocks > shared->budget) {
+    record(Status::Budget);
+    _exit(0);
+  }
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Offline performance fuzzer for the native game ports.
+ *
+ * Each game is compiled into its own fuzzer binary with basic-block
+ * coverage instrumentation (-fsanitize-coverage=trace-pc) and with its
+ * stdin, srand() and system() redirected by fuzz_stdio.h. Every input runs
+ * in a forked child: the game reads the input as its stdin, and when it
+ * asks for more input than there is, the run ends there. This also ends
+ * the prompt loops that would otherwise spin forever on end of file.
+ *
+ * A run is scored by basic blocks executed (and by instructions, when the
+ * kernel exposes a hardware counter) and by peak resident memory. The
+ * instruction counter and the resettable memory high-water mark come from
+ * Linux (perf_event_open and /proc); elsewhere, as on macOS, a run is
+ * ranked by basic blocks alone and its memory is measured from getrusage
+ * above the peak the fork inherited. An input
+ * is kept in the corpus if it reaches a new coverage bucket or raises the
+ * highest hit count seen for any edge, as in PerfFuzz, so the search is
+ * steered towards inputs that make some part of the program run longer
+ * rather than only towards new code. Crashes, CPU timeouts and runs that
+ * exceed the block budget are recorded as well.
+ *
+ * The worst inputs are written out with their scores and can be replayed
+ * later as regression benchmarks. Nothing needs a network or any tool
+ * beyond the compiler.
+ */
+namespace perf_fuzz {
+
+/**
+ * @brief A game to fuzz.
+ */
+struct Target {
+  std::string name;
+  std::function<void()> run;           ///< Plays the game on the redirected stdin; may call exit()
+  std::vector<std::string> seeds;      ///< Starting corpus
+  std::vector<std::string> tokens;     ///< Fragments the mutator splices in, e.g. "YES\n"
+  std::filesystem::path directory;     ///< Working directory for each run, empty for the current one
+};
+
+enum class Status : std::uint8_t {
+  Exhausted,  ///< Asked for more input than there was: the normal end of a run
+  Exited,     ///< Returned or called exit() before using all the input
+  Crashed,    ///< Killed by a signal
+  Timeout,    ///< Ran out of CPU time
+  Budget,     ///< Executed more basic blocks than allowed
+};
+
+const char* to_string(Status s);
+
+struct Measurement {
+  std::uint64_t blocks = 0;        ///< Basic blocks executed in instrumented code
+  std::uint64_t instructions = 0;  ///< User-space instructions, 0 if no counter is available
+  std::uint64_t peak_rss_kb = 0;   ///< Peak resident memory above an empty run
+  Status status = Status::Exited;
+  int signal = 0;                  ///< Signal that ended a Crashed or Timeout run
+
+  /**
+   * @brief The number runs are ranked by: instructions if counted, else basic blocks.
+   */
+  std::uint64_t cost() const { return instructions ? instructions : blocks; }
+};
+
+/**
+ * @brief Command-line entry point shared by every fuzzer binary.
+ *
+ * Usage: perf_fuzz_<game> [--runs N] [--seconds N] [--max-len N] [--seed N] [--budget N]
+ *                         [--timeout N] [--top N] [--out DIR] | --replay DIR
+ */
+int main(int argc, char* argv[], const Target& target);
+
+}  // namespace perf_fuzz
@@ -0,0 +1,32 @@
+/*
+ * Force-included (-include fuzz_stdio.h) into the C games when they are
+ * built into a fuzzer. Console input goes to the fuzzer's input stream,
+ * srand() gets a fixed seed so runs are repeatable, and system() (used to
+ * clear the screen) does nothing.
+ */
+#ifndef PERF_FUZZ_STDIO_H
+#define PERF_FUZZ_STDIO_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+FILE *fuzz_stdin(void);
+void fuzz_srand(unsigned seed);
+int fuzz_system(const char *command);
+
+#ifdef __cplusplus
+}
+#endif
+
+#undef stdin
+#define stdin fuzz_stdin()
+#define scanf(...) fscanf(fuzz_stdin(), __VA_ARGS__)
+#define getchar() fgetc(fuzz_stdin())
+#define srand(seed) fuzz_srand(seed)
+#define system(command) fuzz_system(command)
+
+#endif
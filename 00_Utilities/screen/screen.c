@@ -0,0 +1,384 @@
+#include "screen.h"
+
+#include <errno.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define UNKNOWN '\0'   /* a front cell whose content on the terminal is not known */
+
+struct screen{
+    int fd;
+    int rows;
+    int columns;
+    char *back;          /* frame being drawn */
+    char *front;         /* frame on the terminal */
+    int row;             /* drawing cursor */
+    int column;
+    int cursor_row;      /* terminal cursor, -1 when not known */
+    int cursor_column;
+    int cleared;         /* the terminal has been cleared, so front is what it shows */
+
+    char *out;           /* escape sequences and text of the flush being built */
+    size_t out_length;
+
+    screen_stats stats;
+};
+
+static int digits(int n){
+    int d = 1;
+    while(n >= 10){
+        n /= 10;
+        d++;
+    }
+    return d;
+}
+
+static void put_char(screen *s, char c){
+    s->out[s->out_length++] = c;
+}
+
+static void put_number(screen *s, int n){
+    s->out_length += (size_t)sprintf(s->out + s->out_length, "%d", n);
+}
+
+/* Bytes to move right by n with ESC [ n C */
+static int forward_cost(int n){
+    return n == 1 ? 3 : 3 + digits(n);
+}
+
+/* Bytes to get from column from to column to on the same row: rewrite the cells between or ESC [ n C */
+static int gap_cost(int from, int to){
+    int n = to - from;
+    if(n == 0){
+        return 0;
+    }
+    return n < forward_cost(n) ? n : forward_cost(n);
+}
+
+/* Bytes of ESC [ row ; column H, the row alone when the column is the first */
+static int position_cost(int row, int column){
+    return column == 0 ? 3 + digits(row + 1) : 4 + digits(row + 1) + digits(column + 1);
+}
+
+static void put_gap(screen *s, int row, int from, int to){
+    int n = to - from;
+    if(n == 0){
+        return;
+    }
+    if(n < forward_cost(n)){
+        memcpy(s->out + s->out_length, s->back + (size_t)row * s->columns + from, (size_t)n);
+        memcpy(s->front + (size_t)row * s->columns + from, s->back + (size_t)row * s->columns + from, (size_t)n);
+        s->out_length += (size_t)n;
+    }else{
+        put_char(s, '\033');
+        put_char(s, '[');
+        if(n > 1){
+            put_number(s, n);
+        }
+        put_char(s, 'C');
+    }
+}
+
+/* Moves the terminal cursor to (row, column) the cheapest way. */
+static void move_to(screen *s, int row, int column){
+    int best = position_cost(row, column), how = 0;  /* 0 absolute, 1 same row, 2 return and line feeds */
+    if(s->cursor_row == row && s->cursor_column == column){
+        return;
+    }
+    if(s->cursor_row >= 0){
+        int cost;
+        if(s->cursor_row == row && s->cursor_column < column){
+            cost = gap_cost(s->cursor_column, column);
+            if(cost < best){
+                best = cost;
+                how = 1;
+            }
+        }
+        if(s->cursor_row <= row){
+            cost = 1 + (row - s->cursor_row) + gap_cost(0, column);
+            if(cost < best){
+                best = cost;
+                how = 2;
+            }
+        }
+    }
+
+    if(how == 1){
+        put_gap(s, row, s->cursor_column, column);
+    }else if(how == 2){
+        put_char(s, '\r');
+        for(int r = s->cursor_row; r < row; r++){
+            put_char(s, '\n');
+        }
+        put_gap(s, row, 0, column);
+    }else{
+        put_char(s, '\033');
+        put_char(s, '[');
+        put_number(s, row + 1);
+        if(column > 0){
+            put_char(s, ';');
+            put_number(s, column + 1);
+        }
+        put_char(s, 'H');
+    }
+    s->cursor_row = row;
+    s->cursor_column = column;
+}
+
+static void write_out(screen *s){
+    const char *p = s->out;
+    size_t n = s->out_length;
+    while(n > 0){
+        ssize_t w = write(s->fd, p, n);
+        if(w < 0 && errno == EINTR){
+            continue;
+        }
+        if(w <= 0){
+            break;  /* the terminal went away; the game's own next write will find out */
+        }
+        p += w;
+        n -= (size_t)w;
+    }
+    s->stats.bytes += s->out_length;
+    s->out_length = 0;
+}
+
+screen *screen_open(int fd, int rows, int columns){
+    screen *s;
+    size_t cells;
+    if(rows <= 0 || columns <= 0){
+        errno = EINVAL;
+        return NULL;
+    }
+    cells = (size_t)rows * (size_t)columns;
+    s = calloc(1, sizeof(screen));
+    if(s == NULL){
+        return NULL;
+    }
+    s->fd = fd;
+    s->rows = rows;
+    s->columns = columns;
+    s->back = malloc(cells);
+    s->front = malloc(cells);
+    /* Worst case: every cell needs its own absolute move, plus the clear and the final move. */
+    s->out = malloc(cells * (size_t)(6 + digits(rows) + digits(columns)) + 64);
+    if(s->back == NULL || s->front == NULL || s->out == NULL){
+        free(s->back);
+        free(s->front);
+        free(s->out);
+        free(s);
+        errno = ENOMEM;
+        return NULL;
+    }
+    memset(s->back, ' ', cells);
+    s->cursor_row = -1;
+    return s;
+}
+
+void screen_clear(screen *s){
+    memset(s->back, ' ', (size_t)s->rows * s->columns);
+    s->row = 0;
+    s->column = 0;
+}
+
+void screen_move(screen *s, int row, int column){
+    s->row = row < 0 ? 0 : row >= s->rows ? s->rows - 1 : row;
+    s->column = column < 0 ? 0 : column >= s->columns ? s->columns - 1 : column;
+}
+
+/* Moves the drawing cursor to the start of the next row, scrolling the frame up at the bottom. */
+static void new_line(screen *s){
+    s->column = 0;
+    if(++s->row == s->rows){
+        size_t row_bytes = (size_t)s->columns;
+        memmove(s->back, s->back + row_bytes, row_bytes * (size_t)(s->rows - 1));
+        memset(s->back + row_bytes * (size_t)(s->rows - 1), ' ', row_bytes);
+        s->row = s->rows - 1;
+    }
+}
+
+void screen_write(screen *s, const char *text, size_t n){
+    for(size_t i = 0; i < n; i++){
+        unsigned char c = (unsigned char)text[i];
+        if(c == '\n'){
+            new_line(s);
+        }else if(c == '\r'){
+            s->column = 0;
+        }else if(c == '\t'){
+            s->column = (s->column / 8 + 1) * 8;
+            if(s->column > s->columns - 1){
+                s->column = s->columns - 1;
+            }
+        }else if(c == '\b'){
+            if(s->column > 0){
+                s->column--;
+            }
+        }else if(c >= ' '){
+            if(s->column == s->columns){
+                new_line(s);
+            }
+            s->back[(size_t)s->row * s->columns + s->column++] = c < 127 ? (char)c : '?';
+        }
+    }
+}
+
+int screen_vprintf(screen *s, const char *format, va_list args){
+    char buffer[1024];
+    char *text = buffer;
+    va_list copy;
+    int n;
+
+    va_copy(copy, args);
+    n = vsnprintf(buffer, sizeof(buffer), format, args);
+    if(n >= 0 && (size_t)n >= sizeof(buffer)){
+        text = malloc((size_t)n + 1);
+        if(text == NULL){
+            va_end(copy);
+            return -1;
+        }
+        vsnprintf(text, (size_t)n + 1, format, copy);
+    }
+    va_end(copy);
+    if(n > 0){
+        screen_write(s, text, (size_t)n);
+    }
+    if(text != buffer){
+        free(text);
+    }
+    return n;
+}
+
+int screen_printf(screen *s, const char *format, ...){
+    va_list args;
+    int n;
+    va_start(args, format);
+    n = screen_vprintf(s, format, args);
+    va_end(args);
+    return n;
+}
+
+/* Whether ESC [ K is shorter than overwriting the cells of a blank tail that are not blank on the terminal */
+static int erase_pays(const char *front, int n){
+    int changed = 0;
+    for(int c = 0; c < n && changed < 3; c++){
+        changed += front[c] != ' ';
+    }
+    return changed >= 3;
+}
+
+size_t screen_flush(screen *s){
+    size_t cells = (size_t)s->rows * s->columns;
+    size_t written;
+    int last_row = -1;
+
+    if(!s->cleared){
+        memcpy(s->out, "\033[H\033[2J", 7);
+        s->out_length = 7;
+        memset(s->front, ' ', cells);
+        s->cursor_row = 0;
+        s->cursor_column = 0;
+        s->cleared = 1;
+    }
+
+    for(int r = 0; r < s->rows; r++){
+        const char *back = s->back + (size_t)r * s->columns;
+        char *front = s->front + (size_t)r * s->columns;
+        int end = s->columns;
+        while(end > 0 && back[end - 1] == ' '){
+            end--;
+        }
+        if(end > 0){
+            last_row = r;
+        }
+        s->stats.full_bytes += (size_t)end;
+        if(memcmp(back, front, (size_t)s->columns) == 0){
+            continue;
+        }
+        for(int c = 0; c < s->columns; c++){
+            if(back[c] == front[c]){
+                continue;
+            }
+            if(c >= end && erase_pays(front + c, s->columns - c)){
+                /* Only blanks from here on: erase to the end of the row */
+                move_to(s, r, c);
+                put_char(s, '\033');
+                put_char(s, '[');
+                put_char(s, 'K');
+                for(; c < s->columns; c++){
+                    s->stats.cells += front[c] != ' ';
+                    front[c] = ' ';
+                }
+                break;
+            }
+            move_to(s, r, c);
+            put_char(s, back[c]);
+            front[c] = back[c];
+            s->stats.cells++;
+            s->cursor_column++;
+            if(s->cursor_column == s->columns){
+                s->cursor_row = -1;  /* wrap pending: where the next character lands depends on the terminal */
+            }
+        }
+    }
+    /* Clear, then every row up to the last non-blank one and a line break after each */
+    s->stats.full_bytes += 7 + 2 * (unsigned long long)(last_row + 1);
+
+    if(s->out_length > 0 || s->cursor_row != s->row || s->cursor_column != s->column){
+        move_to(s, s->row, s->column < s->columns ? s->column : s->columns - 1);
+    }
+    written = s->out_length;
+    write_out(s);
+    s->stats.frames++;
+    return written;
+}
+
+void screen_input(screen *s){
+    size_t row_bytes = (size_t)s->columns;
+    if(s->cleared){
+        memset(s->front + (size_t)s->row * row_bytes + s->column, UNKNOWN, row_bytes - (size_t)s->column);
+        if(s->row == s->rows - 1){
+            /* The echoed newline scrolled the terminal */
+            memmove(s->front, s->front + row_bytes, row_bytes * (size_t)(s->rows - 1));
+            memset(s->front + row_bytes * (size_t)(s->rows - 1), UNKNOWN, row_bytes);
+        }
+    }
+    /* Input may also have come from what was typed ahead, with no echo here */
+    s->cursor_row = -1;
+    new_line(s);
+}
+
+void screen_invalidate(screen *s){
+    s->cleared = 0;
+}
+
+screen_stats screen_get_stats(const screen *s){
+    return s->stats;
+}
+
+static int blank_row(const char *row, int columns){
+    for(int c = 0; c < columns; c++){
+        if(row[c] != ' '){
+            return 0;
+        }
+    }
+    return 1;
+}
+
+void screen_close(screen *s){
+    int last = s->rows - 1;
+    screen_flush(s);
+    while(last > 0 && blank_row(s->front + (size_t)last * s->columns, s->columns)){
+        last--;
+    }
+    move_to(s, last, 0);
+    put_char(s, '\r');
+    put_char(s, '\n');
+    write_out(s);
+    free(s->back);
+    free(s->front);
+    free(s->out);
+    free(s);
+}
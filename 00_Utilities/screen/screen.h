@@ -0,0 +1,87 @@
+/*
+ * Damage-tracking terminal renderer.
+ *
+ * A screen keeps two character buffers: the frame being drawn and the
+ * frame last sent to the terminal. Drawing only changes the first;
+ * screen_flush compares the two and sends the cells that differ, reaching
+ * each with the cheapest of an absolute cursor move, a cursor-forward, a
+ * carriage return and line feeds, or rewriting the unchanged characters in
+ * between, all in a single write. Nothing is sent for a frame that did not
+ * change.
+ *
+ * Drawing follows the terminal's own rules, so console output can be sent
+ * through a screen unchanged: text goes at the cursor, '\n' starts the
+ * next row, a full row wraps, and writing past the last row scrolls.
+ * screen_stdio.h routes a C game's printf, scanf and system("clear")
+ * through a screen this way.
+ *
+ * Only 7-bit text is tracked; other bytes are drawn as '?'.
+ */
+#ifndef SCREEN_H
+#define SCREEN_H
+
+#include <stdarg.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct screen screen;
+
+/* What a screen has sent so far. */
+typedef struct{
+    unsigned long frames;             /* flushes */
+    unsigned long long bytes;         /* bytes written */
+    unsigned long long cells;         /* cells that changed */
+    unsigned long long full_bytes;    /* bytes clearing and reprinting every frame would have written */
+}screen_stats;
+
+/*
+ * Creates a screen of rows by columns drawing to the file descriptor fd.
+ * The first flush clears the terminal. Returns NULL with errno set on failure.
+ */
+screen *screen_open(int fd, int rows, int columns);
+
+/* Leaves the terminal cursor on the row after the last one drawn and frees the screen. */
+void screen_close(screen *s);
+
+/* Starts a new frame: every cell blank and the cursor at the top left. */
+void screen_clear(screen *s);
+
+/* Moves the drawing cursor; out-of-range positions are clamped. */
+void screen_move(screen *s, int row, int column);
+
+/* Draws n bytes of text at the cursor. */
+void screen_write(screen *s, const char *text, size_t n);
+
+/* Draws formatted text at the cursor and returns the number of bytes drawn, as printf does. */
+int screen_printf(screen *s, const char *format, ...)
+#if defined(__GNUC__)
+    __attribute__((format(printf, 2, 3)))
+#endif
+    ;
+
+int screen_vprintf(screen *s, const char *format, va_list args);
+
+/* Sends the changes since the last flush in one write and returns the number of bytes written. */
+size_t screen_flush(screen *s);
+
+/*
+ * Tells the screen that the terminal echoed a line of input at the
+ * cursor. The rest of that row is redrawn at the next flush and the
+ * drawing cursor moves to the start of the next row, as the echoed
+ * newline moved the terminal's.
+ */
+void screen_input(screen *s);
+
+/* Makes the next flush clear the terminal and redraw everything. */
+void screen_invalidate(screen *s);
+
+screen_stats screen_get_stats(const screen *s);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
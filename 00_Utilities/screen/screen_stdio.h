@@ -0,0 +1,87 @@
+/*
+ * Sends a C game's console output through a damage-tracking screen.
+ *
+ * Included after the standard headers by a game built with
+ * SCREEN_RENDERER. printf draws into the screen's frame, system() (which
+ * the games only call to clear the screen) starts a new frame instead of
+ * running clear, and scanf first sends what changed since the last input
+ * in one write. The whole page is no longer reprinted after every clear;
+ * only the cells that differ from what the terminal shows are sent.
+ *
+ * When standard output is not a terminal the game runs unchanged. At exit
+ * the frames, bytes per frame, and what clearing and reprinting would
+ * have cost are reported on standard error.
+ */
+#ifndef SCREEN_STDIO_H
+#define SCREEN_STDIO_H
+
+#include "screen.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+static screen *game_screen = NULL;
+
+static void game_screen_close(void){
+    screen_stats stats = screen_get_stats(game_screen);
+    screen_close(game_screen);
+    if(stats.frames > 0){
+        fprintf(stderr, "SCREEN: %lu FRAMES  %.1f BYTES/FRAME  (%.1f CLEARING AND REPRINTING)\n", stats.frames,
+                (double)stats.bytes / stats.frames, (double)stats.full_bytes / stats.frames);
+    }
+}
+
+__attribute__((constructor)) static void game_screen_open(void){
+    struct winsize size;
+    int rows = 24, columns = 80;
+    if(!isatty(STDOUT_FILENO)){
+        return;
+    }
+    if(ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_row > 0 && size.ws_col > 0){
+        rows = size.ws_row;
+        columns = size.ws_col;
+    }
+    game_screen = screen_open(STDOUT_FILENO, rows, columns);
+    if(game_screen != NULL){
+        atexit(game_screen_close);
+    }
+}
+
+static int game_printf(const char *format, ...){
+    va_list args;
+    int n;
+    va_start(args, format);
+    n = game_screen != NULL ? screen_vprintf(game_screen, format, args) : vprintf(format, args);
+    va_end(args);
+    return n;
+}
+
+static int game_system(const char *command){
+    if(game_screen != NULL){
+        screen_clear(game_screen);
+        return 0;
+    }
+    return (system)(command);
+}
+
+static void game_flush(void){
+    if(game_screen != NULL){
+        screen_flush(game_screen);
+    }
+}
+
+static int game_input(int result){
+    if(game_screen != NULL){
+        screen_input(game_screen);
+    }
+    return result;
+}
+
+#define printf(...) game_printf(__VA_ARGS__)
+#define system(command) game_system(command)
+#define scanf(...) (game_flush(), game_input(scanf(__VA_ARGS__)))
+
+#endif
@@ -0,0 +1,102 @@
+#include "acey_ducey.h"
+#include "AceyDuceyRules.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <print>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Nanoseconds per iteration of f, run `count` times.
+ */
+template <class F>
+double time_per_call(std::size_t count, F&& f) {
+  auto start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < count; ++i) f(i);
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / count;
+}
+
+}  // namespace
+
+/**
+ * @brief Entry point for the C ABI overhead benchmark.
+ *
+ * Compares calling the shared library one round at a time, in one batch,
+ * and the same rules compiled inline, so the cost of crossing the ABI can
+ * be read off directly.
+ *
+ * Usage: AceyDuceyAbiBench [--rounds N]
+ */
+int main(int argc, char* argv[]) {
+  std::size_t rounds = 10'000'000;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (std::string_view(argv[i]) == "--rounds") {
+      rounds = std::stoull(argv[i + 1]);
+    } else {
+      std::println(stderr, "Usage: AceyDuceyAbiBench [--rounds N]");
+      return EXIT_FAILURE;
+    }
+  }
+  if (rounds == 0) return EXIT_SUCCESS;
+
+  if ((acey_abi_version() >> 16) != (ACEY_ABI_VERSION >> 16) || acey_abi_version() < ACEY_ABI_VERSION) {
+    std::println(stderr, "Error: library ABI {:#x} is incompatible with {:#x}", acey_abi_version(),
+                 ACEY_ABI_VERSION);
+    return EXIT_FAILURE;
+  }
+
+  std::mt19937_64 rng(1);
+  std::uniform_int_distribution<std::int32_t> card(acey_ducey::LOWEST_CARD, acey_ducey::HIGHEST_CARD);
+  std::uniform_int_distribution<std::int32_t> stake(0, 100);
+  std::vector<std::int32_t> first(rounds), second(rounds), third(rounds), bet(rounds);
+  std::vector<std::int32_t> delta(rounds), expected(rounds);
+  for (std::size_t i = 0; i < rounds; ++i) {
+    first[i] = card(rng);
+    second[i] = card(rng);
+    third[i] = card(rng);
+    bet[i] = stake(rng);
+  }
+
+  std::println("ROUNDS: {}  LIBRARY ABI: {:#x}", rounds, acey_abi_version());
+
+  volatile std::uint32_t sink = 0;
+  double ns = time_per_call(rounds, [&](std::size_t) { sink = sink + acey_abi_version(); });
+  std::println("EMPTY CALL:               {:8.2f} NS", ns);
+
+  ns = time_per_call(rounds, [&](std::size_t i) {
+    expected[i] = acey_ducey::settle(first[i], second[i], third[i], bet[i]);
+  });
+  std::println("INLINE RULES:             {:8.2f} NS/ROUND", ns);
+
+  ns = time_per_call(rounds, [&](std::size_t i) {
+    acey_evaluate_rounds(&first[i], &second[i], &third[i], &bet[i], &delta[i], 1);
+  });
+  std::println("ABI, ONE ROUND PER CALL:  {:8.2f} NS/ROUND", ns);
+
+  ns = time_per_call(1, [&](std::size_t) {
+    acey_evaluate_rounds(first.data(), second.data(), third.data(), bet.data(), delta.data(), rounds);
+  }) / rounds;
+  std::println("ABI, ONE BATCH:           {:8.2f} NS/ROUND", ns);
+
+  if (delta != expected) {
+    std::println(stderr, "Error: batch results differ from the inline rules");
+    return EXIT_FAILURE;
+  }
+
+  acey_session* session = acey_session_create(1, 1'000'000'000);
+  if (!session) {
+    std::println(stderr, "Error: cannot create session");
+    return EXIT_FAILURE;
+  }
+  ns = time_per_call(rounds, [&](std::size_t i) {
+    std::int32_t a, b, c;
+    acey_session_deal(session, &a, &b);
+    acey_session_settle(session, bet[i], &c);
+  });
+  std::println("SESSION DEAL + SETTLE:    {:8.2f} NS/ROUND  (BALANCE ${})", ns, acey_session_balance(session));
+  acey_session_destroy(session);
+}
@@ -1,34 +1,94 @@
 #include "AceyDucey.hpp"
+#include "FairDeck.hpp"
+#include "Leaderboard.hpp"
+#include "Ledger.hpp"
+#include "Trace.hpp"
+#include "agent.h"
 #include <__algorithm/ranges_find.h>
 #include <__algorithm/ranges_all_of.h>
 #include <iostream>
 #include <print>
 #include <algorithm>
 #include <cctype>
+#include <climits>
+#include <cstdio>
+
+namespace {
+
+/**
+ * @brief Adds the seeds revealed for a batch to an agent's fields, one
+ * string field per lane (a protocol string holds at most 255 bytes).
+ */
+void add_revealed(std::vector<agent_field>& fields, const std::vector<std::string>& seeds, std::size_t rounds) {
+  static constexpr const char* NAMES[] = {"seed0", "seed1", "seed2", "seed3", "seed4", "seed5", "seed6", "seed7"};
+  static_assert(std::size(NAMES) == FairDeck::LANES);
+  if (seeds.empty()) return;
+  fields.push_back({"revealed_rounds", static_cast<long long>(rounds), nullptr});
+  for (std::size_t l = 0; l < seeds.size(); ++l) fields.push_back({NAMES[l], 0, seeds[l].c_str()});
+}
+
+}  // namespace
 
 /**
  * @brief Constructs a new AceyDucey game instance.
  *
- * Initializes the player's balance to $100, copies the static CARDS
- * array into the deck, seeds the random number generator, and sets the
- * initial game state to Initialising.
+ * Initializes the player's balance to $100, or to the player's balance in
+ * the ledger if one is given, copies the static CARDS array into the deck,
+ * seeds the random number generator, and sets the initial game state to
+ * Initialising. Building with ACEY_DUCEY_SEED defined fixes the seed, so the
+ * same input always meets the same cards (the performance fuzzer needs this).
+ *
+ * @param ledger Durable ledger, or null
+ * @param player Player id within the ledger and on the leaderboard
+ * @param leaderboard Shared leaderboard, or null
+ * @param trace Per-round trace, or null
+ * @param player_agent Agent protocol session, or null
+ * @param fair Provably fair deck, or null
  */
-AceyDucey::AceyDucey()
-  : balance(100),
+template <class Rules>
+AceyDucey<Rules>::AceyDucey(Ledger* ledger, std::uint64_t player, Leaderboard* leaderboard, TraceWriter* trace,
+                            agent* player_agent, FairDeck* fair)
+  : balance(acey_ducey::STARTING_BALANCE),
     deck(std::ranges::begin(CARDS), std::ranges::end(CARDS)),
+#ifdef ACEY_DUCEY_SEED
+    rng(ACEY_DUCEY_SEED),
+#else
     rng(std::random_device{}()),
-    state(State::Initialising) {}
+#endif
+    ledger(ledger),
+    player(player),
+    leaderboard(leaderboard),
+    trace(trace),
+    player_agent(player_agent),
+    fair(fair),
+    session((std::uint64_t{std::random_device{}()} << 32) | std::random_device{}()),
+    state(State::Initialising) {
+  if (ledger) {
+    balance = static_cast<int>(ledger->balance(player));
+    if (balance <= 0) {
+      ledger->settle(player, acey_ducey::STARTING_BALANCE - balance);
+      balance = acey_ducey::STARTING_BALANCE;
+    }
+  }
+  if (leaderboard) leaderboard->join(player, balance);
+}
 
 /**
  * @brief Starts the main game loop, handling state transitions.
+ *
+ * An agent, if there is one, is sent the final balance when the game ends.
+ * With a fair deck, the commitment is published and the client seed taken
+ * before the first deal, and the server seeds that prove the rounds dealt
+ * are revealed at the end, to an agent as fields of the final observation.
  */
-void AceyDucey::run() {
+template <class Rules>
+void AceyDucey<Rules>::run() {
   while (state != State::GameOver) {
     switch (state) {
       case State::Initialising:
         print_intro();
         print_instructions();
-        state = State::Playing;
+        state = fair && !bind_client_seed() ? State::GameOver : State::Playing;
         break;
 
       case State::Playing:
@@ -44,12 +104,20 @@ void AceyDucey::run() {
         break;
     }
   }
+  std::vector<std::string> revealed;
+  if (fair && !fair->client_seed().empty()) revealed = print_fair_reveal();
+  if (player_agent) {
+    std::vector<agent_field> fields{{"balance", balance, nullptr}, {"round", round, nullptr}};
+    if (fair) add_revealed(fields, revealed, fair->rounds_dealt());
+    agent_finish(player_agent, fields.data(), static_cast<int>(fields.size()));
+  }
 }
 
 /**
  * @brief Prints the game title and attribution message.
  */
-void AceyDucey::print_intro() {
+template <class Rules>
+void AceyDucey<Rules>::print_intro() {
   std::println("{:^66}", "ACEY DUCEY CARD GAME");
   std::println("{:^66}", "CREATIVE COMPUTING  MORRISTOWN, NEW JERSEY");
 }
@@ -57,13 +125,24 @@ void AceyDucey::print_intro() {
 /**
  * @brief Displays gameplay instructions to the user.
  */
-void AceyDucey::print_instructions() {
+template <class Rules>
+void AceyDucey<Rules>::print_instructions() {
   std::println("");
   std::println("ACEY-DUCEY IS PLAYED IN THE FOLLOWING MANNER");
   std::println("THE DEALER (COMPUTER) DEALS TWO CARDS FACE UP");
   std::println("YOU HAVE AN OPTION TO BET OR NOT BET DEPENDING");
   std::println("ON WHETHER OR NOT YOU FEEL THE CARD WILL HAVE");
   std::println("A VALUE BETWEEN THE FIRST TWO.");
+  if constexpr (Rules::posts::push) {
+    std::println("A CARD MATCHING EITHER OF THE FIRST TWO IS A PUSH.");
+  }
+  if constexpr (Rules::pair::multiplier != 0) {
+    std::println("IF THE FIRST TWO ARE A PAIR, A THIRD OF THAT RANK PAYS {} TO 1.", Rules::pair::multiplier);
+  }
+  if constexpr (Rules::payout::multiplier(1) != 1) {
+    std::println("A GAP OF ONE CARD PAYS {} TO 1, TWO PAY {} TO 1, THREE PAY {} TO 1.",
+                 Rules::payout::multiplier(1), Rules::payout::multiplier(2), Rules::payout::multiplier(3));
+  }
 }
 
 /**
@@ -71,32 +150,102 @@ void AceyDucey::print_instructions() {
  *
  * @return A card rank (e.g., "5", "J", "A")
  */
-std::string_view AceyDucey::deal_card() {
+template <class Rules>
+std::string_view AceyDucey<Rules>::deal_card() {
   std::uniform_int_distribution<size_t> dist(0, deck.size() - 1);
   return deck[dist(rng)];
 }
 
 /**
- * @brief Checks whether a card rank lies strictly between two other ranks.
+ * @brief Returns the next round's three cards from the fair deck.
  *
- * @param a The first card (can be lower or higher)
- * @param b The second card (can be lower or higher)
- * @param test The card to test
- * @return true if test is strictly between a and b; false otherwise
+ * When the committed batch is used up, its seeds are revealed, a new batch
+ * is committed and the player chooses a new client seed for it before
+ * dealing on.
+ *
+ * @return Ranks 2 to 14: the two face-up cards, then the third; null if
+ *         the agent quit instead of choosing a client seed
  */
-bool AceyDucey::is_between(std::string_view a, std::string_view b, std::string_view test) {
-  auto index_of = [](std::string_view value) -> int {
-    auto it = std::ranges::find(CARDS, value);
-    return static_cast<int>(std::distance(CARDS.begin(), it));
-  };
+template <class Rules>
+const std::array<std::uint8_t, 3>* AceyDucey<Rules>::deal_fair() {
+  if (fair->remaining() == 0) {
+    const std::size_t rounds = fair->rounds_dealt();
+    const std::vector<std::string> revealed = print_fair_reveal();
+    fair->renew();
+    if (!bind_client_seed(revealed, rounds)) return nullptr;
+  }
+  return &fair->deal();
+}
 
-  int idx_a = index_of(a);
-  int idx_b = index_of(b);
-  int idx_test = index_of(test);
+/**
+ * @brief Publishes the commitment to the current batch, then takes the
+ * player's client seed for it, so the server seeds are fixed before the
+ * client seed is known.
+ *
+ * An agent sees the commitment, and the seeds revealed for the previous
+ * batch if there was one, as fields, and answers with any non-negative
+ * integer, which becomes the client seed in decimal. With an agent the
+ * commitment and the client seed are also printed to stderr, since the
+ * game's own output is silenced.
+ *
+ * @param revealed Seeds revealed for the previous batch, or empty
+ * @param revealed_rounds Rounds the revealed seeds prove
+ * @return false if the agent quit or the console input ended instead
+ */
+template <class Rules>
+bool AceyDucey<Rules>::bind_client_seed(const std::vector<std::string>& revealed, std::size_t revealed_rounds) {
+  std::FILE* out = player_agent ? stderr : stdout;
+  const std::string commitment = sha256::to_hex(fair->commitment());
+  std::println(out, "{}SERVER SEED COMMITMENT: {}", revealed.empty() ? "" : "NEW ", commitment);
 
-  if (idx_a > idx_b) std::swap(idx_a, idx_b);
+  std::string seed;
+  if (player_agent) {
+    std::vector<agent_field> fields{{"commitment", 0, commitment.c_str()}, {"round", round, nullptr}};
+    add_revealed(fields, revealed, revealed_rounds);
+    const long long answer =
+      agent_choose_int(player_agent, fields.data(), static_cast<int>(fields.size()), 0, LLONG_MAX);
+    if (answer == AGENT_QUIT) return false;
+    seed = std::to_string(answer);
+  } else {
+    while (seed.empty()) {
+      std::print("CLIENT SEED ");
+      if (!std::getline(std::cin, seed)) return false;
+    }
+  }
+  fair->set_client_seed(seed);
+  std::println(out, "CLIENT SEED: {}", fair->client_seed());
+  return true;
+}
 
-  return idx_test > idx_a && idx_test < idx_b;
+/**
+ * @brief Prints the seeds that prove every round dealt from the current
+ * batch, and how to check them; to stderr when an agent is playing.
+ *
+ * @return The seeds, one per lane, in hex
+ */
+template <class Rules>
+std::vector<std::string> AceyDucey<Rules>::print_fair_reveal() {
+  std::vector<std::string> revealed;
+  std::string seeds;
+  for (const sha256::Digest& seed : fair->reveal()) {
+    revealed.push_back(sha256::to_hex(seed));
+    if (!seeds.empty()) seeds += ',';
+    seeds += revealed.back();
+  }
+  std::FILE* out = player_agent ? stderr : stdout;
+  std::println(out, "SERVER SEEDS AFTER {} ROUNDS: {}", fair->rounds_dealt(), seeds);
+  std::println(out, "VERIFY WITH: AceyDuceyFair --commitment {} --client-seed {} --rounds {} --reveal {}",
+               sha256::to_hex(fair->commitment()), fair->client_seed(), fair->rounds_dealt(), seeds);
+  return revealed;
+}
+
+/**
+ * @brief Returns a card's position in CARDS, or -1 if it is not a card.
+ */
+template <class Rules>
+int AceyDucey<Rules>::rank_of(std::string_view card) {
+  auto it = std::ranges::find(CARDS, card);
+  return it != CARDS.end() ? static_cast<int>(std::distance(CARDS.begin(), it)) : -1;
 }
 
 /**
@@ -106,43 +255,59 @@ bool AceyDucey::is_between(std::string_view a, std::string_view b, std::string_v
  * prompts for a bet, evaluates the third card,
  * and updates the balance and game state.
  */
-void AceyDucey::play_turn() {
+template <class Rules>
+void AceyDucey<Rules>::play_turn() {
   if (state == State::Playing) {
     std::println("YOU NOW HAVE ${} DOLLARS", balance);
   }
 
+  const std::array<std::uint8_t, 3>* fair_cards = fair ? deal_fair() : nullptr;
+  if (fair && !fair_cards) {
+    state = State::GameOver;  // no client seed for the new batch
+    return;
+  }
   std::println("HERE ARE YOUR NEXT TWO CARDS:");
-  std::string_view first_pick = deal_card();
-  std::string_view second_pick = deal_card();
+  auto card = [&](int i) { return fair_cards ? CARDS[(*fair_cards)[i] - acey_ducey::LOWEST_CARD] : deal_card(); };
+  std::string_view first_pick = card(0);
+  std::string_view second_pick = card(1);
   print_cards(first_pick, second_pick);
 
-  std::print("WHAT IS YOUR BET ");
-  int bet = get_positive_integer(get_input_line());
+  int bet = get_bet(first_pick, second_pick);
+  if (state == State::GameOver) return;  // the agent quit
 
   if (bet <= 0) {
     std::println("CHICKEN!!");
+    record(first_pick, second_pick, {}, 0, TraceOutcome::Chicken);
     state = State::BetNothing;
     return;
   } else if (bet > balance) {
     std::println("SORRY, MY FRIEND, BUT YOU BET TOO MUCH.");
     std::println("YOU HAVE ONLY {} DOLLARS TO BET.", balance);
+    record(first_pick, second_pick, {}, bet, TraceOutcome::TooMuch);
   } else {
-    std::string_view third_pick = deal_card();
+    std::string_view third_pick = card(2);
     std::println("{}", third_pick);
 
-    if (is_between(first_pick, second_pick, third_pick)) {
+    const acey_ducey::Outcome outcome =
+      Rules::settle(rank_of(first_pick), rank_of(second_pick), rank_of(third_pick), bet);
+    if (outcome.result == acey_ducey::Result::Win) {
       std::println("YOU WIN!!!");
-      balance += bet;
+      if (outcome.delta > bet) std::println("THAT PAYS {} TO 1.", outcome.delta / bet);
+      settle(outcome.delta);
+      record(first_pick, second_pick, third_pick, bet, TraceOutcome::Win);
+    } else if (outcome.result == acey_ducey::Result::Push) {
+      std::println("PUSH. YOUR BET IS RETURNED.");
+      record(first_pick, second_pick, third_pick, bet, TraceOutcome::Push);
     } else {
       std::println("SORRY, YOU LOSE");
-      balance -= bet;
+      settle(outcome.delta);
+      record(first_pick, second_pick, third_pick, bet, TraceOutcome::Lose);
       if (balance <= 0) {
         std::println("SORRY, FRIEND, BUT YOU BLEW YOUR WAD.");
         std::print("TRY AGAIN (YES OR NO)? ");
-        std::string response = get_input_line();
-        if (response == "YES") {
+        if (get_try_again()) {
           state = State::Playing;
-          balance = 100;
+          settle(acey_ducey::STARTING_BALANCE - balance);
         } else {
           state = State::GameOver;
         }
@@ -159,14 +324,10 @@ void AceyDucey::play_turn() {
  * @param a First card
  * @param b Second card
  */
-void AceyDucey::print_cards(std::string_view a, std::string_view b) {
-  auto index_of = [](std::string_view value) -> int {
-    auto it = std::ranges::find(CARDS, value);
-    return it != CARDS.end() ? std::distance(CARDS.begin(), it) : -1;
-  };
-
-  int idx_a = index_of(a);
-  int idx_b = index_of(b);
+template <class Rules>
+void AceyDucey<Rules>::print_cards(std::string_view a, std::string_view b) {
+  int idx_a = rank_of(a);
+  int idx_b = rank_of(b);
 
   if (idx_a == -1 || idx_b == -1) {
     std::cerr << "Error: Invalid card rank(s)." << std::endl;
@@ -188,7 +349,8 @@ void AceyDucey::print_cards(std::string_view a, std::string_view b) {
  *
  * @return Sanitized input string.
  */
-std::string AceyDucey::get_input_line() {
+template <class Rules>
+std::string AceyDucey<Rules>::get_input_line() {
   std::string line;
   std::getline(std::cin, line);
 
@@ -208,18 +370,133 @@ std::string AceyDucey::get_input_line() {
  * @param s Input string
  * @return Parsed integer if valid, -1 otherwise
  */
-int AceyDucey::get_positive_integer(const std::string &s) {
+template <class Rules>
+int AceyDucey<Rules>::get_positive_integer(const std::string &s) {
   if (!s.empty() && std::ranges::all_of(s, ::isdigit)) {
     return std::stoi(s);
   }
   return -1;
 }
 
+/**
+ * @brief Prompts for a bet on the current hand.
+ *
+ * With the RetryBet policy, input that is not a number and bets larger
+ * than the balance are refused and the prompt repeats, as in the JDK 17
+ * port; otherwise the first answer stands. An agent is offered any bet
+ * from 0 to the balance and sees the two cards as ranks 2 to 14; if it
+ * quits, the game is over.
+ *
+ * @param first First card
+ * @param second Second card
+ * @return The bet, or -1 if the input was not a number
+ */
+template <class Rules>
+int AceyDucey<Rules>::get_bet(std::string_view first, std::string_view second) {
+  if (player_agent) {
+    const agent_field fields[] = {
+      {"balance", balance, nullptr},
+      {"first", rank_of(first) + acey_ducey::LOWEST_CARD, nullptr},
+      {"second", rank_of(second) + acey_ducey::LOWEST_CARD, nullptr},
+      {"round", round, nullptr},
+    };
+    const long long bet = agent_choose_int(player_agent, fields, 4, 0, balance);
+    if (bet == AGENT_QUIT) {
+      state = State::GameOver;
+      return 0;
+    }
+    return static_cast<int>(bet);
+  }
+  while (true) {
+    std::print("WHAT IS YOUR BET ");
+    int bet = get_positive_integer(get_input_line());
+    if constexpr (Rules::betting::retry) {
+      if (bet < 0 && std::cin) {
+        std::println("!NUMBER EXPECTED - RETRY INPUT LINE");
+        continue;
+      }
+      if (bet > balance) {
+        std::println("SORRY, MY FRIEND, BUT YOU BET TOO MUCH.");
+        std::println("YOU HAVE ONLY {} DOLLARS TO BET.", balance);
+        continue;
+      }
+    }
+    return bet;
+  }
+}
+
+/**
+ * @brief Asks whether to start over after the balance is gone.
+ *
+ * @return true if the answer was YES
+ */
+template <class Rules>
+bool AceyDucey<Rules>::get_try_again() {
+  if (player_agent) {
+    static constexpr const char* answers[] = {"YES", "NO"};
+    const agent_field fields[] = {{"balance", balance, nullptr}, {"round", round, nullptr}};
+    const char* answer = agent_choose(player_agent, fields, 2, answers, 2);
+    return answer && std::string_view(answer) == "YES";
+  }
+  return get_input_line() == "YES";
+}
+
+/**
+ * @brief Applies a change to the balance, writing it to the ledger first if
+ * there is one and then publishing it to the leaderboard.
+ *
+ * @param delta Signed change in dollars
+ */
+template <class Rules>
+void AceyDucey<Rules>::settle(int delta) {
+  if (ledger) ledger->settle(player, delta);
+  balance += delta;
+  if (leaderboard) leaderboard->publish(balance);
+}
+
+/**
+ * @brief Appends the round just played to the trace, if there is one.
+ *
+ * The append only copies the round into the writer's current block; the
+ * encoding and the write happen on the writer's thread.
+ *
+ * @param first First card
+ * @param second Second card
+ * @param third Third card, empty if it was not dealt
+ * @param bet Bet as entered
+ * @param outcome How the round ended
+ */
+template <class Rules>
+void AceyDucey<Rules>::record(std::string_view first, std::string_view second, std::string_view third, int bet,
+                              TraceOutcome outcome) {
+  ++round;
+  if (!trace) return;
+  auto card = [](std::string_view c) {
+    return static_cast<std::uint8_t>(c.empty() ? 0 : rank_of(c) + acey_ducey::LOWEST_CARD);
+  };
+  trace->append(TraceRound{session, round, card(first), card(second), card(third), outcome, bet, balance});
+}
+
 /**
  * @brief Determines whether the game is over due to lack of funds.
  *
  * @return true if balance is zero or below; false otherwise.
  */
-bool AceyDucey::is_game_over() {
+template <class Rules>
+bool AceyDucey<Rules>::is_game_over() {
   return balance <= 0;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Plays a session under the given rule variant.
+ *
+ * The variant is resolved to its AceyDucey<Rules> instantiation here, once;
+ * this is also what instantiates every variant of the class.
+ */
+void run_game(const acey_ducey::Variant& variant, Ledger* ledger, std::uint64_t player,
+              Leaderboard* leaderboard, TraceWriter* trace, agent* player_agent, FairDeck* fair) {
+  acey_ducey::with_rules(variant, [&]<class Rules>(Rules) {
+    AceyDucey<Rules> game(ledger, player, leaderboard, trace, player_agent, fair);
+    game.run();
+  });
+}
@@ -1,23 +1,45 @@
 #pragma once
 
+#include "AceyDuceyVariants.hpp"
 #include <array>
+#include <cstdint>
 #include <string>
 #include <string_view>
 #include <vector>
 #include <random>
 
+struct agent;
+class FairDeck;
+class Leaderboard;
+class Ledger;
+class TraceWriter;
+enum class TraceOutcome : std::uint8_t;
+
 /**
  * @brief The AceyDucey class encapsulates the core game logic for the Acey Ducey card game.
  *
  * This class manages the player's balance, game state, and game loop, and provides
  * all supporting methods for playing rounds and interacting with the user.
+ *
+ * @tparam Rules An acey_ducey::Rules variant; its policies are resolved at
+ *         compile time, so play_turn never tests a rule flag. Instantiated
+ *         for every variant by run_game().
  */
+template <class Rules = acey_ducey::ClassicRules>
 class AceyDucey {
 public:
   /**
    * @brief Constructs a new AceyDucey game and initializes balance and deck.
+   *
+   * @param ledger Durable ledger to load the balance from and settle into; may be null
+   * @param player Player id within the ledger and on the leaderboard
+   * @param leaderboard Shared leaderboard to publish every settlement to; may be null
+   * @param trace Trace to record every round in; may be null
+   * @param player_agent Agent protocol session to take decisions from instead of the console; may be null
+   * @param fair Provably fair deck to deal from instead of the random engine; may be null
    */
-  AceyDucey();
+  explicit AceyDucey(Ledger* ledger = nullptr, std::uint64_t player = 0, Leaderboard* leaderboard = nullptr,
+                     TraceWriter* trace = nullptr, agent* player_agent = nullptr, FairDeck* fair = nullptr);
 
   /**
    * @brief Starts the main game loop.
@@ -31,6 +53,14 @@ private:
   State state;                              ///< Current game state
   std::vector<std::string_view> deck;       ///< Working deck of card ranks
   std::default_random_engine rng;           ///< Random number generator
+  Ledger* ledger;                           ///< Durable balances, or null to keep them in memory
+  std::uint64_t player;                     ///< Player id within the ledger
+  Leaderboard* leaderboard;                 ///< Cross-process leaderboard, or null
+  TraceWriter* trace;                       ///< Per-round trace, or null
+  agent* player_agent;                      ///< Agent protocol session, or null to play on the console
+  FairDeck* fair;                           ///< Committed deals, or null to draw from rng
+  std::uint64_t session;                    ///< Session id in the trace
+  std::uint32_t round = 0;                  ///< Rounds played this session
 
   static constexpr std::array<std::string_view, 13> CARDS{
     "2", "3", "4", "5", "6", "7", "8", "9", "10", "J", "Q", "K", "A"
@@ -39,10 +69,16 @@ private:
   // Game logic
   void play_turn();
   bool is_game_over();
+  void settle(int delta);
+  void record(std::string_view first, std::string_view second, std::string_view third, int bet,
+              TraceOutcome outcome);
 
   // Card handling
   std::string_view deal_card();
-  static bool is_between(std::string_view a, std::string_view b, std::string_view test);
+  const std::array<std::uint8_t, 3>* deal_fair();
+  bool bind_client_seed(const std::vector<std::string>& revealed = {}, std::size_t revealed_rounds = 0);
+  std::vector<std::string> print_fair_reveal();
+  static int rank_of(std::string_view card);
   void print_cards(std::string_view a, std::string_view b);
 
   // I/O
@@ -50,4 +86,21 @@ private:
   void print_instructions();
   std::string get_input_line();
   int get_positive_integer(const std::string& s);
-};
\ No newline at end of file
+  int get_bet(std::string_view first, std::string_view second);
+  bool get_try_again();
+};
+
+/**
+ * @brief Plays one session with the AceyDucey instantiation for a runtime-selected variant.
+ *
+ * @param variant Rule variant
+ * @param ledger Durable ledger, or null
+ * @param player Player id within the ledger and on the leaderboard
+ * @param leaderboard Shared leaderboard, or null
+ * @param trace Per-round trace, or null
+ * @param player_agent Agent protocol session, or null
+ * @param fair Provably fair deck, or null
+ */
+void run_game(const acey_ducey::Variant& variant, Ledger* ledger = nullptr, std::uint64_t player = 0,
+              Leaderboard* leaderboard = nullptr, TraceWriter* trace = nullptr, agent* player_agent = nullptr,
+              FairDeck* fair = nullptr);
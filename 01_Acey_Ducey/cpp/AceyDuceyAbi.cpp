@@ -0,0 +1,129 @@
+#include "acey_ducey.h"
+#include "AceyDuceyRules.hpp"
+#include <algorithm>
+#include <new>
+#include <random>
+
+/**
+ * @brief State behind the opaque acey_session handle.
+ */
+struct acey_session {
+  std::mt19937_64 rng;
+  std::int32_t balance;
+  std::int32_t first = 0;
+  std::int32_t second = 0;
+  bool open = false;  ///< Two cards dealt and not yet settled
+
+  std::int32_t deal_card() {
+    std::uniform_int_distribution<std::int32_t> dist(acey_ducey::LOWEST_CARD, acey_ducey::HIGHEST_CARD);
+    return dist(rng);
+  }
+};
+
+/**
+ * @brief Returns the version of the loaded library.
+ */
+std::uint32_t acey_abi_version() {
+  return ACEY_ABI_VERSION;
+}
+
+/**
+ * @brief Creates a session.
+ *
+ * @param seed Seed for the session's random stream
+ * @param balance Starting balance; zero or less uses STARTING_BALANCE
+ * @return New session, or null if allocation fails
+ */
+acey_session* acey_session_create(std::uint64_t seed, std::int32_t balance) {
+  return new (std::nothrow) acey_session{std::mt19937_64(seed),
+                                         balance > 0 ? balance : acey_ducey::STARTING_BALANCE};
+}
+
+/**
+ * @brief Destroys a session.
+ */
+void acey_session_destroy(acey_session* session) {
+  delete session;
+}
+
+/**
+ * @brief Returns the session's balance.
+ */
+std::int32_t acey_session_balance(const acey_session* session) {
+  return session ? session->balance : ACEY_E_INVALID;
+}
+
+/**
+ * @brief Deals the two face-up cards of a new hand.
+ *
+ * @param session Session to deal from
+ * @param first Receives the first card
+ * @param second Receives the second card
+ * @return 0, or a negative error code
+ */
+int acey_session_deal(acey_session* session, std::int32_t* first, std::int32_t* second) {
+  if (!session || !first || !second) return ACEY_E_INVALID;
+  if (session->open) return ACEY_E_STATE;
+  session->first = session->deal_card();
+  session->second = session->deal_card();
+  session->open = true;
+  *first = session->first;
+  *second = session->second;
+  return 0;
+}
+
+/**
+ * @brief Bets on the open hand.
+ *
+ * As in the BASIC program, a bet larger than the balance is refused and
+ * the same two cards stay on the table for another bet.
+ *
+ * @param session Session holding the hand
+ * @param bet Amount wagered; 0 declines the hand
+ * @param third Receives the third card if one is dealt; may be null
+ * @return ACEY_CHICKEN, ACEY_WIN, ACEY_LOSE, ACEY_BET_TOO_MUCH or a negative error code
+ */
+int acey_session_settle(acey_session* session, std::int32_t bet, std::int32_t* third) {
+  if (!session || bet < 0) return ACEY_E_INVALID;
+  if (!session->open) return ACEY_E_STATE;
+  if (bet > session->balance) return ACEY_BET_TOO_MUCH;
+
+  session->open = false;
+  if (bet == 0) return ACEY_CHICKEN;
+
+  const std::int32_t card = session->deal_card();
+  if (third) *third = card;
+  const std::int32_t delta = acey_ducey::settle(session->first, session->second, card, bet);
+  session->balance += delta;
+  return delta > 0 ? ACEY_WIN : ACEY_LOSE;
+}
+
+/**
+ * @brief Evaluates many rounds over caller-owned arrays.
+ *
+ * The loop is branch-free so the compiler can vectorise it. delta may be
+ * one of the inputs, since delta[i] depends only on element i of each;
+ * the compiler checks for overlap at run time instead of being promised
+ * there is none.
+ *
+ * @return 0, or ACEY_E_INVALID if any pointer is null while n > 0 or any
+ *         bet is negative, as acey_session_settle refuses one; nothing is
+ *         written then
+ */
+int acey_evaluate_rounds(const std::int32_t* first, const std::int32_t* second, const std::int32_t* third,
+                         const std::int32_t* bet, std::int32_t* delta, std::size_t n) {
+  if (n == 0) return 0;
+  if (!first || !second || !third || !bet || !delta) return ACEY_E_INVALID;
+
+  // A separate pass, so a bad bet leaves delta untouched even when it is bet.
+  std::int32_t lowest = 0;
+  for (std::size_t i = 0; i < n; ++i) lowest = std::min(lowest, bet[i]);
+  if (lowest < 0) return ACEY_E_INVALID;
+
+  for (std::size_t i = 0; i < n; ++i) {
+    const std::int32_t lo = std::min(first[i], second[i]);
+    const std::int32_t hi = std::max(first[i], second[i]);
+    delta[i] = (third[i] > lo && third[i] < hi) ? bet[i] : -bet[i];
+  }
+  return 0;
+}
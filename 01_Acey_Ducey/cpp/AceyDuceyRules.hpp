@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+
+/**
+ * @brief The Acey Ducey rules with no I/O or state, shared by the game and the C ABI.
+ *
+ * Cards are numbered as in the BASIC program: 2 to 10, then 11 to 14 for
+ * J, Q, K and A.
+ */
+namespace acey_ducey {
+
+constexpr int LOWEST_CARD = 2;
+constexpr int HIGHEST_CARD = 14;
+constexpr int STARTING_BALANCE = 100;
+
+/**
+ * @brief Checks whether a card lies strictly between two others, in either order.
+ */
+constexpr bool is_between(int a, int b, int test) {
+  if (a > b) std::swap(a, b);
+  return test > a && test < b;
+}
+
+/**
+ * @brief Change in balance for one round.
+ *
+ * @param first First card dealt
+ * @param second Second card dealt
+ * @param third Card dealt after the bet
+ * @param bet Amount wagered; zero or less means no bet (CHICKEN!!)
+ * @return +bet for a win, -bet for a loss, 0 for no bet
+ */
+constexpr std::int32_t settle(int first, int second, int third, std::int32_t bet) {
+  if (bet <= 0) return 0;
+  return is_between(first, second, third) ? bet : -bet;
+}
+
+}  // namespace acey_ducey
@@ -0,0 +1,50 @@
+#include "AceyDuceyVariants.hpp"
+#include <stdexcept>
+
+namespace acey_ducey {
+
+/**
+ * @brief Parses a comma-separated list of rule names.
+ *
+ * @param names e.g. "posts-push,spread", or "classic" for no changes
+ * @return The variant
+ */
+Variant Variant::parse(std::string_view names) {
+  Variant v;
+  while (!names.empty()) {
+    const std::size_t comma = names.find(',');
+    const std::string_view name = names.substr(0, comma);
+    if (name == "posts-push") {
+      v.posts_push = true;
+    } else if (name == "pair-bonus") {
+      v.pair_bonus = true;
+    } else if (name == "spread") {
+      v.spread_payout = true;
+    } else if (name == "retry") {
+      v.retry_bets = true;
+    } else if (name != "classic") {
+      throw std::invalid_argument("unknown rule variant: " + std::string(name));
+    }
+    names = comma == std::string_view::npos ? std::string_view{} : names.substr(comma + 1);
+  }
+  return v;
+}
+
+/**
+ * @brief Returns the variant in the form parse() accepts.
+ */
+std::string Variant::name() const {
+  std::string result;
+  auto add = [&](bool on, std::string_view rule) {
+    if (!on) return;
+    if (!result.empty()) result += ',';
+    result += rule;
+  };
+  add(posts_push, "posts-push");
+  add(pair_bonus, "pair-bonus");
+  add(spread_payout, "spread");
+  add(retry_bets, "retry");
+  return result.empty() ? "classic" : result;
+}
+
+}  // namespace acey_ducey
@@ -0,0 +1,176 @@
+#pragma once
+
+#include "AceyDuceyRules.hpp"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief House-rule variants of Acey Ducey as compile-time policies.
+ *
+ * A variant is Rules<Posts, Pair, Payout, Betting>. Each policy is a type
+ * whose members are constants, so every instantiation compiles to code
+ * with the rule choices folded away. A Variant holds the same choices as
+ * runtime flags; with_rules() turns it into the matching instantiation
+ * once, and settle_runtime() is the branch-on-flags equivalent used as a
+ * benchmark baseline.
+ */
+namespace acey_ducey {
+
+/**
+ * @brief How a round ended.
+ */
+enum class Result { Win, Lose, Push };
+
+struct Outcome {
+  Result result;
+  std::int32_t delta;  ///< Change in balance
+};
+
+// Third card equal to a post
+struct PostsLose { static constexpr bool push = false; };  ///< Not strictly between: lose (original)
+struct PostsPush { static constexpr bool push = true; };   ///< Stake returned
+
+// Two posts of the same rank
+struct PairPlain { static constexpr int multiplier = 0; };  ///< Nothing can be between: lose (original)
+struct PairBonus { static constexpr int multiplier = 11; }; ///< Third card of the rank pays 11 to 1
+
+// Winning payout
+struct EvenMoney {
+  static constexpr int multiplier(int) { return 1; }
+};
+struct SpreadPayout {  ///< In Between: narrower spreads pay more
+  static constexpr int multiplier(int spread) {
+    return spread == 1 ? 5 : spread == 2 ? 4 : spread == 3 ? 2 : 1;
+  }
+};
+
+// Bet entry
+struct SingleBet { static constexpr bool retry = false; };  ///< One try per hand, as in this port
+struct RetryBet { static constexpr bool retry = true; };    ///< Re-prompt bad or excessive bets (AceyDucey17.java)
+
+/**
+ * @brief One rule variant.
+ */
+template <class Posts, class Pair, class Payout, class Betting>
+struct Rules {
+  using posts = Posts;
+  using pair = Pair;
+  using payout = Payout;
+  using betting = Betting;
+
+  /**
+   * @brief Settles one round.
+   *
+   * With the original payouts, whatever the betting policy, this is
+   * acey_ducey::settle, so the classic game has one definition of a round.
+   *
+   * @param first First card dealt
+   * @param second Second card dealt
+   * @param third Card dealt after the bet
+   * @param bet Stake, greater than zero
+   */
+  static constexpr Outcome settle(int first, int second, int third, std::int32_t bet) {
+    if constexpr (!Posts::push && Pair::multiplier == 0 && std::is_same_v<Payout, EvenMoney>) {
+      const std::int32_t delta = acey_ducey::settle(first, second, third, bet);
+      return Outcome{delta > 0 ? Result::Win : Result::Lose, delta};
+    }
+    if (first > second) std::swap(first, second);
+    if constexpr (Pair::multiplier != 0) {
+      if (first == second) {
+        return third == first ? Outcome{Result::Win, bet * Pair::multiplier} : Outcome{Result::Lose, -bet};
+      }
+    }
+    if constexpr (Posts::push) {
+      if (third == first || third == second) return Outcome{Result::Push, 0};
+    }
+    if (third > first && third < second) {
+      return Outcome{Result::Win, bet * Payout::multiplier(second - first - 1)};
+    }
+    return Outcome{Result::Lose, -bet};
+  }
+};
+
+/**
+ * @brief The rules as the BASIC program plays them.
+ */
+using ClassicRules = Rules<PostsLose, PairPlain, EvenMoney, SingleBet>;
+
+/**
+ * @brief A variant chosen at run time.
+ */
+struct Variant {
+  bool posts_push = false;
+  bool pair_bonus = false;
+  bool spread_payout = false;
+  bool retry_bets = false;
+
+  static constexpr int COUNT = 16;
+
+  /**
+   * @brief Variant number i of COUNT, one bit per flag.
+   */
+  static constexpr Variant from_index(int i) {
+    return Variant{(i & 1) != 0, (i & 2) != 0, (i & 4) != 0, (i & 8) != 0};
+  }
+
+  /**
+   * @brief Parses a comma-separated list of posts-push, pair-bonus, spread and retry, or "classic".
+   *
+   * @throws std::invalid_argument for an unknown name
+   */
+  static Variant parse(std::string_view names);
+
+  std::string name() const;
+};
+
+namespace detail {
+
+template <class... Chosen, class F>
+decltype(auto) select(const Variant& v, F&& f) {
+  constexpr std::size_t n = sizeof...(Chosen);
+  if constexpr (n == 0) {
+    return v.posts_push ? select<PostsPush>(v, f) : select<PostsLose>(v, f);
+  } else if constexpr (n == 1) {
+    return v.pair_bonus ? select<Chosen..., PairBonus>(v, f) : select<Chosen..., PairPlain>(v, f);
+  } else if constexpr (n == 2) {
+    return v.spread_payout ? select<Chosen..., SpreadPayout>(v, f) : select<Chosen..., EvenMoney>(v, f);
+  } else if constexpr (n == 3) {
+    return v.retry_bets ? select<Chosen..., RetryBet>(v, f) : select<Chosen..., SingleBet>(v, f);
+  } else {
+    return f(Rules<Chosen...>{});
+  }
+}
+
+}  // namespace detail
+
+/**
+ * @brief Calls f(Rules<...>{}) with the instantiation matching v.
+ *
+ * Every instantiation of f is compiled; the flags are tested once here
+ * rather than in every round.
+ */
+template <class F>
+decltype(auto) with_rules(const Variant& v, F&& f) {
+  return detail::select<>(v, std::forward<F>(f));
+}
+
+/**
+ * @brief Settles one round by testing the variant's flags, for comparison with Rules::settle.
+ */
+constexpr Outcome settle_runtime(const Variant& v, int first, int second, int third, std::int32_t bet) {
+  if (first > second) std::swap(first, second);
+  if (v.pair_bonus && first == second) {
+    return third == first ? Outcome{Result::Win, bet * PairBonus::multiplier} : Outcome{Result::Lose, -bet};
+  }
+  if (v.posts_push && (third == first || third == second)) return Outcome{Result::Push, 0};
+  if (third > first && third < second) {
+    const int spread = second - first - 1;
+    return Outcome{Result::Win, bet * (v.spread_payout ? SpreadPayout::multiplier(spread) : 1)};
+  }
+  return Outcome{Result::Lose, -bet};
+}
+
+}  // namespace acey_ducey
@@ -0,0 +1,175 @@
+#include "Bankroll.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+unsigned worker_count(unsigned threads) {
+  return threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+}
+
+constexpr std::int64_t MIN_SLICE = 16384;  ///< Balances per thread below which threading does not pay
+
+}  // namespace
+
+/**
+ * @brief Builds the per-round kernel and starts every player on the same balance.
+ *
+ * Every one of the 13^3 deals is settled for a one-dollar bet with the
+ * variant's Rules::settle, which for the classic rules is is_between's
+ * win-or-lose. Deals the policy would not bet on, and pushes, leave the
+ * balance where it is.
+ *
+ * @param variant Rules the rounds are settled under
+ * @param policy Betting policy
+ * @param start Starting balance, also the balance after a restart
+ * @param threads Worker threads, 0 for one per hardware thread
+ */
+Bankroll::Bankroll(acey_ducey::Variant variant, Policy policy, int start, unsigned threads)
+  : policy(policy), start(start), threads(worker_count(threads)) {
+  if (policy.stake < 1) throw std::invalid_argument("stake must be at least 1");
+  if (start < 1) throw std::invalid_argument("starting balance must be at least 1");
+
+  constexpr int ranks = acey_ducey::HIGHEST_CARD - acey_ducey::LOWEST_CARD + 1;
+  constexpr double p_deal = 1.0 / (ranks * ranks * ranks);
+  std::map<std::int32_t, double> by_multiplier;
+  acey_ducey::with_rules(variant, [&]<class Rules>(Rules) {
+    for (int a = acey_ducey::LOWEST_CARD; a <= acey_ducey::HIGHEST_CARD; ++a) {
+      for (int b = acey_ducey::LOWEST_CARD; b <= acey_ducey::HIGHEST_CARD; ++b) {
+        const int gap = std::max(0, std::abs(a - b) - 1);
+        for (int c = acey_ducey::LOWEST_CARD; c <= acey_ducey::HIGHEST_CARD; ++c) {
+          const std::int32_t m = gap >= policy.min_gap ? Rules::settle(a, b, c, 1).delta : 0;
+          if (m == 0) {
+            stay += p_deal;
+          } else {
+            by_multiplier[m] += p_deal;
+          }
+        }
+      }
+    }
+  });
+  for (const auto& [m, p] : by_multiplier) kernel.push_back(Outcome{m, p});
+  if (!kernel.empty()) {
+    lowest = kernel.front().multiplier;
+    highest = kernel.back().multiplier;
+  }
+
+  playing.assign(static_cast<std::size_t>(start) + 1, 0.0);
+  playing[start] = 1.0;
+  unbusted = playing;
+  playing_range = unbusted_range = Range{start, start + 1};
+}
+
+/**
+ * @brief Computes one round of the kernel applied to a distribution.
+ *
+ * Balances at or above the stake all bet the stake, so each new balance y
+ * gathers from y - m * stake for every multiplier m; slices of y are
+ * independent and go to separate threads. Balances below the stake bet
+ * everything and are few, so they are scattered afterwards on this thread.
+ *
+ * @param from Distribution before the round
+ * @param occupied Range of from that may be non-zero
+ * @param to Receives the distribution after the round
+ * @return Range of to that may be non-zero
+ */
+Bankroll::Range Bankroll::propagate(const std::vector<double>& from, Range occupied, std::vector<double>& to) const {
+  const std::int64_t s = policy.stake;
+  const Range next{std::max<std::int64_t>(0, occupied.lo + std::min(0, lowest) * s),
+                   occupied.hi + std::max(0, highest) * s};
+  if (to.size() < static_cast<std::size_t>(next.hi)) to.resize(static_cast<std::size_t>(next.hi), 0.0);
+  if (occupied.lo == occupied.hi) return Range{0, 0};
+
+  auto gather = [&](std::int64_t begin, std::int64_t end) {
+    for (std::int64_t y = begin; y < end; ++y) {
+      double p = y >= occupied.lo && y < occupied.hi ? stay * from[y] : 0.0;
+      for (const Outcome& o : kernel) {
+        const std::int64_t x = y - o.multiplier * s;
+        if (x >= s && x >= occupied.lo && x < occupied.hi) p += o.probability * from[x];
+      }
+      to[y] = p;
+    }
+  };
+
+  const std::int64_t span = next.hi - next.lo;
+  const auto n = static_cast<unsigned>(std::clamp<std::int64_t>(span / MIN_SLICE, 1, threads));
+  if (n == 1) {
+    gather(next.lo, next.hi);
+  } else {
+    std::vector<std::jthread> workers;
+    for (unsigned t = 0; t < n; ++t) {
+      workers.emplace_back(gather, next.lo + span * t / n, next.lo + span * (t + 1) / n);
+    }
+  }
+
+  for (std::int64_t x = std::max<std::int64_t>(1, occupied.lo); x < std::min(s, occupied.hi); ++x) {
+    for (const Outcome& o : kernel) to[x + o.multiplier * x] += o.probability * from[x];
+  }
+  return next;
+}
+
+/**
+ * @brief Advances the distributions by one round.
+ *
+ * A bust in the game as played becomes a restart at the starting balance;
+ * in the first-bust distribution it is removed and added to the ruin
+ * probability.
+ */
+void Bankroll::step() {
+  Range next = propagate(playing, playing_range, playing_next);
+  double restarted = 0;
+  if (next.lo == 0 && next.hi > 0) std::swap(restarted, playing_next[0]);
+  expected_restarts += restarted;
+  // Entries outside the range are stale, so clear any the restart balance brings in.
+  for (std::int64_t b = start; b < next.lo; ++b) playing_next[b] = 0;
+  for (std::int64_t b = next.hi; b <= start; ++b) playing_next[b] = 0;
+  next = Range{std::min<std::int64_t>(next.lo, start), std::max<std::int64_t>(next.hi, start + 1)};
+  playing_next[start] += restarted;
+  playing_range = trim(playing_next, next);
+  std::swap(playing, playing_next);
+
+  next = propagate(unbusted, unbusted_range, unbusted_next);
+  if (next.lo == 0 && next.hi > 0) {
+    ruin += unbusted_next[0];
+    unbusted_next[0] = 0;
+  }
+  unbusted_range = trim(unbusted_next, next);
+  std::swap(unbusted, unbusted_next);
+  ++round;
+}
+
+/**
+ * @brief Narrows a range past any exact zeros at either end.
+ */
+Bankroll::Range Bankroll::trim(const std::vector<double>& p, Range occupied) {
+  while (occupied.hi > occupied.lo && p[occupied.hi - 1] == 0) --occupied.hi;
+  while (occupied.lo < occupied.hi && p[occupied.lo] == 0) ++occupied.lo;
+  return occupied;
+}
+
+/**
+ * @brief Smallest balance b with P(balance <= b) >= q, restarts included.
+ */
+std::int64_t Bankroll::quantile(double q) const {
+  double cumulative = 0;
+  for (std::int64_t b = playing_range.lo; b < playing_range.hi; ++b) {
+    cumulative += playing[b];
+    if (cumulative >= q) return b;
+  }
+  return playing_range.hi - 1;
+}
+
+double Bankroll::mean() const {
+  double sum = 0;
+  for (std::int64_t b = playing_range.lo; b < playing_range.hi; ++b) sum += static_cast<double>(b) * playing[b];
+  return sum;
+}
+
+double Bankroll::mass() const {
+  double sum = 0;
+  for (std::int64_t b = playing_range.lo; b < playing_range.hi; ++b) sum += playing[b];
+  return sum;
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "AceyDuceyVariants.hpp"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/**
+ * @brief Exact distribution of a player's balance round by round under a fixed betting policy.
+ *
+ * Cards are dealt with replacement, so every round has the same 13^3
+ * equally likely deals, and a policy that looks only at the posts and the
+ * balance turns each balance into a handful of successors with known
+ * probabilities. The distribution after k rounds is found by pushing a
+ * probability vector over balances through that kernel k times: no
+ * sampling, so tail probabilities such as busting within 50 rounds are
+ * exact up to floating-point rounding.
+ *
+ * Two vectors are carried. One follows the game as played, where a player
+ * who blows their wad answers YES to TRY AGAIN and restarts at the starting
+ * balance; its quantiles describe the bankroll. The other drops a player
+ * the first time they bust; the mass it loses each round is the ruin curve.
+ *
+ * Each round only the occupied balance range is propagated, split across
+ * worker threads that each compute a disjoint slice of the new vector.
+ * Tail probabilities that underflow to exactly zero are trimmed from the
+ * range, so it stays close to the balances that can actually be reached.
+ */
+class Bankroll {
+public:
+  /**
+   * @brief A fixed policy: bet the stake, or everything if less, whenever
+   * at least min_gap ranks lie strictly between the posts.
+   */
+  struct Policy {
+    int stake = 10;
+    int min_gap = 1;
+  };
+
+  /**
+   * @brief Builds the per-round kernel and starts every player on the same balance.
+   *
+   * @param variant Rules the rounds are settled under
+   * @param policy Betting policy
+   * @param start Starting balance, also the balance after a restart
+   * @param threads Worker threads, 0 for one per hardware thread
+   * @throws std::invalid_argument for a stake or start below 1
+   */
+  Bankroll(acey_ducey::Variant variant, Policy policy, int start = acey_ducey::STARTING_BALANCE,
+           unsigned threads = 0);
+
+  /**
+   * @brief Advances the distributions by one round.
+   */
+  void step();
+
+  unsigned rounds() const { return round; }
+
+  /**
+   * @brief Probability of having busted at least once so far.
+   */
+  double ruined() const { return ruin; }
+
+  /**
+   * @brief Expected number of restarts so far.
+   */
+  double restarts() const { return expected_restarts; }
+
+  /**
+   * @brief Smallest balance b with P(balance <= b) >= q, restarts included.
+   */
+  std::int64_t quantile(double q) const;
+
+  double mean() const;
+
+  /**
+   * @brief Total probability held, which differs from 1 only by rounding.
+   */
+  double mass() const;
+
+  /**
+   * @brief Probability of each balance from 0 upward, restarts included.
+   */
+  std::span<const double> distribution() const { return playing; }
+
+  /**
+   * @brief Probability of betting and of each per-dollar result of a bet, from the kernel.
+   */
+  struct Outcome {
+    std::int32_t multiplier;
+    double probability;
+  };
+  std::span<const Outcome> outcomes() const { return kernel; }
+  double no_bet_probability() const { return stay; }
+
+private:
+  struct Range {
+    std::int64_t lo;
+    std::int64_t hi;  ///< One past the last occupied balance
+  };
+
+  Range propagate(const std::vector<double>& from, Range occupied, std::vector<double>& to) const;
+  static Range trim(const std::vector<double>& p, Range occupied);
+
+  Policy policy;
+  int start;
+  unsigned threads;
+  std::vector<Outcome> kernel;  ///< Results of a placed bet, pushes excluded
+  double stay = 0;              ///< No bet placed, or a push
+  std::int32_t lowest = 0;      ///< Smallest multiplier in the kernel
+  std::int32_t highest = 0;     ///< Largest multiplier in the kernel
+
+  std::vector<double> playing, playing_next;
+  std::vector<double> unbusted, unbusted_next;
+  Range playing_range{0, 0};
+  Range unbusted_range{0, 0};
+  unsigned round = 0;
+  double ruin = 0;
+  double expected_restarts = 0;
+};
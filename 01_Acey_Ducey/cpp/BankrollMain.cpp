@@ -0,0 +1,121 @@
+#include "Bankroll.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <print>
+#include <random>
+#include <string>
+#include <string_view>
+
+namespace {
+
+/**
+ * @brief Monte Carlo estimate of the ruin probability, to check the exact figure against.
+ *
+ * @return Fraction of sessions that busted within the given rounds
+ */
+double sample_ruin(const acey_ducey::Variant& variant, Bankroll::Policy policy, int start, unsigned rounds,
+                   std::uint64_t sessions, std::uint64_t seed) {
+  return acey_ducey::with_rules(variant, [&]<class Rules>(Rules) {
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<int> card(acey_ducey::LOWEST_CARD, acey_ducey::HIGHEST_CARD);
+    std::uint64_t busted = 0;
+    for (std::uint64_t s = 0; s < sessions; ++s) {
+      std::int64_t balance = start;
+      for (unsigned r = 0; r < rounds && balance > 0; ++r) {
+        const int a = card(rng), b = card(rng), c = card(rng);
+        if (std::max(0, std::abs(a - b) - 1) < policy.min_gap) continue;
+        const auto bet = static_cast<std::int32_t>(std::min<std::int64_t>(policy.stake, balance));
+        balance += Rules::settle(a, b, c, bet).delta;
+      }
+      busted += balance <= 0;
+    }
+    return static_cast<double>(busted) / static_cast<double>(sessions);
+  });
+}
+
+}  // namespace
+
+/**
+ * @brief Entry point for the exact bankroll calculator.
+ *
+ * Prints the ruin curve (probability of having busted at least once) and
+ * the quantiles of the balance, with restarts, every --every rounds. With
+ * --check the final ruin probability is compared against that many
+ * simulated sessions.
+ *
+ * Usage: AceyDuceyBankroll [--rounds N] [--stake N] [--min-gap N] [--start N]
+ *                          [--variant LIST] [--threads N] [--every N] [--check N]
+ */
+int main(int argc, char* argv[]) {
+  unsigned rounds = 200;
+  unsigned every = 10;
+  Bankroll::Policy policy;
+  int start = acey_ducey::STARTING_BALANCE;
+  std::string_view variant_names = "classic";
+  unsigned threads = 0;
+  std::uint64_t check = 0;
+
+  for (int i = 1; i + 1 < argc; i += 2) {
+    std::string_view flag = argv[i];
+    if (flag == "--rounds") {
+      rounds = static_cast<unsigned>(std::stoul(argv[i + 1]));
+    } else if (flag == "--stake") {
+      policy.stake = std::stoi(argv[i + 1]);
+    } else if (flag == "--min-gap") {
+      policy.min_gap = std::stoi(argv[i + 1]);
+    } else if (flag == "--start") {
+      start = std::stoi(argv[i + 1]);
+    } else if (flag == "--variant") {
+      variant_names = argv[i + 1];
+    } else if (flag == "--threads") {
+      threads = static_cast<unsigned>(std::stoul(argv[i + 1]));
+    } else if (flag == "--every") {
+      every = std::max(1u, static_cast<unsigned>(std::stoul(argv[i + 1])));
+    } else if (flag == "--check") {
+      check = std::stoull(argv[i + 1]);
+    } else {
+      std::println(stderr, "Usage: AceyDuceyBankroll [--rounds N] [--stake N] [--min-gap N] [--start N] "
+                           "[--variant LIST] [--threads N] [--every N] [--check N]");
+      return EXIT_FAILURE;
+    }
+  }
+
+  try {
+    const acey_ducey::Variant variant = acey_ducey::Variant::parse(variant_names);
+    Bankroll model(variant, policy, start, threads);
+
+    std::println("RULES: {}  STAKE: {}  MIN GAP: {}  START: {}", variant.name(), policy.stake, policy.min_gap, start);
+    std::println("NO BET OR PUSH: {:.6f}", model.no_bet_probability());
+    for (const Bankroll::Outcome& o : model.outcomes()) {
+      std::println("  {:+} PER DOLLAR: {:.6f}", o.multiplier, o.probability);
+    }
+    std::println("{:>6}  {:>12}  {:>10}  {:>10}  {:>6}  {:>6}  {:>6}  {:>6}  {:>6}", "ROUND", "P(RUINED)", "RESTARTS",
+                 "MEAN", "1%", "5%", "50%", "95%", "99%");
+
+    auto start_time = std::chrono::steady_clock::now();
+    for (unsigned r = 1; r <= rounds; ++r) {
+      model.step();
+      if (r % every == 0 || r == rounds) {
+        std::println("{:>6}  {:>12.8f}  {:>10.4f}  {:>10.2f}  {:>6}  {:>6}  {:>6}  {:>6}  {:>6}", r, model.ruined(),
+                     model.restarts(), model.mean(), model.quantile(0.01), model.quantile(0.05),
+                     model.quantile(0.5), model.quantile(0.95), model.quantile(0.99));
+      }
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    std::println("SUPPORT: {} BALANCES  MASS ERROR: {:.2e}  TIME: {:.3f}s", model.distribution().size(),
+                 std::abs(model.mass() - 1.0), seconds);
+
+    if (check) {
+      const double sampled = sample_ruin(variant, policy, start, rounds, check, 1);
+      const double error = std::sqrt(model.ruined() * (1 - model.ruined()) / static_cast<double>(check));
+      std::println("SAMPLED RUIN OVER {} SESSIONS: {:.6f}  EXACT: {:.6f}  ({:.1f} STANDARD ERRORS)", check, sampled,
+                   model.ruined(), error > 0 ? std::abs(sampled - model.ruined()) / error : 0.0);
+    }
+  } catch (const std::exception& e) {
+    std::println(stderr, "Error: {}", e.what());
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,156 @@
+#include "FairDeck.hpp"
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+
+static_assert(sizeof(sha256::Digest) == 32, "digests must pack back to back for the multi-buffer hash");
+
+namespace {
+
+constexpr std::size_t ROUND_MESSAGE = 32 + 32 + 8;  ///< Server seed, client digest, round
+constexpr int ACCEPTED_BELOW = 13 * 19;             ///< 247: bytes from here up would bias the ranks
+
+/**
+ * @brief Takes cards from a digest's bytes, rehashing until three are found.
+ */
+FairDeck::Cards cards_from(sha256::Digest digest) {
+  FairDeck::Cards cards{};
+  std::size_t found = 0;
+  while (true) {
+    for (std::uint8_t byte : digest) {
+      if (byte >= ACCEPTED_BELOW) continue;
+      cards[found++] = static_cast<std::uint8_t>(2 + byte % 13);
+      if (found == cards.size()) return cards;
+    }
+    digest = sha256::hash(digest);
+  }
+}
+
+void round_message(std::uint8_t* out, const sha256::Digest& server_seed, const sha256::Digest& client_digest,
+                   std::uint64_t round) {
+  std::memcpy(out, server_seed.data(), 32);
+  std::memcpy(out + 32, client_digest.data(), 32);
+  for (int k = 0; k < 8; ++k) out[64 + k] = static_cast<std::uint8_t>(round >> (56 - 8 * k));
+}
+
+}  // namespace
+
+namespace fair {
+
+sha256::Digest commit(const FairDeck::Seeds& heads) {
+  return sha256::hash(std::span(heads.front().data(), heads.size() * sizeof(sha256::Digest)));
+}
+
+FairDeck::Cards derive(const sha256::Digest& server_seed, const sha256::Digest& client_digest, std::uint64_t round) {
+  std::uint8_t message[ROUND_MESSAGE];
+  round_message(message, server_seed, client_digest, round);
+  return cards_from(sha256::hash(message));
+}
+
+/**
+ * @brief Builds every round's message, hashes them LANES at a time and takes the cards.
+ */
+std::vector<FairDeck::Cards> derive_all(const std::vector<sha256::Digest>& seeds, std::string_view client_seed) {
+  const sha256::Digest client_digest = sha256::hash(client_seed);
+  std::vector<std::uint8_t> messages(seeds.size() * ROUND_MESSAGE);
+  for (std::size_t i = 0; i < seeds.size(); ++i) {
+    round_message(messages.data() + i * ROUND_MESSAGE, seeds[i], client_digest, i + 1);
+  }
+  std::vector<sha256::Digest> digests(seeds.size());
+  sha256::hash_many(messages.data(), ROUND_MESSAGE, seeds.size(), digests.data());
+
+  std::vector<FairDeck::Cards> cards(seeds.size());
+  std::ranges::transform(digests, cards.begin(), cards_from);
+  return cards;
+}
+
+/**
+ * @brief Hashes every lane back to its head, one multi-buffer step per depth.
+ *
+ * Lanes that have been used less stop a step earlier; their seeds are
+ * still hashed with the others but the result is discarded.
+ */
+std::optional<std::vector<FairDeck::Cards>> verify(const sha256::Digest& commitment, std::string_view client_seed,
+                                                   const FairDeck::Seeds& revealed, std::size_t rounds) {
+  constexpr std::size_t LANES = FairDeck::LANES;
+  std::array<std::size_t, LANES> used;
+  for (std::size_t l = 0; l < LANES; ++l) used[l] = rounds / LANES + (l < rounds % LANES);
+
+  std::vector<sha256::Digest> seeds(rounds);
+  FairDeck::Seeds current = revealed, previous;
+  for (std::size_t k = used[0]; k > 0; --k) {
+    for (std::size_t l = 0; l < LANES; ++l) {
+      if (used[l] >= k) seeds[(k - 1) * LANES + l] = current[l];
+    }
+    sha256::hash_many(current.front().data(), sizeof(sha256::Digest), LANES, previous.data());
+    for (std::size_t l = 0; l < LANES; ++l) {
+      if (used[l] >= k) current[l] = previous[l];
+    }
+  }
+  if (commit(current) != commitment) return std::nullopt;
+  return derive_all(seeds, client_seed);
+}
+
+}  // namespace fair
+
+FairDeck::FairDeck(std::size_t rounds, std::optional<Seeds> terminal)
+  : depth(std::max<std::size_t>(1, (rounds + LANES - 1) / LANES)) {
+  build(terminal);
+}
+
+/**
+ * @brief Hashes the lanes from the terminal seeds down to their heads, all
+ * LANES in each multi-buffer step, and commits to the heads.
+ */
+void FairDeck::build(const std::optional<Seeds>& terminal) {
+  chain.resize((depth + 1) * LANES);
+  if (terminal) {
+    std::ranges::copy(*terminal, chain.begin() + depth * LANES);
+  } else {
+    std::random_device device;
+    for (std::size_t l = 0; l < LANES; ++l) {
+      sha256::Digest& seed = chain[depth * LANES + l];
+      for (std::size_t i = 0; i < seed.size(); i += 4) {
+        const std::uint32_t word = device();
+        std::memcpy(seed.data() + i, &word, 4);
+      }
+    }
+  }
+  for (std::size_t k = depth; k > 0; --k) {
+    sha256::hash_many(chain[k * LANES].data(), sizeof(sha256::Digest), LANES, &chain[(k - 1) * LANES]);
+  }
+  Seeds heads;
+  std::copy_n(chain.begin(), LANES, heads.begin());
+  committed = fair::commit(heads);
+}
+
+/**
+ * @brief Round r's seed is chain[LANES + r - 1], so the rounds' seeds are the chain below the heads.
+ */
+void FairDeck::set_client_seed(std::string_view seed) {
+  client = seed;
+  deals = fair::derive_all(std::vector<sha256::Digest>(chain.begin() + LANES, chain.end()), client);
+  dealt = 0;
+}
+
+FairDeck::Seeds FairDeck::reveal() const {
+  Seeds seeds;
+  for (std::size_t l = 0; l < LANES; ++l) {
+    const std::size_t used = dealt / LANES + (l < dealt % LANES);
+    seeds[l] = chain[used * LANES + l];
+  }
+  return seeds;
+}
+
+void FairDeck::renew() {
+  build(std::nullopt);
+  client.clear();
+  deals.clear();
+  dealt = 0;
+}
+
+void FairDeck::exhausted() const {
+  if (deals.empty()) throw std::logic_error("no client seed has been set");
+  throw std::logic_error("the committed batch of " + std::to_string(deals.size()) + " rounds is used up");
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "Sha256.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Provably fair deals: every round's three cards follow from a
+ * server seed committed before play and a seed chosen by the player.
+ *
+ * The server seeds form LANES interleaved SHA-256 hash chains. Each lane
+ * starts from a secret random seed s[n] and is hashed down, s[k-1] =
+ * SHA-256(s[k]), to its head s[0]; the commitment, published before the
+ * player picks a client seed, is SHA-256 of the eight heads. Round r
+ * (counting from 1) uses lane (r-1) % LANES at depth (r-1) / LANES + 1, so
+ * the seeds of a lane are used in the reverse of the order they were made.
+ * Revealing the last seed used in each lane therefore proves every earlier
+ * round, by hashing back to the commitment, and reveals nothing about the
+ * rounds still to come.
+ *
+ * A round's cards are the first three bytes below 247 of SHA-256(server
+ * seed || SHA-256(client seed) || round as 8 big-endian bytes), each taken
+ * mod 13 as ranks 2 to 14; if a digest runs out, it is hashed again.
+ *
+ * Interleaving the lanes lets a whole batch of chains be hashed with the
+ * multi-buffer SHA-256, and the cards of every round in the batch are
+ * derived as soon as the client seed is known, so dealing is an array read.
+ */
+class FairDeck {
+public:
+  static constexpr std::size_t LANES = sha256::LANES;
+  static constexpr std::size_t DEFAULT_ROUNDS = 65536;  ///< Rounds per committed batch
+
+  using Cards = std::array<std::uint8_t, 3>;  ///< Ranks 2 to 14: the two face-up cards, then the third
+  using Seeds = std::array<sha256::Digest, LANES>;
+
+  /**
+   * @brief Draws secret seeds and commits to a batch of rounds.
+   *
+   * @param rounds Rounds in a batch, rounded up to a multiple of LANES
+   * @param terminal Seeds to hash down from; random when not given
+   */
+  explicit FairDeck(std::size_t rounds = DEFAULT_ROUNDS, std::optional<Seeds> terminal = std::nullopt);
+
+  /**
+   * @brief Commitment to the current batch, to publish before the client seed is chosen.
+   */
+  const sha256::Digest& commitment() const { return committed; }
+
+  /**
+   * @brief Binds the player's seed and derives every round of the batch.
+   */
+  void set_client_seed(std::string_view seed);
+
+  const std::string& client_seed() const { return client; }
+
+  /**
+   * @brief Cards for the next round; set_client_seed() must have been called.
+   *
+   * @throws std::logic_error when the batch is used up; see renew()
+   */
+  const Cards& deal() {
+    if (dealt == deals.size()) exhausted();
+    return deals[dealt++];
+  }
+
+  std::size_t rounds_dealt() const { return dealt; }
+  std::size_t remaining() const { return deals.size() - dealt; }
+
+  /**
+   * @brief Server seeds that prove the rounds dealt so far: per lane, the
+   * last one used, or the lane's head if it has not been used.
+   */
+  Seeds reveal() const;
+
+  /**
+   * @brief Commits to a new batch with fresh secret seeds and forgets the
+   * client seed: the new commitment must be published and a new client
+   * seed set before dealing on, or the seed could be chosen against it.
+   */
+  void renew();
+
+private:
+  [[noreturn]] void exhausted() const;
+  void build(const std::optional<Seeds>& terminal);
+
+  std::size_t depth;                   ///< Seeds per lane below the head
+  std::vector<sha256::Digest> chain;   ///< chain[k * LANES + lane] is s[k] of the lane
+  sha256::Digest committed{};
+  std::string client;
+  std::vector<Cards> deals;
+  std::size_t dealt = 0;
+};
+
+namespace fair {
+
+/**
+ * @brief SHA-256 of the lane heads, in lane order.
+ */
+sha256::Digest commit(const FairDeck::Seeds& heads);
+
+/**
+ * @brief Cards for one round from its server seed.
+ *
+ * @param server_seed Seed of the round's lane at the round's depth
+ * @param client_digest SHA-256 of the client seed
+ * @param round Round within the batch, from 1
+ */
+FairDeck::Cards derive(const sha256::Digest& server_seed, const sha256::Digest& client_digest, std::uint64_t round);
+
+/**
+ * @brief Cards for rounds 1 to seeds.size(), seeds[r-1] being round r's server seed, hashed LANES at a time.
+ */
+std::vector<FairDeck::Cards> derive_all(const std::vector<sha256::Digest>& seeds, std::string_view client_seed);
+
+/**
+ * @brief Checks revealed seeds against a commitment and recomputes the deals.
+ *
+ * @param commitment Published commitment
+ * @param client_seed The player's seed
+ * @param revealed Seeds from FairDeck::reveal() after rounds rounds
+ * @param rounds Rounds dealt
+ * @return Every round's cards, or empty if the seeds do not hash to the commitment
+ */
+std::optional<std::vector<FairDeck::Cards>> verify(const sha256::Digest& commitment, std::string_view client_seed,
+                                                   const FairDeck::Seeds& revealed, std::size_t rounds);
+
+}  // namespace fair
@@ -0,0 +1,146 @@
+#include "FairDeck.hpp"
+#include "Sha256.hpp"
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <optional>
+#include <print>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+constexpr std::array<std::string_view, 13> CARDS{"2", "3", "4", "5", "6", "7", "8", "9", "10", "J", "Q", "K", "A"};
+
+/**
+ * @brief Recomputes a session's deals from its revealed seeds and prints them.
+ *
+ * @return EXIT_SUCCESS if the seeds hash to the commitment
+ */
+int verify(std::string_view commitment, std::string_view client_seed, std::string_view reveal, std::size_t rounds) {
+  FairDeck::Seeds seeds;
+  std::size_t lane = 0;
+  for (std::size_t start = 0; start <= reveal.size(); ++lane) {
+    std::size_t comma = reveal.find(',', start);
+    if (comma == std::string_view::npos) comma = reveal.size();
+    if (lane == seeds.size()) throw std::invalid_argument("more than " + std::to_string(seeds.size()) + " seeds");
+    seeds[lane] = sha256::from_hex(reveal.substr(start, comma - start));
+    start = comma + 1;
+  }
+  if (lane != seeds.size()) throw std::invalid_argument("expected " + std::to_string(seeds.size()) + " seeds");
+
+  const auto deals = fair::verify(sha256::from_hex(commitment), client_seed, seeds, rounds);
+  if (!deals) {
+    std::println("NOT VERIFIED: THE SEEDS DO NOT HASH TO THE COMMITMENT");
+    return EXIT_FAILURE;
+  }
+  for (std::size_t r = 0; r < deals->size(); ++r) {
+    const FairDeck::Cards& cards = (*deals)[r];
+    std::println("ROUND {:>6}: {:>2} {:>2} {:>2}", r + 1, CARDS[cards[0] - 2], CARDS[cards[1] - 2], CARDS[cards[2] - 2]);
+  }
+  std::println("VERIFIED: {} ROUNDS", rounds);
+  return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Times committing a batch with one hash at a time and with the
+ * multi-buffer hash, deriving the batch's deals, and dealing.
+ *
+ * @param rounds Rounds in the batch
+ */
+void benchmark(std::size_t rounds) {
+  const std::size_t depth = (rounds + FairDeck::LANES - 1) / FairDeck::LANES;
+  FairDeck::Seeds seeds{};
+  for (std::size_t l = 0; l < seeds.size(); ++l) seeds[l][0] = static_cast<std::uint8_t>(l);
+
+  auto start = std::chrono::steady_clock::now();
+  FairDeck::Seeds scalar = seeds;
+  for (std::size_t k = 0; k < depth; ++k) {
+    for (sha256::Digest& seed : scalar) seed = sha256::hash(seed);
+  }
+  const std::chrono::duration<double> one_at_a_time = std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  FairDeck deck(rounds, seeds);
+  const std::chrono::duration<double> multi_buffer = std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  deck.set_client_seed("benchmark");
+  const std::chrono::duration<double> derived = std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  unsigned checksum = 0;
+  while (deck.remaining() > 0) {
+    const FairDeck::Cards& cards = deck.deal();
+    checksum += cards[0] + cards[1] + cards[2];
+  }
+  const std::chrono::duration<double> dealing = std::chrono::steady_clock::now() - start;
+
+  const double hashes = static_cast<double>(depth * FairDeck::LANES);
+  std::println("ROUNDS:             {}", deck.rounds_dealt());
+  std::println("CHAIN, ONE BY ONE:  {:.2f} M HASHES/SEC", hashes / one_at_a_time.count() / 1e6);
+  std::println("CHAIN, {} LANES:     {:.2f} M HASHES/SEC", FairDeck::LANES, hashes / multi_buffer.count() / 1e6);
+  std::println("DEALS DERIVED:      {:.2f} M ROUNDS/SEC", deck.rounds_dealt() / derived.count() / 1e6);
+  std::println("DEAL:               {:.2f} NS", dealing.count() / deck.rounds_dealt() * 1e9);
+  std::println("CHECKSUM:           {}", checksum);
+}
+
+}  // namespace
+
+/**
+ * @brief Entry point for the provably fair deal tools.
+ *
+ * With --commitment, checks that the revealed seeds of a session printed
+ * by AceyDucey --fair hash back to its commitment and lists the cards of
+ * every round. With --bench, times committing and dealing a batch.
+ *
+ * Usage: AceyDuceyFair --commitment HEX --client-seed SEED --rounds N --reveal HEX,...
+ *        AceyDuceyFair --bench ROUNDS
+ */
+int main(int argc, char* argv[]) {
+  std::optional<std::string> commitment, client_seed, reveal;
+  std::optional<std::size_t> rounds, bench;
+
+  try {
+    for (int i = 1; i + 1 < argc; i += 2) {
+      std::string_view flag = argv[i];
+      if (flag == "--commitment") {
+        commitment = argv[i + 1];
+      } else if (flag == "--client-seed") {
+        client_seed = argv[i + 1];
+      } else if (flag == "--rounds") {
+        rounds = std::stoull(argv[i + 1]);
+      } else if (flag == "--reveal") {
+        reveal = argv[i + 1];
+      } else if (flag == "--bench") {
+        bench = std::stoull(argv[i + 1]);
+      } else {
+        argc = 0;
+        break;
+      }
+    }
+  } catch (const std::invalid_argument&) {  // a count that is not a number
+    argc = 0;
+  } catch (const std::out_of_range&) {
+    argc = 0;
+  }
+  const bool verifying = commitment && client_seed && rounds && reveal;
+  if (argc % 2 == 0 || verifying == bench.has_value()) {
+    std::println(stderr, "Usage: AceyDuceyFair --commitment HEX --client-seed SEED --rounds N --reveal HEX,...");
+    std::println(stderr, "       AceyDuceyFair --bench ROUNDS");
+    return EXIT_FAILURE;
+  }
+
+  try {
+    if (bench) {
+      benchmark(*bench);
+      return EXIT_SUCCESS;
+    }
+    return verify(*commitment, *client_seed, *reveal, *rounds);
+  } catch (const std::exception& e) {
+    std::println(stderr, "Error: {}", e.what());
+    return EXIT_FAILURE;
+  }
+}
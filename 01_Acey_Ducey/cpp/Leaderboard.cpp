@@ -0,0 +1,320 @@
+#include "Leaderboard.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <limits>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+constexpr std::uint64_t MAGIC = 0x4452424C59454341ULL;  // "ACEYLBRD"
+constexpr std::int64_t NO_THRESHOLD = std::numeric_limits<std::int64_t>::min();
+
+bool process_alive(std::int32_t pid) {
+  return pid > 0 && (::kill(pid, 0) == 0 || errno != ESRCH);
+}
+
+}  // namespace
+
+/**
+ * @brief Layout of the shared-memory segment.
+ *
+ * Everything is an address-free lock-free atomic, so the same segment can
+ * be mapped at different addresses in different processes.
+ */
+struct Leaderboard::Shared {
+  std::atomic<std::uint64_t> magic;       ///< Set last by the creating process
+  std::atomic<std::int32_t> lock_owner;   ///< Pid holding the writer lock, 0 if free
+  std::atomic<std::int64_t> threshold;    ///< Lowest balance on a full board
+  alignas(64) std::atomic<std::uint64_t> board_seq;
+  std::atomic<std::uint32_t> board_count;
+  std::array<BoardEntry, TOP> board;
+  std::array<Slot, SLOTS> slots;
+};
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free &&
+                std::atomic<std::int32_t>::is_always_lock_free,
+              "shared-memory atomics must be lock-free");
+
+/**
+ * @brief Opens the segment, creating and initialising it if it does not exist.
+ *
+ * The creator sizes the object (which zero-fills it), sets the threshold
+ * and finally the magic number; other processes wait for the magic before
+ * using the segment.
+ *
+ * @param name Shared-memory object name, starting with '/'
+ */
+Leaderboard::Leaderboard(std::string name)
+  : name(std::move(name)), pid(static_cast<std::int32_t>(::getpid())) {
+  bool creator = true;
+  int fd = ::shm_open(this->name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0666);
+  if (fd < 0 && errno == EEXIST) {
+    creator = false;
+    fd = ::shm_open(this->name.c_str(), O_RDWR, 0666);
+  }
+  if (fd < 0) throw std::system_error(errno, std::generic_category(), "shm_open " + this->name);
+
+  if (creator) {
+    if (::ftruncate(fd, sizeof(Shared)) != 0) {
+      int err = errno;
+      ::close(fd);
+      throw std::system_error(err, std::generic_category(), "ftruncate");
+    }
+  } else {
+    // The creator may not have sized the object yet.
+    struct stat st {};
+    while (::fstat(fd, &st) == 0 && static_cast<std::size_t>(st.st_size) < sizeof(Shared)) {
+      std::this_thread::yield();
+    }
+  }
+
+  void* p = ::mmap(nullptr, sizeof(Shared), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (p == MAP_FAILED) throw std::system_error(errno, std::generic_category(), "mmap");
+  shared = static_cast<Shared*>(p);
+
+  if (creator) {
+    shared->threshold.store(NO_THRESHOLD, std::memory_order_relaxed);
+    shared->magic.store(MAGIC, std::memory_order_release);
+  } else {
+    while (shared->magic.load(std::memory_order_acquire) != MAGIC) std::this_thread::yield();
+  }
+}
+
+/**
+ * @brief Releases this process's slot, if any, and unmaps the segment.
+ */
+Leaderboard::~Leaderboard() {
+  if (slot >= 0) {
+    const bool recovered = lock();
+    Slot& mine = shared->slots[slot];
+    mine.pid.store(0, std::memory_order_release);
+    if (recovered || mine.on_board.load(std::memory_order_relaxed)) rebuild();
+    unlock();
+  }
+  ::munmap(shared, sizeof(Shared));
+}
+
+/**
+ * @brief Removes the named segment.
+ */
+void Leaderboard::remove(const std::string& name) {
+  ::shm_unlink(name.c_str());
+}
+
+/**
+ * @brief Takes the writer lock.
+ *
+ * If the holder has died, the lock is taken over and the board, which it
+ * may have left half written, must be rebuilt by the caller.
+ *
+ * @return true if the lock was taken from a dead process
+ */
+bool Leaderboard::lock() const {
+  for (unsigned spins = 1;; ++spins) {
+    std::int32_t owner = 0;
+    if (shared->lock_owner.compare_exchange_weak(owner, pid, std::memory_order_acquire)) return false;
+    if (spins < 64) continue;
+
+    // The holder is probably descheduled; let it run rather than burn its time slice.
+    if (spins % 1024 == 0 && owner && !process_alive(owner) &&
+        shared->lock_owner.compare_exchange_strong(owner, pid, std::memory_order_acquire)) {
+      return true;
+    }
+    std::this_thread::yield();
+  }
+}
+
+void Leaderboard::unlock() const {
+  shared->lock_owner.store(0, std::memory_order_release);
+}
+
+/**
+ * @brief Claims a free slot and publishes the starting balance.
+ *
+ * Slots left by processes that died without releasing them are reclaimed.
+ *
+ * @param player Player id shown on the board
+ * @param balance Starting balance
+ */
+void Leaderboard::join(std::uint64_t player, std::int64_t balance) {
+  if (slot >= 0) throw std::logic_error("leaderboard slot already claimed");
+  for (std::size_t i = 0; i < SLOTS && slot < 0; ++i) {
+    Slot& s = shared->slots[i];
+    std::int32_t owner = s.pid.load(std::memory_order_relaxed);
+    if (owner && process_alive(owner)) continue;
+    if (!s.pid.compare_exchange_strong(owner, pid, std::memory_order_acq_rel)) continue;
+    s.player.store(player, std::memory_order_relaxed);
+    s.balance.store(std::numeric_limits<std::int64_t>::min(), std::memory_order_relaxed);
+    slot = static_cast<std::int64_t>(i);
+  }
+  if (slot < 0) throw std::runtime_error("leaderboard is full");
+
+  // A reclaimed slot may still be on the board under its old owner.
+  if (shared->slots[slot].on_board.load(std::memory_order_relaxed)) {
+    lock();
+    rebuild();
+    unlock();
+  }
+  publish(balance);
+}
+
+/**
+ * @brief Publishes this process's balance.
+ *
+ * The common case is one store: a balance at or below the lowest on a
+ * full board, from a player not on the board, cannot change the ranking.
+ * A concurrent rebuild can miss a balance stored during its scan; the
+ * next publish from that player corrects it.
+ *
+ * @param balance Current balance
+ */
+void Leaderboard::publish(std::int64_t balance) {
+  if (slot < 0) throw std::logic_error("join() the leaderboard before publishing");
+  Slot& mine = shared->slots[slot];
+  mine.balance.store(balance, std::memory_order_seq_cst);
+  if (!mine.on_board.load(std::memory_order_relaxed) &&
+      balance <= shared->threshold.load(std::memory_order_seq_cst)) {
+    return;
+  }
+
+  ++slow_path;
+  if (lock()) {
+    rebuild();
+    unlock();
+    return;
+  }
+
+  std::vector<Ranked> ranked = read_board();
+  auto it = std::ranges::find(ranked, static_cast<std::uint32_t>(slot), &Ranked::slot);
+  if (it != ranked.end()) {
+    const bool fell = balance < it->entry.balance;
+    it->entry.balance = balance;
+    // Someone off the board may now rank above us, which only a rescan can tell.
+    if (fell && ranked.size() == TOP) {
+      rebuild();
+      unlock();
+      return;
+    }
+  } else {
+    ranked.push_back(Ranked{static_cast<std::uint32_t>(slot),
+                            Entry{mine.player.load(std::memory_order_relaxed), balance, pid}});
+    mine.on_board.store(1, std::memory_order_relaxed);
+  }
+
+  std::ranges::stable_sort(ranked, std::ranges::greater{}, [](const Ranked& r) { return r.entry.balance; });
+  if (ranked.size() > TOP) {
+    shared->slots[ranked.back().slot].on_board.store(0, std::memory_order_relaxed);
+    ranked.pop_back();
+  }
+  write_board(ranked);
+  unlock();
+}
+
+/**
+ * @brief Reads the board while holding the writer lock.
+ */
+std::vector<Leaderboard::Ranked> Leaderboard::read_board() const {
+  std::vector<Ranked> ranked(shared->board_count.load(std::memory_order_relaxed));
+  for (std::size_t i = 0; i < ranked.size(); ++i) {
+    const BoardEntry& e = shared->board[i];
+    ranked[i] = Ranked{e.slot.load(std::memory_order_relaxed),
+                       Entry{e.player.load(std::memory_order_relaxed),
+                             e.balance.load(std::memory_order_relaxed),
+                             e.pid.load(std::memory_order_relaxed)}};
+  }
+  return ranked;
+}
+
+/**
+ * @brief Recomputes the board from the slots of live processes, while
+ * holding the writer lock.
+ */
+void Leaderboard::rebuild() const {
+  std::vector<Ranked> ranked;
+  for (std::uint32_t i = 0; i < SLOTS; ++i) {
+    Slot& s = shared->slots[i];
+    s.on_board.store(0, std::memory_order_relaxed);
+    const std::int32_t owner = s.pid.load(std::memory_order_acquire);
+    const std::int64_t balance = s.balance.load(std::memory_order_seq_cst);
+    if (!owner || balance == std::numeric_limits<std::int64_t>::min() || !process_alive(owner)) continue;
+    ranked.push_back(Ranked{i, Entry{s.player.load(std::memory_order_relaxed), balance, owner}});
+  }
+
+  const std::size_t keep = std::min(ranked.size(), TOP);
+  std::ranges::partial_sort(ranked, ranked.begin() + static_cast<std::ptrdiff_t>(keep),
+                            std::ranges::greater{}, [](const Ranked& r) { return r.entry.balance; });
+  ranked.resize(keep);
+  for (const Ranked& r : ranked) shared->slots[r.slot].on_board.store(1, std::memory_order_relaxed);
+  write_board(ranked);
+}
+
+/**
+ * @brief Publishes a ranked board under the seqlock and updates the threshold.
+ *
+ * A dead writer may have left the sequence odd; it is rounded up so the new
+ * board still ends on an even number.
+ */
+void Leaderboard::write_board(std::vector<Ranked>& ranked) const {
+  std::uint64_t s = shared->board_seq.load(std::memory_order_relaxed);
+  s += s & 1;
+  shared->board_seq.store(s + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  for (std::size_t i = 0; i < ranked.size(); ++i) {
+    BoardEntry& e = shared->board[i];
+    e.slot.store(ranked[i].slot, std::memory_order_relaxed);
+    e.player.store(ranked[i].entry.player, std::memory_order_relaxed);
+    e.balance.store(ranked[i].entry.balance, std::memory_order_relaxed);
+    e.pid.store(ranked[i].entry.pid, std::memory_order_relaxed);
+  }
+  shared->board_count.store(static_cast<std::uint32_t>(ranked.size()), std::memory_order_relaxed);
+  shared->board_seq.store(s + 2, std::memory_order_release);
+
+  shared->threshold.store(ranked.size() == TOP ? ranked.back().entry.balance : NO_THRESHOLD,
+                          std::memory_order_seq_cst);
+}
+
+/**
+ * @brief Copies the ranked board, retrying while a writer is active.
+ *
+ * A writer that died mid-update leaves the sequence odd for good. After a
+ * bounded number of retries the reader checks the lock's owner and, if it
+ * is gone, takes the lock over and rebuilds the board itself.
+ */
+Leaderboard::Snapshot Leaderboard::snapshot() const {
+  Snapshot snap;
+  snap.top.reserve(TOP);
+  for (unsigned retries = 1;; ++retries) {
+    const std::uint64_t before = shared->board_seq.load(std::memory_order_acquire);
+    if (before & 1) {
+      const std::int32_t owner = shared->lock_owner.load(std::memory_order_relaxed);
+      if (retries % 1024 == 0 && !process_alive(owner)) {
+        lock();
+        if (shared->board_seq.load(std::memory_order_relaxed) & 1) rebuild();
+        unlock();
+      }
+      std::this_thread::yield();
+      continue;
+    }
+    const std::size_t count = std::min<std::size_t>(shared->board_count.load(std::memory_order_relaxed), TOP);
+    snap.top.resize(count);
+    for (std::size_t i = 0; i < count; ++i) {
+      const BoardEntry& e = shared->board[i];
+      snap.top[i] = Entry{e.player.load(std::memory_order_relaxed), e.balance.load(std::memory_order_relaxed),
+                          e.pid.load(std::memory_order_relaxed)};
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (shared->board_seq.load(std::memory_order_relaxed) == before) {
+      snap.sequence = before / 2;
+      return snap;
+    }
+  }
+}
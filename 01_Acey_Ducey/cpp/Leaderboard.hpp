@@ -0,0 +1,122 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Live top-N balances shared by every AceyDucey process on a machine.
+ *
+ * The board lives in a POSIX shared-memory segment; there is no server.
+ * Each writing process claims a slot and stores its balance there with a
+ * single atomic store. Only when the new balance could change the top of
+ * the board does it take the segment's writer lock and update the ranked
+ * board, which is published under a seqlock: readers copy it and retry if
+ * a writer was active, so they never block writers and always see a
+ * consistent ranking.
+ *
+ * The writer lock records its owner's pid, so a process that dies holding
+ * it is detected and the board is rebuilt from the slots. A process that
+ * dies without releasing its slot stays on the board until the slot is
+ * reclaimed or the board is next rebuilt. One writer per process.
+ */
+class Leaderboard {
+public:
+  static constexpr std::size_t SLOTS = 4096;  ///< Most processes publishing at once
+  static constexpr std::size_t TOP = 16;      ///< Ranked entries kept on the board
+  static constexpr const char* DEFAULT_NAME = "/aceyducey-leaderboard";
+
+  struct Entry {
+    std::uint64_t player = 0;
+    std::int64_t balance = 0;
+    std::int32_t pid = 0;
+  };
+
+  struct Snapshot {
+    std::uint64_t sequence = 0;  ///< Board updates so far
+    std::vector<Entry> top;      ///< Highest balance first
+  };
+
+  /**
+   * @brief Opens the segment, creating and initialising it if it does not exist.
+   *
+   * @param name Shared-memory object name, starting with '/'
+   * @throws std::system_error if the segment cannot be opened or mapped
+   */
+  explicit Leaderboard(std::string name = DEFAULT_NAME);
+
+  /**
+   * @brief Releases this process's slot, if any, and unmaps the segment.
+   */
+  ~Leaderboard();
+
+  Leaderboard(const Leaderboard&) = delete;
+  Leaderboard& operator=(const Leaderboard&) = delete;
+
+  /**
+   * @brief Claims a slot for this process so it can publish.
+   *
+   * @param player Player id shown on the board
+   * @param balance Starting balance
+   * @throws std::runtime_error if every slot is taken
+   */
+  void join(std::uint64_t player, std::int64_t balance);
+
+  /**
+   * @brief Publishes this process's balance; join() must have been called.
+   */
+  void publish(std::int64_t balance);
+
+  /**
+   * @brief Copies the ranked board without blocking writers.
+   */
+  Snapshot snapshot() const;
+
+  /**
+   * @brief Number of publishes by this process that had to update the board.
+   */
+  std::uint64_t board_updates() const { return slow_path; }
+
+  /**
+   * @brief Removes the named segment; processes that have it open keep their mapping.
+   */
+  static void remove(const std::string& name = DEFAULT_NAME);
+
+private:
+  struct BoardEntry {
+    std::atomic<std::uint64_t> player;
+    std::atomic<std::int64_t> balance;
+    std::atomic<std::int32_t> pid;
+    std::atomic<std::uint32_t> slot;
+  };
+
+  struct alignas(64) Slot {
+    std::atomic<std::int32_t> pid;  ///< Owning process, 0 if free
+    std::atomic<std::uint32_t> on_board;
+    std::atomic<std::uint64_t> player;
+    std::atomic<std::int64_t> balance;
+  };
+
+  struct Shared;
+
+  struct Ranked {
+    std::uint32_t slot;
+    Entry entry;
+  };
+
+  // These change only the shared segment, so readers may repair the board too.
+  bool lock() const;
+  void unlock() const;
+  void rebuild() const;
+  void write_board(std::vector<Ranked>& ranked) const;
+  std::vector<Ranked> read_board() const;
+
+  std::string name;
+  Shared* shared = nullptr;
+  std::int32_t pid;
+  std::int64_t slot = -1;
+  std::uint64_t slow_path = 0;
+};
@@ -0,0 +1,229 @@
+#include "Leaderboard.hpp"
+#include "AceyDuceyRules.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <ctime>
+#include <mutex>
+#include <print>
+#include <random>
+#include <string>
+#include <string_view>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief What each writer process reports back through the pipe.
+ */
+struct WriterResult {
+  double publish_ns;  ///< CPU time spent publishing, in nanoseconds
+  std::uint64_t board_updates;
+};
+
+double cpu_ns() {
+  timespec ts{};
+  ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/**
+ * @brief Plays the same rounds as a writer, publishing after every settlement if board is not null.
+ *
+ * @return CPU time taken, in nanoseconds
+ */
+double play(Leaderboard* board, unsigned index, unsigned settlements) {
+  std::mt19937_64 rng(index + 1);
+  std::uniform_int_distribution<int> card(acey_ducey::LOWEST_CARD, acey_ducey::HIGHEST_CARD);
+  std::int64_t balance = acey_ducey::STARTING_BALANCE;
+
+  const double start = cpu_ns();
+  for (unsigned i = 0; i < settlements; ++i) {
+    if (balance <= 0) balance = acey_ducey::STARTING_BALANCE;
+    const auto bet = static_cast<std::int32_t>(std::min<std::int64_t>(balance, 10));
+    balance += acey_ducey::settle(card(rng), card(rng), card(rng), bet);
+    if (board) board->publish(balance);
+  }
+  return cpu_ns() - start;
+}
+
+/**
+ * @brief Body of one writer process.
+ *
+ * With hundreds of processes sharing the CPUs, wall-clock time per call
+ * mostly measures the scheduler, so the cost is the CPU time of the rounds
+ * with publishing minus the CPU time of the same rounds without.
+ */
+WriterResult run_writer(const std::string& name, unsigned index, unsigned settlements) {
+  const double baseline = play(nullptr, index, settlements);
+  Leaderboard board(name);
+  board.join(index, acey_ducey::STARTING_BALANCE);
+  const double with_publish = play(&board, index, settlements);
+  return WriterResult{std::max(0.0, with_publish - baseline), board.board_updates()};
+}
+
+void print_board(const Leaderboard::Snapshot& snap, std::size_t rows) {
+  std::println("{:>4}  {:>8}  {:>8}  {:>10}", "RANK", "PLAYER", "PID", "BALANCE");
+  for (std::size_t i = 0; i < std::min(rows, snap.top.size()); ++i) {
+    const Leaderboard::Entry& e = snap.top[i];
+    std::println("{:>4}  {:>8}  {:>8}  {:>10}", i + 1, e.player, e.pid, e.balance);
+  }
+}
+
+}  // namespace
+
+/**
+ * @brief Entry point for the leaderboard benchmark.
+ *
+ * Forks writer processes that each publish after every settlement while
+ * reader threads in the parent take snapshots as fast as they can. Every
+ * writer is forked before the readers start and waits on a pipe until
+ * the parent closes it, so no child is a copy of a threaded process. With
+ * --show it only prints the live board from the default segment.
+ *
+ * Usage: LeaderboardBench [--writers N] [--settlements N] [--readers N] | --show N
+ */
+int main(int argc, char* argv[]) {
+  unsigned writers = 1000;
+  unsigned settlements = 20'000;
+  unsigned readers = 2;
+
+  for (int i = 1; i + 1 < argc; i += 2) {
+    std::string_view flag = argv[i];
+    if (flag == "--writers") {
+      writers = static_cast<unsigned>(std::stoul(argv[i + 1]));
+    } else if (flag == "--settlements") {
+      settlements = static_cast<unsigned>(std::stoul(argv[i + 1]));
+    } else if (flag == "--readers") {
+      readers = static_cast<unsigned>(std::stoul(argv[i + 1]));
+    } else if (flag == "--show") {
+      try {
+        Leaderboard board;
+        print_board(board.snapshot(), std::stoul(argv[i + 1]));
+        return EXIT_SUCCESS;
+      } catch (const std::exception& e) {
+        std::println(stderr, "Error: {}", e.what());
+        return EXIT_FAILURE;
+      }
+    } else {
+      std::println(stderr, "Usage: LeaderboardBench [--writers N] [--settlements N] [--readers N] | --show N");
+      return EXIT_FAILURE;
+    }
+  }
+  if (writers > Leaderboard::SLOTS) {
+    std::println(stderr, "Error: at most {} writers", Leaderboard::SLOTS);
+    return EXIT_FAILURE;
+  }
+
+  const std::string name = "/aceyducey-lb-bench-" + std::to_string(::getpid());
+  try {
+    Leaderboard board(name);
+    int fds[2];
+    if (::pipe(fds) != 0) throw std::system_error(errno, std::generic_category(), "pipe");
+
+    int go[2];
+    if (::pipe(go) != 0) {
+      const int err = errno;
+      ::close(fds[0]);
+      ::close(fds[1]);
+      throw std::system_error(err, std::generic_category(), "pipe");
+    }
+
+    std::vector<pid_t> children;
+    try {
+      for (unsigned w = 0; w < writers; ++w) {
+        pid_t child = ::fork();
+        if (child < 0) throw std::system_error(errno, std::generic_category(), "fork");
+        if (child == 0) {
+          ::close(fds[0]);
+          ::close(go[1]);
+          char byte;
+          while (::read(go[0], &byte, 1) < 0 && errno == EINTR) {
+          }
+          WriterResult result{};
+          try {
+            result = run_writer(name, w, settlements);
+          } catch (...) {
+            ::_exit(EXIT_FAILURE);
+          }
+          ssize_t written = ::write(fds[1], &result, sizeof(result));
+          ::_exit(written == sizeof(result) ? EXIT_SUCCESS : EXIT_FAILURE);
+        }
+        children.push_back(child);
+      }
+    } catch (...) {
+      // Reap the writers already started before giving up.
+      for (pid_t child : children) {
+        ::kill(child, SIGKILL);
+        ::waitpid(child, nullptr, 0);
+      }
+      ::close(go[0]);
+      ::close(go[1]);
+      ::close(fds[0]);
+      ::close(fds[1]);
+      throw;
+    }
+    ::close(go[0]);
+    ::close(fds[1]);
+
+    std::atomic<bool> running{true};
+    std::atomic<std::uint64_t> reads{0};
+    std::atomic<std::uint64_t> unsorted{0};
+    std::mutex fullest_mutex;
+    Leaderboard::Snapshot fullest;  // Writers empty the board as they exit, so keep the last full one
+    std::vector<std::jthread> reader_threads;
+    for (unsigned r = 0; r < readers; ++r) {
+      reader_threads.emplace_back([&](std::stop_token stop) {
+        std::uint64_t local = 0;
+        Leaderboard::Snapshot kept;
+        while (running.load(std::memory_order_relaxed) && !stop.stop_requested()) {
+          Leaderboard::Snapshot snap = board.snapshot();
+          if (!std::ranges::is_sorted(snap.top, std::ranges::greater{}, &Leaderboard::Entry::balance)) {
+            unsorted.fetch_add(1, std::memory_order_relaxed);
+          }
+          if (snap.top.size() >= kept.top.size()) kept = std::move(snap);
+          ++local;
+        }
+        reads.fetch_add(local, std::memory_order_relaxed);
+        std::lock_guard lock(fullest_mutex);
+        if (kept.sequence > fullest.sequence) fullest = std::move(kept);
+      });
+    }
+
+    // Closing the last write end wakes every writer at once.
+    auto start = std::chrono::steady_clock::now();
+    ::close(go[1]);
+
+    double publish_ns = 0;
+    std::uint64_t board_updates = 0;
+    unsigned reported = 0;
+    for (WriterResult result; ::read(fds[0], &result, sizeof(result)) == sizeof(result); ++reported) {
+      publish_ns += result.publish_ns;
+      board_updates += result.board_updates;
+    }
+    ::close(fds[0]);
+    for (pid_t child : children) ::waitpid(child, nullptr, 0);
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    running = false;
+    reader_threads.clear();
+
+    const double total = static_cast<double>(reported) * settlements;
+    std::println("WRITER PROCESSES: {} ({} REPORTED)  SETTLEMENTS EACH: {}  TIME: {:.2f}s", writers, reported,
+                 settlements, seconds);
+    std::println("PUBLISH COST: {:.1f} CPU NS/SETTLEMENT  BOARD UPDATES: {:.3f}%", publish_ns / total,
+                 100.0 * board_updates / total);
+    std::println("READERS: {}  SNAPSHOTS: {:.2f} M/SEC  UNSORTED: {}", readers, reads.load() / seconds / 1e6,
+                 unsorted.load());
+    print_board(fullest, 5);
+  } catch (const std::exception& e) {
+    std::println(stderr, "Error: {}", e.what());
+    Leaderboard::remove(name);
+    return EXIT_FAILURE;
+  }
+  Leaderboard::remove(name);
+}
@@ -0,0 +1,434 @@
+#include "Ledger.hpp"
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <sys/file.h>
+#include <system_error>
+#include <unistd.h>
+
+namespace {
+
+constexpr std::uint64_t CHECKPOINT_MAGIC = 0x54504B4359454341ULL;  // "ACEYCKPT"
+
+/**
+ * @brief Standard CRC-32 (IEEE 802.3), table driven.
+ */
+std::uint32_t crc32(const void* data, std::size_t size, std::uint32_t crc = 0) {
+  static const std::array<std::uint32_t, 256> table = [] {
+    std::array<std::uint32_t, 256> t{};
+    for (std::uint32_t i = 0; i < 256; ++i) {
+      std::uint32_t c = i;
+      for (int k = 0; k < 8; ++k) c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+      t[i] = c;
+    }
+    return t;
+  }();
+
+  crc = ~crc;
+  const auto* p = static_cast<const unsigned char*>(data);
+  for (std::size_t i = 0; i < size; ++i) crc = table[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+  return ~crc;
+}
+
+[[noreturn]] void throw_errno(const std::string& what) {
+  throw std::system_error(errno, std::generic_category(), what);
+}
+
+/**
+ * @brief Writes the whole buffer, retrying short writes.
+ */
+void write_all(int fd, const void* data, std::size_t size, const std::string& what) {
+  const auto* p = static_cast<const char*>(data);
+  while (size) {
+    ssize_t n = ::write(fd, p, size);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      throw_errno(what);
+    }
+    p += n;
+    size -= static_cast<std::size_t>(n);
+  }
+}
+
+/**
+ * @brief Makes a rename or file creation in the directory durable.
+ */
+void sync_directory(const std::filesystem::path& dir) {
+  int fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+  if (fd < 0) throw_errno(dir.string());
+  int rc = ::fsync(fd);
+  ::close(fd);
+  if (rc != 0) throw_errno("fsync " + dir.string());
+}
+
+std::vector<char> read_file(const std::filesystem::path& path) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) throw std::system_error(errno, std::generic_category(), path.string());
+  return std::vector<char>(std::istreambuf_iterator<char>(in), {});
+}
+
+std::string segment_name(std::uint64_t first_lsn) {
+  return "wal-" + std::to_string(first_lsn) + ".log";
+}
+
+}  // namespace
+
+/**
+ * @brief Opens or creates a ledger, recovering any existing state.
+ *
+ * Any number of processes may open the same directory. They take turns
+ * through an exclusive lock on its `lock` file, held while a batch is
+ * numbered and appended, a checkpoint taken or a balance read, and each
+ * first replays whatever the others committed since it last held it.
+ *
+ * @param directory Directory holding the checkpoint and log segments
+ * @param batch_window How long the writer waits to fill a batch
+ */
+Ledger::Ledger(std::filesystem::path directory, std::chrono::microseconds batch_window)
+  : dir(std::move(directory)), window(batch_window) {
+  std::filesystem::create_directories(dir);
+  const std::filesystem::path lock_path = dir / "lock";
+  lock_fd = ::open(lock_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0666);
+  if (lock_fd < 0) throw_errno(lock_path.string());
+  try {
+    recover();
+  } catch (...) {
+    if (log_fd >= 0) ::close(log_fd);
+    ::close(lock_fd);
+    throw;
+  }
+  writer = std::jthread([this] { writer_loop(); });
+}
+
+/**
+ * @brief Commits anything pending and stops the writer.
+ */
+Ledger::~Ledger() {
+  {
+    std::lock_guard lock(queue_mutex);
+    stopping = true;
+  }
+  queue_ready.notify_one();
+  if (writer.joinable()) writer.join();
+  if (log_fd >= 0) ::close(log_fd);
+  ::close(lock_fd);
+}
+
+/**
+ * @brief Holds the ledger's lock file for a scope.
+ */
+class Ledger::DirectoryLock {
+public:
+  explicit DirectoryLock(int fd) : fd(fd) {
+    while (::flock(fd, LOCK_EX) != 0) {
+      if (errno != EINTR) throw_errno("flock");
+    }
+  }
+  ~DirectoryLock() { ::flock(fd, LOCK_UN); }
+  DirectoryLock(const DirectoryLock&) = delete;
+  DirectoryLock& operator=(const DirectoryLock&) = delete;
+
+private:
+  int fd;
+};
+
+/**
+ * @brief Loads the checkpoint and replays the log after it.
+ */
+void Ledger::recover() {
+  auto start = std::chrono::steady_clock::now();
+  DirectoryLock lock(lock_fd);
+  recovered.checkpoint_lsn = load_checkpoint();
+  recovered.replayed = catch_up();
+  recovered.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * @brief Replaces the balances with the checkpoint's, or with none if there is no checkpoint.
+ *
+ * @return Last settlement the checkpoint covers
+ */
+std::uint64_t Ledger::load_checkpoint() {
+  std::unordered_map<std::uint64_t, std::int64_t> loaded;
+  std::uint64_t lsn = 0;
+  const std::filesystem::path checkpoint_path = dir / "checkpoint";
+  if (std::filesystem::exists(checkpoint_path)) {
+    std::vector<char> data = read_file(checkpoint_path);
+    std::uint64_t header[3];
+    if (data.size() < sizeof(header) + sizeof(std::uint32_t)) {
+      throw std::runtime_error("checkpoint is truncated");
+    }
+    std::memcpy(header, data.data(), sizeof(header));
+    const std::size_t body = sizeof(header) + header[2] * 2 * sizeof(std::int64_t);
+    std::uint32_t stored = 0;
+    if (header[0] != CHECKPOINT_MAGIC || data.size() != body + sizeof(stored)) {
+      throw std::runtime_error("checkpoint is not a ledger checkpoint");
+    }
+    std::memcpy(&stored, data.data() + body, sizeof(stored));
+    if (crc32(data.data(), body) != stored) throw std::runtime_error("checkpoint fails its checksum");
+
+    lsn = header[1];
+    loaded.reserve(header[2]);
+    for (std::uint64_t i = 0; i < header[2]; ++i) {
+      std::int64_t entry[2];
+      std::memcpy(entry, data.data() + sizeof(header) + i * sizeof(entry), sizeof(entry));
+      loaded[static_cast<std::uint64_t>(entry[0])] = entry[1];
+    }
+  }
+
+  std::lock_guard lock(balances_mutex);
+  balances = std::move(loaded);
+  applied_lsn = lsn;
+  return lsn;
+}
+
+/**
+ * @brief Applies every record committed since this process last looked,
+ * by it or by another, and points appends at the newest segment.
+ *
+ * The caller holds io_mutex and the directory lock. Reading resumes where
+ * it stopped in the newest segment it saw; if another process has since
+ * checkpointed and deleted that segment, the balances are reloaded from
+ * the checkpoint and every remaining segment replayed instead.
+ *
+ * A record that is short or fails its CRC can only be the tail of a batch
+ * that was being written when its process stopped, since no one else can
+ * be writing while the lock is held; it was never acknowledged, so the
+ * segment is truncated there. The same damage in an older segment means
+ * real corruption and is reported instead.
+ *
+ * @return Records applied
+ */
+std::uint64_t Ledger::catch_up() {
+  std::vector<std::pair<std::uint64_t, std::filesystem::path>> segments;
+  for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+    const std::string name = entry.path().filename().string();
+    if (name.starts_with("wal-") && name.ends_with(".log")) {
+      segments.emplace_back(std::stoull(name.substr(4, name.size() - 8)), entry.path());
+    }
+  }
+  std::ranges::sort(segments);
+
+  std::size_t first = 0;
+  std::uint64_t offset = 0;
+  auto resume = std::ranges::find(segments, segment_lsn, [](const auto& s) { return s.first; });
+  if (resume != segments.end()) {
+    first = static_cast<std::size_t>(resume - segments.begin());
+    offset = segment_bytes;
+  } else if (segment_lsn != 0) {
+    load_checkpoint();
+  }
+
+  std::uint64_t applied = 0;
+  std::lock_guard lock(balances_mutex);
+  for (std::size_t s = first; s < segments.size(); ++s, offset = 0) {
+    const std::vector<char> data = read_file(segments[s].second);
+    for (; offset + sizeof(Record) <= data.size(); offset += sizeof(Record)) {
+      Record r;
+      std::memcpy(&r, data.data() + offset, sizeof(r));
+      if (r.crc != crc32(&r, offsetof(Record, crc))) break;
+      if (r.lsn <= applied_lsn) continue;
+      if (r.lsn != applied_lsn + 1) throw std::runtime_error("log gap before lsn " + std::to_string(r.lsn));
+      auto [it, inserted] = balances.try_emplace(r.player, STARTING_BALANCE);
+      it->second += r.delta;
+      applied_lsn = r.lsn;
+      ++applied;
+    }
+
+    if (offset < data.size()) {
+      if (s + 1 != segments.size()) {
+        throw std::runtime_error("corrupt record in " + segments[s].second.filename().string());
+      }
+      recovered.torn_bytes += data.size() - offset;
+      std::filesystem::resize_file(segments[s].second, offset);
+    }
+    segment_lsn = segments[s].first;
+    segment_bytes = offset;
+  }
+
+  if (segments.empty()) {
+    segment_lsn = applied_lsn + 1;
+    segment_bytes = 0;
+  }
+  if (log_fd < 0 || log_lsn != segment_lsn) open_segment(segment_lsn);
+  return applied;
+}
+
+/**
+ * @brief Switches appends to the segment starting at first_lsn.
+ */
+void Ledger::open_segment(std::uint64_t first_lsn) {
+  const std::filesystem::path path = dir / segment_name(first_lsn);
+  int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+  if (fd < 0) throw_errno(path.string());
+  if (log_fd >= 0) ::close(log_fd);
+  log_fd = fd;
+  log_lsn = first_lsn;
+  sync_directory(dir);
+}
+
+/**
+ * @brief Queues a settlement and waits for its batch to be synced.
+ *
+ * The writer numbers the settlement when it commits the batch, so its LSN
+ * is only known once it is durable.
+ */
+std::uint64_t Ledger::settle(std::uint64_t player, std::int64_t delta) {
+  std::unique_lock lock(queue_mutex);
+  if (failure) std::rethrow_exception(failure);
+
+  std::uint64_t lsn = 0;
+  const std::uint64_t ticket = ++queued;
+  pending.push_back({player, delta, &lsn});
+  if (pending.size() == 1 || pending.size() == MAX_BATCH) queue_ready.notify_one();
+
+  committed.wait(lock, [&] { return durable >= ticket || failure; });
+  if (durable < ticket) std::rethrow_exception(failure);
+  return lsn;
+}
+
+/**
+ * @brief Committed balance of a player, after replaying what other
+ * processes have committed.
+ */
+std::int64_t Ledger::balance(std::uint64_t player) {
+  {
+    std::lock_guard io(io_mutex);
+    DirectoryLock lock(lock_fd);
+    catch_up();
+  }
+  std::lock_guard lock(balances_mutex);
+  auto it = balances.find(player);
+  return it == balances.end() ? STARTING_BALANCE : it->second;
+}
+
+/**
+ * @brief Returns the group commit counters.
+ */
+Ledger::Stats Ledger::stats() const {
+  std::lock_guard lock(queue_mutex);
+  return counters;
+}
+
+/**
+ * @brief Gathers pending settlements into batches and commits each with one sync.
+ *
+ * After the first settlement of a batch arrives the writer waits out the
+ * batch window, or until MAX_BATCH are pending, then takes the directory
+ * lock, catches up with the other processes, numbers the batch after the
+ * last record in the log and writes it. Settlements that arrive during the
+ * write and sync form the next batch.
+ */
+void Ledger::writer_loop() {
+  std::vector<Pending> batch;
+  std::vector<Record> records;
+  std::unique_lock lock(queue_mutex);
+  while (true) {
+    queue_ready.wait(lock, [&] { return stopping || !pending.empty(); });
+    if (pending.empty()) return;
+    if (window.count() > 0 && !stopping) {
+      queue_ready.wait_for(lock, window, [&] { return stopping || pending.size() >= MAX_BATCH; });
+    }
+    batch.swap(pending);
+    lock.unlock();
+
+    try {
+      std::lock_guard io(io_mutex);
+      DirectoryLock directory(lock_fd);
+      catch_up();
+
+      records.clear();
+      for (const Pending& p : batch) {
+        Record r{applied_lsn + records.size() + 1, p.player, p.delta, 0, 0};
+        r.crc = crc32(&r, offsetof(Record, crc));
+        records.push_back(r);
+      }
+      write_all(log_fd, records.data(), records.size() * sizeof(Record), "write log");
+      if (::fdatasync(log_fd) != 0) throw_errno("fdatasync");
+      segment_bytes += records.size() * sizeof(Record);
+
+      std::lock_guard balances_lock(balances_mutex);
+      for (std::size_t i = 0; i < records.size(); ++i) {
+        auto [it, inserted] = balances.try_emplace(records[i].player, STARTING_BALANCE);
+        it->second += records[i].delta;
+        *batch[i].lsn = records[i].lsn;
+      }
+      applied_lsn = records.back().lsn;
+    } catch (...) {
+      lock.lock();
+      failure = std::current_exception();
+      committed.notify_all();
+      return;
+    }
+
+    lock.lock();
+    durable += batch.size();
+    ++counters.commits;
+    counters.records += batch.size();
+    batch.clear();
+    committed.notify_all();
+  }
+}
+
+/**
+ * @brief Snapshots every balance and starts a new log segment.
+ *
+ * The snapshot is written to a temporary file, synced and renamed over the
+ * old checkpoint, so a crash leaves either the old or the new one intact.
+ */
+void Ledger::checkpoint() {
+  std::lock_guard io(io_mutex);
+  DirectoryLock directory(lock_fd);
+  catch_up();
+
+  std::vector<std::int64_t> entries;
+  std::uint64_t lsn;
+  {
+    std::lock_guard lock(balances_mutex);
+    lsn = applied_lsn;
+    entries.reserve(balances.size() * 2);
+    for (const auto& [player, amount] : balances) {
+      entries.push_back(static_cast<std::int64_t>(player));
+      entries.push_back(amount);
+    }
+  }
+
+  const std::uint64_t header[3] = {CHECKPOINT_MAGIC, lsn, entries.size() / 2};
+  std::uint32_t crc = crc32(header, sizeof(header));
+  crc = crc32(entries.data(), entries.size() * sizeof(std::int64_t), crc);
+
+  const std::filesystem::path tmp = dir / "checkpoint.tmp";
+  int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) throw_errno(tmp.string());
+  try {
+    write_all(fd, header, sizeof(header), "write checkpoint");
+    write_all(fd, entries.data(), entries.size() * sizeof(std::int64_t), "write checkpoint");
+    write_all(fd, &crc, sizeof(crc), "write checkpoint");
+    if (::fsync(fd) != 0) throw_errno("fsync checkpoint");
+  } catch (...) {
+    ::close(fd);
+    throw;
+  }
+  ::close(fd);
+  std::filesystem::rename(tmp, dir / "checkpoint");
+  sync_directory(dir);
+
+  // Everything up to lsn is now in the checkpoint; start afresh and drop the old segments.
+  open_segment(lsn + 1);
+  segment_lsn = lsn + 1;
+  segment_bytes = 0;
+  const std::string current = segment_name(lsn + 1);
+  for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+    const std::string name = entry.path().filename().string();
+    if (name.starts_with("wal-") && name.ends_with(".log") && name != current) {
+      std::filesystem::remove(entry.path());
+    }
+  }
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+#include "AceyDuceyRules.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Durable player balances backed by a write-ahead log.
+ *
+ * Every settlement is appended to the log and only acknowledged once it is
+ * on disk. Settlements from concurrent sessions are gathered by a single
+ * writer thread into group commits, one write and one fdatasync per batch,
+ * so the cost of a sync is shared by everyone who settled inside the batch
+ * window. A checkpoint writes all balances to a snapshot file and starts a
+ * new log segment; recovery loads the newest checkpoint and replays the
+ * segments after it, stopping at the first torn or corrupt record.
+ *
+ * Several processes, such as one game per player, may share a ledger.
+ * Each one's batches are numbered and appended under an exclusive lock on
+ * the directory, after replaying what the others have appended, so the
+ * log stays one gap-free sequence; balances are read the same way.
+ *
+ * Directory layout: `checkpoint` plus `wal-<first lsn>.log` segments, and
+ * the `lock` file the processes take turns on.
+ */
+class Ledger {
+public:
+  /**
+   * @brief Balance of a player the ledger has never seen: the game's starting balance.
+   */
+  static constexpr std::int64_t STARTING_BALANCE = acey_ducey::STARTING_BALANCE;
+
+  /**
+   * @brief What recovery found when the ledger was opened.
+   */
+  struct Recovery {
+    std::uint64_t checkpoint_lsn = 0;  ///< Last settlement covered by the checkpoint
+    std::uint64_t replayed = 0;        ///< Log records applied on top of it
+    std::uint64_t torn_bytes = 0;      ///< Bytes truncated from an incomplete last write
+    double seconds = 0;
+  };
+
+  /**
+   * @brief Group commit counters since the ledger was opened.
+   */
+  struct Stats {
+    std::uint64_t commits = 0;  ///< fdatasync calls
+    std::uint64_t records = 0;
+  };
+
+  /**
+   * @brief Opens or creates a ledger, recovering any existing state.
+   *
+   * @param directory Directory holding the checkpoint and log segments
+   * @param batch_window How long the writer waits after the first pending
+   *        settlement before committing, to let others join the batch
+   */
+  explicit Ledger(std::filesystem::path directory,
+                  std::chrono::microseconds batch_window = std::chrono::microseconds{200});
+
+  /**
+   * @brief Commits anything pending and stops the writer.
+   */
+  ~Ledger();
+
+  Ledger(const Ledger&) = delete;
+  Ledger& operator=(const Ledger&) = delete;
+
+  /**
+   * @brief Durably adds delta to a player's balance.
+   *
+   * Blocks until the batch holding this settlement has been synced.
+   *
+   * @param player Player id
+   * @param delta Signed change, e.g. +bet or -bet
+   * @return Log sequence number of the settlement
+   * @throws std::system_error if the log cannot be written
+   */
+  std::uint64_t settle(std::uint64_t player, std::int64_t delta);
+
+  /**
+   * @brief Committed balance of a player, including settlements committed by other processes.
+   */
+  std::int64_t balance(std::uint64_t player);
+
+  /**
+   * @brief Snapshots every balance and starts a new log segment.
+   *
+   * Older segments are deleted once the checkpoint is durable, so recovery
+   * time stays bounded by the log written since the last checkpoint.
+   */
+  void checkpoint();
+
+  const Recovery& recovery() const { return recovered; }
+  Stats stats() const;
+
+private:
+  /**
+   * @brief One log record as stored on disk.
+   */
+  struct Record {
+    std::uint64_t lsn;
+    std::uint64_t player;
+    std::int64_t delta;
+    std::uint32_t crc;  ///< CRC-32 of the three fields above
+    std::uint32_t reserved;
+  };
+  static_assert(sizeof(Record) == 32);
+
+  /**
+   * @brief A settlement waiting for the writer, which numbers it on commit.
+   */
+  struct Pending {
+    std::uint64_t player;
+    std::int64_t delta;
+    std::uint64_t* lsn;  ///< Where settle() waits for the number
+  };
+
+  class DirectoryLock;
+
+  static constexpr std::size_t MAX_BATCH = 4096;  ///< Commit early once this many are pending
+
+  void recover();
+  std::uint64_t load_checkpoint();
+  std::uint64_t catch_up();
+  void open_segment(std::uint64_t first_lsn);
+  void writer_loop();
+
+  std::filesystem::path dir;
+  std::chrono::microseconds window;
+  int lock_fd = -1;  ///< The directory's lock file, flocked while the log is read or written
+  Recovery recovered;
+
+  // Pending settlements, guarded by queue_mutex
+  mutable std::mutex queue_mutex;
+  std::condition_variable queue_ready;
+  std::condition_variable committed;
+  std::vector<Pending> pending;
+  std::uint64_t queued = 0;   ///< Settlements queued by this process
+  std::uint64_t durable = 0;  ///< Of those, how many are committed
+  bool stopping = false;
+  std::exception_ptr failure;
+  Stats counters;
+
+  // Committed balances, guarded by balances_mutex
+  mutable std::mutex balances_mutex;
+  std::unordered_map<std::uint64_t, std::int64_t> balances;
+  std::uint64_t applied_lsn = 0;
+
+  /**
+   * @brief Held while the log is replayed, a batch written and applied, or
+   * a checkpoint taken, so a checkpoint always matches exactly the segments
+   * it replaces; guards the log position below.
+   */
+  std::mutex io_mutex;
+  int log_fd = -1;
+  std::uint64_t log_lsn = 0;        ///< First LSN of the segment log_fd appends to
+  std::uint64_t segment_lsn = 0;    ///< First LSN of the newest segment replayed, 0 before recovery
+  std::uint64_t segment_bytes = 0;  ///< How much of it has been replayed
+  std::jthread writer;
+};
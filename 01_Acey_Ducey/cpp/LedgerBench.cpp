@@ -0,0 +1,154 @@
+#include "Ledger.hpp"
+#include "AceyDuceyRules.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <format>
+#include <print>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Parses a comma-separated list of microsecond windows.
+ */
+std::vector<std::chrono::microseconds> parse_windows(const std::string& list) {
+  std::vector<std::chrono::microseconds> windows;
+  std::stringstream in(list);
+  for (std::string item; std::getline(in, item, ',');) windows.emplace_back(std::stoll(item));
+  return windows;
+}
+
+}  // namespace
+
+/**
+ * @brief Entry point for the ledger benchmark.
+ *
+ * For each batch window, concurrent sessions play Acey Ducey rounds and
+ * settle every bet through a fresh ledger. The ledger is then reopened to
+ * time recovery by log replay, checked against the balances the sessions
+ * expect, checkpointed, and reopened again to time recovery from the
+ * checkpoint.
+ *
+ * The ledgers live in a new directory the benchmark makes inside PATH
+ * (the system temporary directory by default) and removes when it is
+ * done; nothing else in PATH is touched.
+ *
+ * Usage: LedgerBench [--dir PATH] [--sessions N] [--rounds N] [--windows US,US,...]
+ */
+int main(int argc, char* argv[]) {
+  std::filesystem::path parent = std::filesystem::temp_directory_path();
+  unsigned sessions = 64;
+  unsigned rounds = 500;
+  std::vector<std::chrono::microseconds> windows = parse_windows("0,100,500,2000");
+
+  for (int i = 1; i + 1 < argc; i += 2) {
+    std::string_view flag = argv[i];
+    if (flag == "--dir") {
+      parent = argv[i + 1];
+    } else if (flag == "--sessions") {
+      sessions = static_cast<unsigned>(std::stoul(argv[i + 1]));
+    } else if (flag == "--rounds") {
+      rounds = static_cast<unsigned>(std::stoul(argv[i + 1]));
+    } else if (flag == "--windows") {
+      windows = parse_windows(argv[i + 1]);
+    } else {
+      std::println(stderr, "Usage: LedgerBench [--dir PATH] [--sessions N] [--rounds N] [--windows US,US,...]");
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::filesystem::path work;
+  try {
+    std::filesystem::create_directories(parent);
+    std::string name = (parent / "LedgerBench-XXXXXX").string();
+    if (!::mkdtemp(name.data())) throw std::system_error(errno, std::generic_category(), name);
+    work = name;
+
+    std::println("SESSIONS: {}  ROUNDS EACH: {}  DIRECTORY: {}", sessions, rounds, work.string());
+    std::println("{:>10}{:>14}{:>10}{:>12}{:>12}{:>12}{:>14}", "WINDOW US", "SETTLES/SEC", "BATCH", "P50 US",
+                 "P99 US", "REPLAY MS", "CHECKPT MS");
+
+    for (std::size_t w = 0; w < windows.size(); ++w) {
+      const std::chrono::microseconds window = windows[w];
+      const std::filesystem::path dir = work / std::to_string(w);
+      std::vector<std::vector<double>> latencies(sessions);
+      std::vector<std::int64_t> expected(sessions, Ledger::STARTING_BALANCE);
+      Ledger::Stats stats;
+      double seconds = 0;
+
+      {
+        Ledger ledger(dir, window);
+        auto start = std::chrono::steady_clock::now();
+        {
+          std::vector<std::jthread> players;
+          for (unsigned s = 0; s < sessions; ++s) {
+            players.emplace_back([&, s] {
+              std::mt19937_64 rng(s + 1);
+              std::uniform_int_distribution<int> card(acey_ducey::LOWEST_CARD, acey_ducey::HIGHEST_CARD);
+              std::int64_t& balance = expected[s];
+              latencies[s].reserve(rounds);
+              for (unsigned r = 0; r < rounds; ++r) {
+                if (balance <= 0) {  // TRY AGAIN: back to the starting balance
+                  ledger.settle(s, Ledger::STARTING_BALANCE - balance);
+                  balance = Ledger::STARTING_BALANCE;
+                }
+                const auto bet = static_cast<std::int32_t>(std::min<std::int64_t>(balance, 10));
+                const std::int32_t delta = acey_ducey::settle(card(rng), card(rng), card(rng), bet);
+                if (delta == 0) continue;
+
+                auto t0 = std::chrono::steady_clock::now();
+                ledger.settle(s, delta);
+                latencies[s].push_back(
+                  std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count());
+                balance += delta;
+              }
+            });
+          }
+        }
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        stats = ledger.stats();
+      }
+
+      std::vector<double> all;
+      for (const auto& l : latencies) all.insert(all.end(), l.begin(), l.end());
+      std::ranges::sort(all);
+      auto percentile = [&](double p) {
+        return all.empty() ? 0.0 : all[static_cast<std::size_t>(p * (all.size() - 1))];
+      };
+
+      double replay_ms, checkpoint_ms;
+      {
+        Ledger ledger(dir, window);
+        replay_ms = ledger.recovery().seconds * 1e3;
+        for (unsigned s = 0; s < sessions; ++s) {
+          if (ledger.balance(s) != expected[s]) {
+            throw std::runtime_error(
+              std::format("session {} recovered ${}, expected ${}", s, ledger.balance(s), expected[s]));
+          }
+        }
+        ledger.checkpoint();
+      }
+      {
+        Ledger ledger(dir, window);
+        checkpoint_ms = ledger.recovery().seconds * 1e3;
+      }
+
+      std::println("{:>10}{:>14.0f}{:>10.1f}{:>12.0f}{:>12.0f}{:>12.2f}{:>14.2f}", window.count(),
+                   stats.records / seconds, stats.commits ? double(stats.records) / stats.commits : 0.0,
+                   percentile(0.5), percentile(0.99), replay_ms, checkpoint_ms);
+    }
+    std::filesystem::remove_all(work);
+  } catch (const std::exception& e) {
+    std::println(stderr, "Error: {}", e.what());
+    if (!work.empty()) std::filesystem::remove_all(work);
+    return EXIT_FAILURE;
+  }
+}
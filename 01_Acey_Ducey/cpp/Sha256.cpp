@@ -0,0 +1,185 @@
+#include "Sha256.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+
+namespace sha256 {
+
+namespace {
+
+constexpr std::array<std::uint32_t, 64> K{
+  0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+  0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+  0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+  0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+  0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+  0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+  0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+  0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+constexpr std::array<std::uint32_t, 8> INITIAL{
+  0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+};
+
+/**
+ * @brief LANES 32-bit words, one per message, as a GCC/Clang vector: the
+ * operators below apply to every lane at once, in whatever registers the
+ * target has.
+ */
+using Vector = std::uint32_t __attribute__((vector_size(4 * LANES)));
+
+template <class W>
+inline constexpr std::size_t LANES_OF = sizeof(W) / sizeof(std::uint32_t);
+
+template <class W>
+inline W rotr(W x, int n) {
+  return (x >> n) | (x << (32 - n));
+}
+
+/**
+ * @brief One of the 64 rounds.
+ *
+ * Rather than shifting all eight working variables along, the caller
+ * rotates which variable plays which part: the round writes the new e into
+ * d and the new a into h.
+ */
+template <class W>
+inline void round(W a, W b, W c, W& d, W e, W f, W g, W& h, std::uint32_t k, W w) {
+  const W t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + k + w;
+  const W t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+  d += t1;
+  h = t1 + t2;
+}
+
+/**
+ * @brief One compression of a block, for a single message (W = std::uint32_t)
+ * or for LANES messages side by side (W = Vector).
+ */
+template <class W>
+void compress(std::array<W, 8>& state, const std::array<W, 16>& block) {
+  std::array<W, 64> w;
+  std::copy(block.begin(), block.end(), w.begin());
+  for (std::size_t t = 16; t < 64; ++t) {
+    const W x = w[t - 15], y = w[t - 2];
+    w[t] = w[t - 16] + (rotr(x, 7) ^ rotr(x, 18) ^ (x >> 3)) + w[t - 7] + (rotr(y, 17) ^ rotr(y, 19) ^ (y >> 10));
+  }
+
+  W a = state[0], b = state[1], c = state[2], d = state[3];
+  W e = state[4], f = state[5], g = state[6], h = state[7];
+  for (std::size_t t = 0; t < 64; t += 8) {
+    round(a, b, c, d, e, f, g, h, K[t], w[t]);
+    round(h, a, b, c, d, e, f, g, K[t + 1], w[t + 1]);
+    round(g, h, a, b, c, d, e, f, K[t + 2], w[t + 2]);
+    round(f, g, h, a, b, c, d, e, K[t + 3], w[t + 3]);
+    round(e, f, g, h, a, b, c, d, K[t + 4], w[t + 4]);
+    round(d, e, f, g, h, a, b, c, K[t + 5], w[t + 5]);
+    round(c, d, e, f, g, h, a, b, K[t + 6], w[t + 6]);
+    round(b, c, d, e, f, g, h, a, K[t + 7], w[t + 7]);
+  }
+  state[0] += a;
+  state[1] += b;
+  state[2] += c;
+  state[3] += d;
+  state[4] += e;
+  state[5] += f;
+  state[6] += g;
+  state[7] += h;
+}
+
+/**
+ * @brief Bytes offset to offset+63 of a message padded to whole blocks:
+ * the message, 0x80, zeros, then its length in bits.
+ */
+void padded_block(const std::uint8_t* message, std::size_t length, std::size_t padded_length, std::size_t offset,
+                  std::uint8_t* out) {
+  const std::size_t available = offset < length ? std::min<std::size_t>(64, length - offset) : 0;
+  if (available > 0) std::memcpy(out, message + offset, available);
+  std::memset(out + available, 0, 64 - available);
+  if (length >= offset && length < offset + 64) out[length - offset] = 0x80;
+  if (offset + 64 == padded_length) {
+    const std::uint64_t bits = std::uint64_t{length} * 8;
+    for (std::size_t k = 0; k < 8; ++k) out[56 + k] = static_cast<std::uint8_t>(bits >> (56 - 8 * k));
+  }
+}
+
+std::uint32_t& lane(std::uint32_t& word, std::size_t) { return word; }
+
+auto lane(Vector& word, std::size_t l) -> decltype(word[l]) { return word[l]; }
+
+/**
+ * @brief Hashes up to LANES_OF<W> messages of equal length; lanes beyond
+ * count repeat the last message and are not written out.
+ */
+template <class W>
+void hash_lanes(const std::uint8_t* messages, std::size_t length, std::size_t count, Digest* out) {
+  const std::size_t padded_length = (length + 9 + 63) / 64 * 64;
+  std::array<W, 8> state;
+  for (std::size_t i = 0; i < 8; ++i) state[i] = W{} + INITIAL[i];
+
+  std::array<W, 16> block;
+  for (std::size_t offset = 0; offset < padded_length; offset += 64) {
+    for (std::size_t l = 0; l < LANES_OF<W>; ++l) {
+      std::uint8_t bytes[64];
+      padded_block(messages + std::min(l, count - 1) * length, length, padded_length, offset, bytes);
+      for (std::size_t j = 0; j < 16; ++j) {
+        const std::uint8_t* p = bytes + 4 * j;
+        lane(block[j], l) = std::uint32_t{p[0]} << 24 | std::uint32_t{p[1]} << 16 | std::uint32_t{p[2]} << 8 | p[3];
+      }
+    }
+    compress(state, block);
+  }
+
+  for (std::size_t l = 0; l < std::min(LANES_OF<W>, count); ++l) {
+    for (std::size_t i = 0; i < 8; ++i) {
+      const std::uint32_t word = lane(state[i], l);
+      for (std::size_t k = 0; k < 4; ++k) out[l][4 * i + k] = static_cast<std::uint8_t>(word >> (24 - 8 * k));
+    }
+  }
+}
+
+}  // namespace
+
+Digest hash(std::span<const std::uint8_t> message) {
+  Digest digest;
+  hash_lanes<std::uint32_t>(message.data(), message.size(), 1, &digest);
+  return digest;
+}
+
+Digest hash(std::string_view message) {
+  return hash(std::span(reinterpret_cast<const std::uint8_t*>(message.data()), message.size()));
+}
+
+void hash_many(const std::uint8_t* messages, std::size_t length, std::size_t count, Digest* out) {
+  for (std::size_t i = 0; i < count; i += LANES) {
+    hash_lanes<Vector>(messages + i * length, length, std::min(LANES, count - i), out + i);
+  }
+}
+
+std::string to_hex(const Digest& digest) {
+  static constexpr char DIGITS[] = "0123456789abcdef";
+  std::string hex;
+  for (std::uint8_t byte : digest) {
+    hex += DIGITS[byte >> 4];
+    hex += DIGITS[byte & 15];
+  }
+  return hex;
+}
+
+Digest from_hex(std::string_view hex) {
+  auto nibble = [&](char c) -> std::uint8_t {
+    if (c >= '0' && c <= '9') return static_cast<std::uint8_t>(c - '0');
+    if (c >= 'a' && c <= 'f') return static_cast<std::uint8_t>(c - 'a' + 10);
+    if (c >= 'A' && c <= 'F') return static_cast<std::uint8_t>(c - 'A' + 10);
+    throw std::invalid_argument("not a SHA-256 digest: " + std::string(hex));
+  };
+  if (hex.size() != 64) throw std::invalid_argument("not a SHA-256 digest: " + std::string(hex));
+  Digest digest;
+  for (std::size_t i = 0; i < digest.size(); ++i) {
+    digest[i] = static_cast<std::uint8_t>(nibble(hex[2 * i]) << 4 | nibble(hex[2 * i + 1]));
+  }
+  return digest;
+}
+
+}  // namespace sha256
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief SHA-256 (FIPS 180-4), one message at a time or many at once.
+ *
+ * The multi-buffer form hashes LANES equal-length messages together: every
+ * working variable is a GCC/Clang vector of one 32-bit word per lane, so
+ * each step of the compression is a single vector operation (eight lanes
+ * fill an AVX2 register, or two NEON or SSE registers) with no intrinsics
+ * and so no per-architecture code.
+ */
+namespace sha256 {
+
+inline constexpr std::size_t LANES = 8;
+
+using Digest = std::array<std::uint8_t, 32>;
+
+/**
+ * @brief Hashes one message.
+ */
+Digest hash(std::span<const std::uint8_t> message);
+
+/**
+ * @brief Hashes the bytes of a string.
+ */
+Digest hash(std::string_view message);
+
+/**
+ * @brief Hashes count messages of length bytes each, stored back to back, LANES at a time.
+ *
+ * @param messages count * length bytes
+ * @param length Bytes per message
+ * @param count Number of messages
+ * @param out count digests
+ */
+void hash_many(const std::uint8_t* messages, std::size_t length, std::size_t count, Digest* out);
+
+/**
+ * @brief Lower-case hex of a digest.
+ */
+std::string to_hex(const Digest& digest);
+
+/**
+ * @brief Parses 64 hex digits.
+ *
+ * @throws std::invalid_argument if the text is not a digest
+ */
+Digest from_hex(std::string_view hex);
+
+}  // namespace sha256
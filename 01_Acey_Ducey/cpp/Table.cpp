@@ -0,0 +1,110 @@
+#include "Table.hpp"
+#include <stdexcept>
+
+/**
+ * @brief Opens a table with every bettor on the starting balance.
+ *
+ * @param bettors Number of bettor accounts
+ * @param variant House rules the table deals under
+ * @param seed Seed for the dealer's deck
+ */
+Table::Table(std::size_t bettors, acey_ducey::Variant variant, std::uint64_t seed)
+  : balances(bettors, acey_ducey::STARTING_BALANCE), bets(bettors, 0), variant(variant), rng(seed) {}
+
+/**
+ * @brief Draws one card, 2 to 14, as deal_card does for a single player.
+ */
+int Table::draw() {
+  std::uniform_int_distribution<int> card(acey_ducey::LOWEST_CARD, acey_ducey::HIGHEST_CARD);
+  return card(rng);
+}
+
+/**
+ * @brief Deals the two posts for a new deal and starts taking bets.
+ */
+const Table::Deal& Table::open() {
+  if (taking_bets) throw std::logic_error("previous deal has not been settled");
+  current = Deal{draw(), draw(), 0, 0};
+  taking_bets = true;
+  return current;
+}
+
+/**
+ * @brief Stakes a bet for the open deal.
+ *
+ * @param bettor Bettor index
+ * @param amount Dollars bet
+ * @return false if the bet is not positive or is more than the bettor's balance
+ */
+bool Table::place(std::uint32_t bettor, std::int32_t amount) {
+  if (!taking_bets) throw std::logic_error("no deal is open");
+  if (bettor >= balances.size()) throw std::out_of_range("unknown bettor");
+  if (amount <= 0 || amount > balances[bettor]) return false;
+  bets[bettor] = amount;
+  return true;
+}
+
+/**
+ * @brief Stakes a batch of bets.
+ *
+ * @param bettors Bettor indices
+ * @param amounts Dollars bet by each, the same length as bettors
+ * @return Number of bets accepted
+ */
+std::size_t Table::place_batch(std::span<const std::uint32_t> bettors, std::span<const std::int32_t> amounts) {
+  if (bettors.size() != amounts.size()) throw std::invalid_argument("bettors and amounts differ in length");
+  std::size_t accepted = 0;
+  for (std::size_t i = 0; i < bettors.size(); ++i) accepted += place(bettors[i], amounts[i]);
+  return accepted;
+}
+
+/**
+ * @brief Deals the third card and settles every staked bet in one pass.
+ *
+ * The outcome is worked out once, for a one-dollar bet, by the variant's
+ * Rules::settle. Each bettor then needs only a multiply-add, with bettors
+ * who did not bet contributing zero, so the loop has no branches and
+ * vectorises.
+ *
+ * @return Bets, stakes and net payout for the deal
+ */
+Table::Totals Table::settle() {
+  if (!taking_bets) throw std::logic_error("no deal is open");
+  current.third = draw();
+  current.multiplier = acey_ducey::with_rules(variant, [&]<class Rules>(Rules) {
+    return Rules::settle(current.first, current.second, current.third, 1).delta;
+  });
+
+  const std::int64_t m = current.multiplier;
+  std::int64_t* __restrict balance = balances.data();
+  std::int32_t* __restrict bet = bets.data();
+  const std::size_t n = balances.size();
+  std::int64_t staked = 0;
+  std::int64_t count = 0;
+  for (std::size_t i = 0; i < n; ++i) {
+    const std::int64_t b = bet[i];
+    balance[i] += b * m;
+    staked += b;
+    count += b != 0;
+    bet[i] = 0;
+  }
+
+  taking_bets = false;
+  return Totals{static_cast<std::uint64_t>(count), staked, staked * m};
+}
+
+/**
+ * @brief Restores bettors who have lost everything to the starting balance,
+ * as TRY AGAIN does in the single-player game.
+ *
+ * @return Number of bettors restored
+ */
+std::size_t Table::restart_busted() {
+  std::size_t restored = 0;
+  for (std::int64_t& b : balances) {
+    const bool busted = b <= 0;
+    restored += busted;
+    b = busted ? acey_ducey::STARTING_BALANCE : b;
+  }
+  return restored;
+}
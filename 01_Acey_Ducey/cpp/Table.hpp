@@ -0,0 +1,98 @@
+#pragma once
+
+#include "AceyDuceyVariants.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <vector>
+
+/**
+ * @brief Broadcast table: one dealer's cards settled for many bettors at once.
+ *
+ * Every bettor sees the same two posts and the same third card, so a deal
+ * has a single outcome and each bettor's change in balance is just their
+ * bet times that outcome's multiplier (-1, 0 for a push, or the payout).
+ * Balances and the bets collected for the current deal are stored as two
+ * contiguous arrays indexed by bettor, and settlement is one branch-free
+ * pass over both that the compiler vectorises.
+ *
+ * A deal runs open() (posts dealt, bets accepted), place()/place_batch(),
+ * then settle() (third card dealt, balances updated, bets cleared).
+ */
+class Table {
+public:
+  struct Deal {
+    int first = 0;                ///< First post, 2 to 14
+    int second = 0;               ///< Second post
+    int third = 0;                ///< Card dealt after the bets; 0 until settled
+    std::int32_t multiplier = 0;  ///< Change in balance per dollar bet
+  };
+
+  struct Totals {
+    std::uint64_t bets = 0;  ///< Bettors with a stake in the deal
+    std::int64_t staked = 0;
+    std::int64_t paid = 0;   ///< Net paid to bettors; negative when the house wins
+  };
+
+  /**
+   * @brief Opens a table with every bettor on the starting balance.
+   *
+   * @param bettors Number of bettor accounts
+   * @param variant House rules the table deals under
+   * @param seed Seed for the dealer's deck
+   */
+  explicit Table(std::size_t bettors, acey_ducey::Variant variant = {}, std::uint64_t seed = std::random_device{}());
+
+  /**
+   * @brief Deals the two posts for a new deal and starts taking bets.
+   *
+   * @throws std::logic_error if the previous deal has not been settled
+   */
+  const Deal& open();
+
+  /**
+   * @brief Stakes a bet for the open deal, replacing any earlier bet by the same bettor.
+   *
+   * @return false if the bet is not positive or is more than the bettor's balance
+   * @throws std::logic_error if no deal is open
+   * @throws std::out_of_range for an unknown bettor
+   */
+  bool place(std::uint32_t bettor, std::int32_t amount);
+
+  /**
+   * @brief Stakes a batch of bets; bettors[i] bets amounts[i].
+   *
+   * @return Number of bets accepted
+   */
+  std::size_t place_batch(std::span<const std::uint32_t> bettors, std::span<const std::int32_t> amounts);
+
+  /**
+   * @brief Deals the third card and settles every staked bet in one pass.
+   *
+   * @throws std::logic_error if no deal is open
+   */
+  Totals settle();
+
+  const Deal& deal() const { return current; }
+  std::size_t size() const { return balances.size(); }
+  std::int64_t balance(std::uint32_t bettor) const { return balances.at(bettor); }
+  std::span<const std::int64_t> all_balances() const { return balances; }
+
+  /**
+   * @brief Restores bettors who have lost everything to the starting balance.
+   *
+   * @return Number of bettors restored
+   */
+  std::size_t restart_busted();
+
+private:
+  int draw();
+
+  std::vector<std::int64_t> balances;
+  std::vector<std::int32_t> bets;  ///< Stake in the open deal, 0 for none
+  acey_ducey::Variant variant;
+  std::mt19937_64 rng;
+  Deal current;
+  bool taking_bets = false;
+};
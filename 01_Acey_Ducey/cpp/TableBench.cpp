@@ -0,0 +1,141 @@
+#include "Table.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <print>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief A bettor as a per-player game holds one: balance and bet side by side.
+ */
+struct Account {
+  std::int64_t balance = acey_ducey::STARTING_BALANCE;
+  std::int32_t bet = 0;
+};
+
+/**
+ * @brief Baseline: evaluates the rules again for every bettor, as one game per bettor would.
+ */
+[[gnu::noinline]] void settle_each(std::vector<Account>& accounts, const Table::Deal& deal) {
+  for (Account& a : accounts) {
+    if (a.bet > 0) a.balance += acey_ducey::settle(deal.first, deal.second, deal.third, a.bet);
+    a.bet = 0;
+  }
+}
+
+struct Result {
+  double settle_ns = 0;    ///< Per deal
+  double baseline_ns = 0;  ///< Per deal
+  double place_ns = 0;     ///< Per accepted bet
+  std::uint64_t bets = 0;
+  bool matches = true;
+};
+
+Result run(std::size_t bettors, unsigned deals, double fraction, std::uint64_t seed) {
+  using clock = std::chrono::steady_clock;
+  Table table(bettors, acey_ducey::Variant{}, seed);
+  std::vector<Account> accounts(bettors);
+  std::mt19937_64 rng(seed ^ 0x9E3779B97F4A7C15ULL);
+  std::bernoulli_distribution bets_this_deal(fraction);
+  std::uniform_int_distribution<std::int32_t> stake(1, 25);
+
+  std::vector<std::uint32_t> who;
+  std::vector<std::int32_t> amounts;
+  Result r;
+  clock::duration settle_time{};
+  clock::duration baseline_time{};
+  clock::duration place_time{};
+  for (unsigned d = 0; d < deals; ++d) {
+    table.open();
+    who.clear();
+    amounts.clear();
+    for (std::uint32_t b = 0; b < bettors; ++b) {
+      if (!bets_this_deal(rng)) continue;
+      const auto amount = static_cast<std::int32_t>(std::min<std::int64_t>(stake(rng), table.balance(b)));
+      who.push_back(b);
+      amounts.push_back(amount);
+      accounts[b].bet = amount;
+    }
+
+    auto t0 = clock::now();
+    r.bets += table.place_batch(who, amounts);
+    auto t1 = clock::now();
+    table.settle();
+    auto t2 = clock::now();
+    settle_each(accounts, table.deal());
+    auto t3 = clock::now();
+    place_time += t1 - t0;
+    settle_time += t2 - t1;
+    baseline_time += t3 - t2;
+
+    table.restart_busted();
+    for (Account& a : accounts) a.balance = a.balance <= 0 ? acey_ducey::STARTING_BALANCE : a.balance;
+  }
+
+  for (std::size_t b = 0; b < bettors && r.matches; ++b) {
+    r.matches = table.all_balances()[b] == accounts[b].balance;
+  }
+  auto ns = [](clock::duration t) { return std::chrono::duration<double, std::nano>(t).count(); };
+  r.settle_ns = ns(settle_time) / deals;
+  r.baseline_ns = ns(baseline_time) / deals;
+  r.place_ns = r.bets ? ns(place_time) / static_cast<double>(r.bets) : 0;
+  return r;
+}
+
+}  // namespace
+
+/**
+ * @brief Entry point for the broadcast table benchmark.
+ *
+ * Settles the same deals at tables of 10k, 100k and 1M bettors (or one
+ * size given with --bettors) with the table's single vectorised pass, and
+ * with a per-bettor loop over interleaved accounts that evaluates the
+ * rules for each bet, and checks the balances agree.
+ *
+ * Usage: TableBench [--bettors N] [--deals N] [--fraction F] [--seed N]
+ */
+int main(int argc, char* argv[]) {
+  std::vector<std::size_t> sizes{10'000, 100'000, 1'000'000};
+  unsigned deals = 200;
+  double fraction = 0.6;
+  std::uint64_t seed = 1;
+
+  for (int i = 1; i + 1 < argc; i += 2) {
+    std::string_view flag = argv[i];
+    if (flag == "--bettors") {
+      sizes = {std::stoull(argv[i + 1])};
+    } else if (flag == "--deals") {
+      deals = static_cast<unsigned>(std::stoul(argv[i + 1]));
+    } else if (flag == "--fraction") {
+      fraction = std::stod(argv[i + 1]);
+    } else if (flag == "--seed") {
+      seed = std::stoull(argv[i + 1]);
+    } else {
+      std::println(stderr, "Usage: TableBench [--bettors N] [--deals N] [--fraction F] [--seed N]");
+      return EXIT_FAILURE;
+    }
+  }
+  if (deals == 0 || fraction < 0 || fraction > 1) {
+    std::println(stderr, "Error: need --deals > 0 and --fraction between 0 and 1");
+    return EXIT_FAILURE;
+  }
+
+  std::println("DEALS: {}  BETTING EACH DEAL: {:.0f}%", deals, fraction * 100);
+  std::println("{:>10}  {:>14}  {:>12}  {:>14}  {:>8}  {:>12}  {:>7}", "BETTORS", "SETTLE US/DEAL", "NS/BETTOR",
+               "PER-BET US", "SPEEDUP", "PLACE NS/BET", "MATCH");
+  bool all_match = true;
+  for (std::size_t bettors : sizes) {
+    const Result r = run(bettors, deals, fraction, seed);
+    all_match = all_match && r.matches;
+    std::println("{:>10}  {:>14.1f}  {:>12.3f}  {:>14.1f}  {:>7.2f}x  {:>12.1f}  {:>7}", bettors, r.settle_ns / 1e3,
+                 r.settle_ns / static_cast<double>(bettors), r.baseline_ns / 1e3, r.baseline_ns / r.settle_ns,
+                 r.place_ns, r.matches ? "YES" : "NO");
+  }
+  return all_match ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,425 @@
+#include "Trace.hpp"
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <limits>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <unistd.h>
+
+namespace {
+
+constexpr char FILE_MAGIC[8] = {'A', 'C', 'E', 'Y', 'T', 'R', 'C', '1'};
+constexpr std::uint32_t BLOCK_MAGIC = 0x4B4C4254;  // "TBLK"
+
+enum class Mode : std::uint8_t { FrameOfReference, Delta };
+
+struct BlockHeader {
+  std::uint32_t magic;
+  std::uint32_t rounds;
+  std::uint64_t bytes;  ///< Column data following the header
+};
+
+struct ColumnHeader {
+  Mode mode;
+  std::uint8_t width;  ///< Bits per value, 0 to 64
+  std::uint8_t reserved[6];
+  std::int64_t base;   ///< Column minimum, or the first value for Delta
+};
+
+static_assert(sizeof(BlockHeader) == 16 && sizeof(ColumnHeader) == 16);
+
+constexpr int COLUMNS = 8;  ///< session, round, first, second, third, outcome, bet, balance
+
+std::uint64_t zigzag(std::int64_t v) {
+  return (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63);
+}
+
+std::int64_t unzigzag(std::uint64_t v) {
+  return static_cast<std::int64_t>(v >> 1) ^ -static_cast<std::int64_t>(v & 1);
+}
+
+int bits_for(std::uint64_t v) {
+  return v ? 64 - std::countl_zero(v) : 0;
+}
+
+std::size_t words_for(std::size_t n, int width) {
+  return (n * static_cast<std::size_t>(width) + 63) / 64;
+}
+
+void pack(std::span<const std::uint64_t> values, int width, std::uint64_t* out) {
+  std::fill_n(out, words_for(values.size(), width), 0);
+  if (width == 0) return;
+  std::size_t bit = 0;
+  for (std::uint64_t v : values) {
+    const std::size_t w = bit / 64;
+    const unsigned shift = bit % 64;
+    out[w] |= v << shift;
+    if (shift + width > 64) out[w + 1] |= v >> (64 - shift);
+    bit += width;
+  }
+}
+
+std::uint64_t load_word(const std::byte* p, std::size_t w) {
+  std::uint64_t v;
+  std::memcpy(&v, p + w * sizeof(v), sizeof(v));
+  return v;
+}
+
+void unpack(const std::byte* in, std::size_t n, int width, std::uint64_t* out) {
+  if (width == 0) {
+    std::fill_n(out, n, 0);
+    return;
+  }
+  const std::uint64_t mask = width == 64 ? ~0ULL : (1ULL << width) - 1;
+  std::size_t bit = 0;
+  for (std::size_t i = 0; i < n; ++i, bit += width) {
+    const std::size_t w = bit / 64;
+    const unsigned shift = bit % 64;
+    std::uint64_t v = load_word(in, w) >> shift;
+    if (shift + width > 64) v |= load_word(in, w + 1) << (64 - shift);
+    out[i] = v & mask;
+  }
+}
+
+/**
+ * @brief Appends one column, packed as offsets from the minimum or as zigzag deltas, whichever is narrower.
+ */
+template <class T>
+void encode_column(const std::vector<T>& column, std::vector<std::uint64_t>& scratch,
+                   std::vector<std::uint64_t>& packed, std::vector<std::byte>& out) {
+  const std::size_t n = column.size();
+  std::int64_t lo = std::numeric_limits<std::int64_t>::max();
+  std::int64_t hi = std::numeric_limits<std::int64_t>::min();
+  std::uint64_t widest_delta = 0;
+  for (std::size_t i = 0; i < n; ++i) {
+    const auto v = static_cast<std::int64_t>(column[i]);
+    lo = std::min(lo, v);
+    hi = std::max(hi, v);
+    if (i) widest_delta |= zigzag(v - static_cast<std::int64_t>(column[i - 1]));
+  }
+  const int range_width = bits_for(static_cast<std::uint64_t>(hi) - static_cast<std::uint64_t>(lo));
+  const int delta_width = bits_for(widest_delta);
+
+  ColumnHeader h{};
+  scratch.resize(n);
+  if (delta_width < range_width) {
+    h.mode = Mode::Delta;
+    h.width = static_cast<std::uint8_t>(delta_width);
+    h.base = static_cast<std::int64_t>(column[0]);
+    scratch[0] = 0;
+    for (std::size_t i = 1; i < n; ++i) {
+      scratch[i] = zigzag(static_cast<std::int64_t>(column[i]) - static_cast<std::int64_t>(column[i - 1]));
+    }
+  } else {
+    h.mode = Mode::FrameOfReference;
+    h.width = static_cast<std::uint8_t>(range_width);
+    h.base = lo;
+    for (std::size_t i = 0; i < n; ++i) {
+      scratch[i] = static_cast<std::uint64_t>(static_cast<std::int64_t>(column[i])) - static_cast<std::uint64_t>(lo);
+    }
+  }
+
+  const std::size_t at = out.size();
+  const std::size_t words = words_for(n, h.width);
+  out.resize(at + sizeof(h) + words * sizeof(std::uint64_t));
+  std::memcpy(out.data() + at, &h, sizeof(h));
+  packed.resize(words);
+  pack(scratch, h.width, packed.data());
+  std::memcpy(out.data() + at + sizeof(h), packed.data(), words * sizeof(std::uint64_t));
+}
+
+/**
+ * @brief Whether a block's columns all have a known mode and a width of at
+ * most 64 bits, and together fill exactly the block's bytes.
+ *
+ * @param p First column header
+ * @param rounds Rounds in the block
+ * @param bytes Column data in the block
+ */
+bool columns_valid(const std::byte* p, std::uint32_t rounds, std::uint64_t bytes) {
+  for (int c = 0; c < COLUMNS; ++c) {
+    ColumnHeader h;
+    if (bytes < sizeof(h)) return false;
+    std::memcpy(&h, p, sizeof(h));
+    if ((h.mode != Mode::FrameOfReference && h.mode != Mode::Delta) || h.width > 64) return false;
+    const std::uint64_t size = sizeof(h) + words_for(rounds, h.width) * sizeof(std::uint64_t);
+    if (size > bytes) return false;
+    p += size;
+    bytes -= size;
+  }
+  return bytes == 0;
+}
+
+/**
+ * @brief Decodes one column starting at p and returns the position after it.
+ *
+ * The block's columns must have passed columns_valid().
+ */
+template <class T>
+const std::byte* decode_column(const std::byte* p, std::size_t n, std::vector<std::uint64_t>& scratch,
+                               std::vector<T>& column) {
+  ColumnHeader h;
+  std::memcpy(&h, p, sizeof(h));
+  p += sizeof(h);
+  scratch.resize(n);
+  unpack(p, n, h.width, scratch.data());
+
+  column.resize(n);
+  if (h.mode == Mode::Delta) {
+    auto v = static_cast<std::uint64_t>(h.base);
+    for (std::size_t i = 0; i < n; ++i) {
+      v += static_cast<std::uint64_t>(unzigzag(scratch[i]));
+      column[i] = static_cast<T>(v);
+    }
+  } else {
+    const auto base = static_cast<std::uint64_t>(h.base);
+    for (std::size_t i = 0; i < n; ++i) column[i] = static_cast<T>(base + scratch[i]);
+  }
+  return p + words_for(n, h.width) * sizeof(std::uint64_t);
+}
+
+void write_all(int fd, const std::byte* p, std::size_t n) {
+  while (n) {
+    const ssize_t w = ::write(fd, p, n);
+    if (w < 0) {
+      if (errno == EINTR) continue;
+      throw std::system_error(errno, std::generic_category(), "write trace");
+    }
+    p += w;
+    n -= static_cast<std::size_t>(w);
+  }
+}
+
+}  // namespace
+
+void TraceBlock::clear() {
+  session.clear();
+  round.clear();
+  first.clear();
+  second.clear();
+  third.clear();
+  outcome.clear();
+  bet.clear();
+  balance.clear();
+}
+
+void TraceBlock::push_back(const TraceRound& r) {
+  session.push_back(r.session);
+  round.push_back(r.round);
+  first.push_back(r.first);
+  second.push_back(r.second);
+  third.push_back(r.third);
+  outcome.push_back(static_cast<std::uint8_t>(r.outcome));
+  bet.push_back(r.bet);
+  balance.push_back(r.balance);
+}
+
+TraceRound TraceBlock::operator[](std::size_t i) const {
+  return TraceRound{session[i], round[i], first[i], second[i], third[i], static_cast<TraceOutcome>(outcome[i]),
+                    bet[i], balance[i]};
+}
+
+/**
+ * @brief Creates or truncates the trace file and starts the encoder thread.
+ *
+ * @param path Trace file
+ * @param block_rounds Rounds per block
+ * @param queue_depth Full blocks that may wait for the encoder before append() waits
+ */
+TraceWriter::TraceWriter(const std::filesystem::path& path, std::size_t block_rounds, std::size_t queue_depth)
+  : block_rounds(std::max<std::size_t>(1, block_rounds)), queue_depth(std::max<std::size_t>(1, queue_depth)) {
+  fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) throw std::system_error(errno, std::generic_category(), "open " + path.string());
+  try {
+    write_all(fd, reinterpret_cast<const std::byte*>(FILE_MAGIC), sizeof(FILE_MAGIC));
+  } catch (...) {
+    ::close(fd);
+    throw;
+  }
+  written = sizeof(FILE_MAGIC);
+  encoder = std::jthread([this](std::stop_token stop) { encode_loop(stop); });
+}
+
+/**
+ * @brief Flushes the last partial block and closes the file.
+ */
+TraceWriter::~TraceWriter() {
+  try {
+    flush();
+  } catch (...) {
+    // Nothing more can be done from a destructor; the error was already reported if flush() was called.
+  }
+  encoder.request_stop();
+  encoder.join();
+  ::close(fd);
+}
+
+/**
+ * @brief Appends one round to the current block, queueing the block when it is full.
+ */
+void TraceWriter::append(const TraceRound& r) {
+  current.push_back(r);
+  ++appended;
+  if (current.size() >= block_rounds) submit();
+}
+
+/**
+ * @brief Queues the current block for the encoder and starts a new one.
+ */
+void TraceWriter::submit() {
+  std::unique_lock lock(mutex);
+  if (in_flight >= queue_depth) {
+    ++stall_count;
+    space.wait(lock, [&] { return in_flight < queue_depth; });
+  }
+  if (error) throw std::system_error(error, std::generic_category(), "write trace");
+  queue.push_back(std::move(current));
+  ++in_flight;
+  if (spare.empty()) {
+    current = TraceBlock{};
+  } else {
+    current = std::move(spare.back());
+    spare.pop_back();
+  }
+  ready.notify_one();
+}
+
+/**
+ * @brief Hands the current partial block to the encoder and waits until everything is written.
+ */
+void TraceWriter::flush() {
+  if (current.size()) submit();
+  std::unique_lock lock(mutex);
+  space.wait(lock, [&] { return in_flight == 0; });
+  if (error) throw std::system_error(error, std::generic_category(), "write trace");
+}
+
+std::uint64_t TraceWriter::bytes_written() const {
+  std::lock_guard lock(mutex);
+  return written;
+}
+
+/**
+ * @brief Body of the encoder thread: encodes and writes queued blocks in order.
+ *
+ * Runs until stopped with the queue empty. After a write error the
+ * remaining blocks are discarded and the error is reported to the writer.
+ */
+void TraceWriter::encode_loop(std::stop_token stop) {
+  std::vector<std::byte> buffer;
+  std::vector<std::uint64_t> scratch;
+  std::vector<std::uint64_t> packed;
+  while (true) {
+    TraceBlock block;
+    {
+      std::unique_lock lock(mutex);
+      ready.wait(lock, stop, [&] { return !queue.empty(); });
+      if (queue.empty()) return;
+      block = std::move(queue.front());
+      queue.pop_front();
+    }
+
+    buffer.resize(sizeof(BlockHeader));
+    encode_column(block.session, scratch, packed, buffer);
+    encode_column(block.round, scratch, packed, buffer);
+    encode_column(block.first, scratch, packed, buffer);
+    encode_column(block.second, scratch, packed, buffer);
+    encode_column(block.third, scratch, packed, buffer);
+    encode_column(block.outcome, scratch, packed, buffer);
+    encode_column(block.bet, scratch, packed, buffer);
+    encode_column(block.balance, scratch, packed, buffer);
+    const BlockHeader header{BLOCK_MAGIC, static_cast<std::uint32_t>(block.size()),
+                             buffer.size() - sizeof(BlockHeader)};
+    std::memcpy(buffer.data(), &header, sizeof(header));
+
+    int failed = 0;
+    try {
+      if (!error) write_all(fd, buffer.data(), buffer.size());
+    } catch (const std::system_error& e) {
+      failed = e.code().value();
+    }
+
+    block.clear();
+    std::lock_guard lock(mutex);
+    if (failed) error = failed;
+    if (!error) written += buffer.size();
+    spare.push_back(std::move(block));
+    --in_flight;
+    space.notify_all();
+  }
+}
+
+/**
+ * @brief Maps the file and indexes its blocks.
+ *
+ * A truncated or corrupt block, as left by a writer that was killed, ends
+ * the index; the blocks before it are still readable. Column headers are
+ * checked here too, so decode() never reads outside its block.
+ *
+ * @param path Trace file
+ */
+TraceReader::TraceReader(const std::filesystem::path& path) {
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) throw std::system_error(errno, std::generic_category(), "open " + path.string());
+  struct stat st {};
+  if (::fstat(fd, &st) != 0) {
+    const int err = errno;
+    ::close(fd);
+    throw std::system_error(err, std::generic_category(), "fstat");
+  }
+  length = static_cast<std::size_t>(st.st_size);
+  if (length < sizeof(FILE_MAGIC)) {
+    ::close(fd);
+    throw std::runtime_error(path.string() + " is not a trace file");
+  }
+  void* p = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (p == MAP_FAILED) throw std::system_error(errno, std::generic_category(), "mmap");
+  data = static_cast<const std::byte*>(p);
+  ::madvise(p, length, MADV_SEQUENTIAL);
+
+  if (std::memcmp(data, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0) {
+    ::munmap(p, length);
+    throw std::runtime_error(path.string() + " is not a trace file");
+  }
+  for (std::size_t at = sizeof(FILE_MAGIC); at < length;) {
+    BlockHeader h;
+    if (length - at < sizeof(h)) break;
+    std::memcpy(&h, data + at, sizeof(h));
+    if (h.magic != BLOCK_MAGIC || h.bytes > length - at - sizeof(h)) break;
+    if (!columns_valid(data + at + sizeof(h), h.rounds, h.bytes)) break;
+    offsets.push_back(at);
+    total_rounds += h.rounds;
+    at += sizeof(h) + h.bytes;
+  }
+}
+
+TraceReader::~TraceReader() {
+  ::munmap(const_cast<std::byte*>(data), length);
+}
+
+/**
+ * @brief Decodes block i into out, replacing its contents.
+ *
+ * @param i Block index, below blocks()
+ * @param out Receives the block's columns
+ */
+void TraceReader::decode(std::size_t i, TraceBlock& out) const {
+  BlockHeader h;
+  std::memcpy(&h, data + offsets.at(i), sizeof(h));
+  const std::byte* p = data + offsets[i] + sizeof(h);
+  thread_local std::vector<std::uint64_t> scratch;
+  p = decode_column(p, h.rounds, scratch, out.session);
+  p = decode_column(p, h.rounds, scratch, out.round);
+  p = decode_column(p, h.rounds, scratch, out.first);
+  p = decode_column(p, h.rounds, scratch, out.second);
+  p = decode_column(p, h.rounds, scratch, out.third);
+  p = decode_column(p, h.rounds, scratch, out.outcome);
+  p = decode_column(p, h.rounds, scratch, out.bet);
+  decode_column(p, h.rounds, scratch, out.balance);
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <span>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief How a traced round ended.
+ */
+enum class TraceOutcome : std::uint8_t { Chicken, TooMuch, Win, Lose, Push };
+
+/**
+ * @brief One round as traced: who, which cards, the bet and the result.
+ */
+struct TraceRound {
+  std::uint64_t session = 0;
+  std::uint32_t round = 0;
+  std::uint8_t first = 0;   ///< Cards 2 to 14; third is 0 if it was not dealt
+  std::uint8_t second = 0;
+  std::uint8_t third = 0;
+  TraceOutcome outcome = TraceOutcome::Chicken;
+  std::int32_t bet = 0;
+  std::int64_t balance = 0;  ///< After the round
+};
+
+/**
+ * @brief A decoded block of rounds, one array per column.
+ */
+struct TraceBlock {
+  std::vector<std::uint64_t> session;
+  std::vector<std::uint32_t> round;
+  std::vector<std::uint8_t> first, second, third, outcome;
+  std::vector<std::int32_t> bet;
+  std::vector<std::int64_t> balance;
+
+  std::size_t size() const { return session.size(); }
+  void clear();
+  void push_back(const TraceRound& r);
+  TraceRound operator[](std::size_t i) const;
+};
+
+/**
+ * @brief Streams rounds to a columnar trace file without blocking on disk.
+ *
+ * Rounds are appended to an in-memory block of up to block_rounds rows,
+ * stored column by column. A full block is handed to a background thread
+ * through a bounded queue; that thread encodes each column and writes it.
+ * append() waits only if queue_depth blocks are already waiting, which
+ * means the background thread, encoding or writing to disk, has fallen
+ * behind; such waits are counted in stalls().
+ *
+ * Each column in a block is stored as fixed-width bit-packed integers,
+ * either as offsets from the column minimum or as zigzag-encoded deltas
+ * from the previous row, whichever is smaller. Session and round ids and
+ * balances usually change by little from row to row, and cards fit in
+ * four bits, so a round takes a few bytes.
+ */
+class TraceWriter {
+public:
+  static constexpr std::size_t DEFAULT_BLOCK_ROUNDS = 65536;
+  static constexpr std::size_t DEFAULT_QUEUE_DEPTH = 4;
+
+  /**
+   * @brief Creates or truncates the trace file and starts the encoder thread.
+   *
+   * @throws std::system_error if the file cannot be created
+   */
+  explicit TraceWriter(const std::filesystem::path& path, std::size_t block_rounds = DEFAULT_BLOCK_ROUNDS,
+                       std::size_t queue_depth = DEFAULT_QUEUE_DEPTH);
+
+  /**
+   * @brief Flushes the last partial block and closes the file.
+   */
+  ~TraceWriter();
+
+  TraceWriter(const TraceWriter&) = delete;
+  TraceWriter& operator=(const TraceWriter&) = delete;
+
+  void append(const TraceRound& r);
+
+  /**
+   * @brief Hands the current partial block to the encoder and waits until everything is written.
+   *
+   * @throws std::system_error if the encoder failed to write
+   */
+  void flush();
+
+  std::uint64_t rounds() const { return appended; }
+  std::uint64_t bytes_written() const;
+  std::uint64_t stalls() const { return stall_count; }
+
+private:
+  void submit();
+  void encode_loop(std::stop_token stop);
+
+  int fd = -1;
+  std::size_t block_rounds;
+  std::size_t queue_depth;
+  TraceBlock current;
+  std::uint64_t appended = 0;
+  std::uint64_t stall_count = 0;
+
+  mutable std::mutex mutex;
+  std::condition_variable_any ready;  ///< A block was queued, or the writer is stopping
+  std::condition_variable_any space;  ///< A block was written
+  std::deque<TraceBlock> queue;
+  std::vector<TraceBlock> spare;      ///< Written blocks, kept to reuse their storage
+  std::size_t in_flight = 0;          ///< Blocks queued or being encoded
+  std::uint64_t written = 0;
+  int error = 0;                      ///< errno of a failed write
+  std::jthread encoder;
+};
+
+/**
+ * @brief Reads a trace file written by TraceWriter.
+ *
+ * The file is mapped and its blocks indexed on open, so blocks can be
+ * decoded independently and in parallel.
+ */
+class TraceReader {
+public:
+  /**
+   * @brief Maps the file and indexes its blocks.
+   *
+   * @throws std::system_error if the file cannot be opened or mapped
+   * @throws std::runtime_error if it is not a trace file
+   */
+  explicit TraceReader(const std::filesystem::path& path);
+  ~TraceReader();
+
+  TraceReader(const TraceReader&) = delete;
+  TraceReader& operator=(const TraceReader&) = delete;
+
+  std::size_t blocks() const { return offsets.size(); }
+  std::uint64_t rounds() const { return total_rounds; }
+  std::uint64_t bytes() const { return length; }
+
+  /**
+   * @brief Decodes block i into out, replacing its contents.
+   */
+  void decode(std::size_t i, TraceBlock& out) const;
+
+private:
+  const std::byte* data = nullptr;
+  std::size_t length = 0;
+  std::vector<std::size_t> offsets;
+  std::uint64_t total_rounds = 0;
+};
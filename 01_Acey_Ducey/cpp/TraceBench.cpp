@@ -0,0 +1,229 @@
+#include "Trace.hpp"
+#include "AceyDuceyRules.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <print>
+#include <random>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+unsigned worker_count(unsigned threads) {
+  return threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+}
+
+/**
+ * @brief Aggregates computed while writing and again while reading, to check the round trip.
+ */
+struct Totals {
+  std::uint64_t rounds = 0;
+  std::uint64_t wins = 0;
+  std::int64_t staked = 0;
+  std::int64_t balance_sum = 0;
+  std::uint64_t card_sum = 0;
+
+  void add(const TraceRound& r) {
+    ++rounds;
+    wins += r.outcome == TraceOutcome::Win;
+    staked += r.bet;
+    balance_sum += r.balance;
+    card_sum += r.first + r.second + r.third;
+  }
+
+  bool operator==(const Totals&) const = default;
+};
+
+/**
+ * @brief Plays rounds for a pool of interleaved sessions, as a busy server would, and traces them if trace is set.
+ *
+ * @return Aggregates of the rounds played
+ */
+Totals play(TraceWriter* trace, std::uint64_t rounds, unsigned sessions, std::uint64_t seed) {
+  struct Session {
+    std::uint64_t id;
+    std::uint32_t round = 0;
+    std::int64_t balance = acey_ducey::STARTING_BALANCE;
+  };
+  std::mt19937_64 rng(seed);
+  std::uniform_int_distribution<int> card(acey_ducey::LOWEST_CARD, acey_ducey::HIGHEST_CARD);
+  std::uniform_int_distribution<unsigned> pick(0, sessions - 1);
+  std::vector<Session> pool(sessions);
+  std::uint64_t next_id = 1'000'000;
+  for (Session& s : pool) s.id = next_id++;
+
+  Totals totals;
+  for (std::uint64_t i = 0; i < rounds; ++i) {
+    Session& s = pool[pick(rng)];
+    const int a = card(rng), b = card(rng);
+    TraceRound r{s.id, ++s.round, static_cast<std::uint8_t>(a), static_cast<std::uint8_t>(b), 0,
+                 TraceOutcome::Chicken, 0, 0};
+    if (std::abs(a - b) > 2) {
+      const int c = card(rng);
+      r.third = static_cast<std::uint8_t>(c);
+      r.bet = static_cast<std::int32_t>(std::min<std::int64_t>(s.balance, 1 + (i % 25)));
+      const std::int32_t delta = acey_ducey::settle(a, b, c, r.bet);
+      s.balance += delta;
+      r.outcome = delta > 0 ? TraceOutcome::Win : TraceOutcome::Lose;
+    }
+    r.balance = s.balance;
+    if (trace) trace->append(r);
+    totals.add(r);
+    if (s.balance <= 0) s = Session{next_id++};
+  }
+  return totals;
+}
+
+/**
+ * @brief Decodes every block on several threads and aggregates the rounds.
+ */
+Totals scan(const TraceReader& reader, unsigned threads) {
+  std::atomic<std::size_t> next{0};
+  std::vector<Totals> partial(threads);
+  {
+    std::vector<std::jthread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+      workers.emplace_back([&, t] {
+        TraceBlock block;
+        Totals& mine = partial[t];
+        for (std::size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < reader.blocks();) {
+          reader.decode(i, block);
+          // Column at a time, as an analysis query would.
+          mine.rounds += block.size();
+          for (std::uint8_t o : block.outcome) mine.wins += o == static_cast<std::uint8_t>(TraceOutcome::Win);
+          for (std::int32_t b : block.bet) mine.staked += b;
+          for (std::int64_t b : block.balance) mine.balance_sum += b;
+          for (std::size_t j = 0; j < block.size(); ++j) {
+            mine.card_sum += block.first[j] + block.second[j] + block.third[j];
+          }
+        }
+      });
+    }
+  }
+  Totals all;
+  for (const Totals& p : partial) {
+    all.rounds += p.rounds;
+    all.wins += p.wins;
+    all.staked += p.staked;
+    all.balance_sum += p.balance_sum;
+    all.card_sum += p.card_sum;
+  }
+  return all;
+}
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+double cpu_seconds(clockid_t clock) {
+  timespec ts{};
+  ::clock_gettime(clock, &ts);
+  return static_cast<double>(ts.tv_sec) + ts.tv_nsec / 1e9;
+}
+
+}  // namespace
+
+/**
+ * @brief Entry point for the trace benchmark.
+ *
+ * Plays the same rounds twice, without and with tracing, and compares the
+ * playing thread's CPU time to get the writer's cost per round there; the
+ * encoder thread's CPU time is reported separately. Then reads the file
+ * back on several threads and checks the aggregates match.
+ *
+ * Without --file the trace goes in a new directory the benchmark makes in
+ * the system temporary directory and removes when it is done; a file
+ * named with --file is kept.
+ *
+ * Usage: TraceBench [--rounds N] [--sessions N] [--file PATH] [--threads N] [--block N]
+ */
+int main(int argc, char* argv[]) {
+  std::uint64_t rounds = 50'000'000;
+  unsigned sessions = 10'000;
+  std::filesystem::path path;
+  unsigned threads = 0;
+  std::size_t block = TraceWriter::DEFAULT_BLOCK_ROUNDS;
+
+  for (int i = 1; i + 1 < argc; i += 2) {
+    std::string_view flag = argv[i];
+    if (flag == "--rounds") {
+      rounds = std::stoull(argv[i + 1]);
+    } else if (flag == "--sessions") {
+      sessions = std::max(1u, static_cast<unsigned>(std::stoul(argv[i + 1])));
+    } else if (flag == "--file") {
+      path = argv[i + 1];
+    } else if (flag == "--threads") {
+      threads = static_cast<unsigned>(std::stoul(argv[i + 1]));
+    } else if (flag == "--block") {
+      block = std::stoull(argv[i + 1]);
+    } else {
+      std::println(stderr, "Usage: TraceBench [--rounds N] [--sessions N] [--file PATH] [--threads N] [--block N]");
+      return EXIT_FAILURE;
+    }
+  }
+  if (rounds == 0) {
+    std::println(stderr, "Error: --rounds must be at least 1");
+    return EXIT_FAILURE;
+  }
+
+  std::filesystem::path work;
+  try {
+    if (path.empty()) {
+      std::string name = (std::filesystem::temp_directory_path() / "TraceBench-XXXXXX").string();
+      if (!::mkdtemp(name.data())) throw std::system_error(errno, std::generic_category(), name);
+      work = name;
+      path = work / "trace.trc";
+    }
+
+    // CPU time of the playing thread is what play_turn would pay; the
+    // encoder's share shows up only in the process total.
+    double thread_start = cpu_seconds(CLOCK_THREAD_CPUTIME_ID);
+    const Totals expected = play(nullptr, rounds, sessions, 1);
+    const double baseline = cpu_seconds(CLOCK_THREAD_CPUTIME_ID) - thread_start;
+
+    std::uint64_t bytes = 0, stalls = 0;
+    const double process_start = cpu_seconds(CLOCK_PROCESS_CPUTIME_ID);
+    thread_start = cpu_seconds(CLOCK_THREAD_CPUTIME_ID);
+    double traced = 0;
+    {
+      TraceWriter trace(path, block);
+      play(&trace, rounds, sessions, 1);
+      traced = cpu_seconds(CLOCK_THREAD_CPUTIME_ID) - thread_start;
+      trace.flush();
+      bytes = trace.bytes_written();
+      stalls = trace.stalls();
+    }
+    const double encoder = cpu_seconds(CLOCK_PROCESS_CPUTIME_ID) - process_start - traced;
+
+    auto start = std::chrono::steady_clock::now();
+    TraceReader reader(path);
+    const Totals found = scan(reader, worker_count(threads));
+    const double read = seconds_since(start);
+
+    const double per_round = 1e9 / static_cast<double>(rounds);
+    std::println("ROUNDS: {}  SESSIONS: {}  BLOCKS: {}  FILE: {}", rounds, sessions, reader.blocks(), path.string());
+    std::println("SIZE: {:.1f} MB  {:.2f} BYTES/ROUND ({} BYTES UNENCODED)", bytes / 1e6,
+                 static_cast<double>(bytes) / static_cast<double>(rounds), sizeof(TraceRound));
+    std::println("PLAY: {:.1f} NS/ROUND  TRACED: {:.1f} NS/ROUND  WRITER OVERHEAD: {:.1f} NS/ROUND  STALLS: {}",
+                 baseline * per_round, traced * per_round, (traced - baseline) * per_round, stalls);
+    std::println("ENCODER THREAD: {:.1f} CPU NS/ROUND", encoder * per_round);
+    std::println("READ: {:.1f} M ROUNDS/SEC ON {} THREADS  MATCH: {}", rounds / read / 1e6, worker_count(threads),
+                 found == expected ? "YES" : "NO");
+    if (!work.empty()) std::filesystem::remove_all(work);
+    return found == expected ? EXIT_SUCCESS : EXIT_FAILURE;
+  } catch (const std::exception& e) {
+    std::println(stderr, "Error: {}", e.what());
+    if (!work.empty()) std::filesystem::remove_all(work);
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,133 @@
+#include "AceyDuceyVariants.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <print>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Pre-dealt rounds, so both settlement loops see the same cards.
+ */
+struct Hands {
+  std::vector<std::int8_t> first;
+  std::vector<std::int8_t> second;
+  std::vector<std::int8_t> third;
+  std::vector<std::int32_t> bet;
+};
+
+Hands deal(std::size_t rounds, std::uint64_t seed) {
+  std::mt19937_64 rng(seed);
+  std::uniform_int_distribution<int> card(acey_ducey::LOWEST_CARD, acey_ducey::HIGHEST_CARD);
+  std::uniform_int_distribution<std::int32_t> stake(1, 50);
+  Hands h;
+  h.first.resize(rounds);
+  h.second.resize(rounds);
+  h.third.resize(rounds);
+  h.bet.resize(rounds);
+  for (std::size_t i = 0; i < rounds; ++i) {
+    h.first[i] = static_cast<std::int8_t>(card(rng));
+    h.second[i] = static_cast<std::int8_t>(card(rng));
+    h.third[i] = static_cast<std::int8_t>(card(rng));
+    h.bet[i] = stake(rng);
+  }
+  return h;
+}
+
+/**
+ * @brief Net result of every round under Rules, with no flag tests in the loop.
+ */
+template <class Rules>
+[[gnu::noinline]] std::int64_t settle_all(const Hands& h) {
+  std::int64_t net = 0;
+  for (std::size_t i = 0; i < h.bet.size(); ++i) {
+    net += Rules::settle(h.first[i], h.second[i], h.third[i], h.bet[i]).delta;
+  }
+  return net;
+}
+
+/**
+ * @brief Net result of every round, testing the variant's flags in each one.
+ */
+[[gnu::noinline]] std::int64_t settle_all_runtime(const acey_ducey::Variant& v, const Hands& h) {
+  std::int64_t net = 0;
+  for (std::size_t i = 0; i < h.bet.size(); ++i) {
+    net += acey_ducey::settle_runtime(v, h.first[i], h.second[i], h.third[i], h.bet[i]).delta;
+  }
+  return net;
+}
+
+template <class F>
+double seconds_for(F&& f) {
+  auto start = std::chrono::steady_clock::now();
+  f();
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace
+
+/**
+ * @brief Entry point for the rule-variant benchmark.
+ *
+ * Settles the same pre-dealt rounds under each of the sixteen variants,
+ * once through the compile-time instantiation chosen by with_rules() and
+ * once through settle_runtime(), and checks that both give the same net.
+ * The retry flag only changes bet entry, so variants differing in it
+ * settle identically.
+ *
+ * Usage: VariantBench [--rounds N] [--passes N] [--seed N]
+ */
+int main(int argc, char* argv[]) {
+  std::size_t rounds = 10'000'000;
+  unsigned passes = 3;
+  std::uint64_t seed = 1;
+
+  for (int i = 1; i + 1 < argc; i += 2) {
+    std::string_view flag = argv[i];
+    if (flag == "--rounds") {
+      rounds = std::stoull(argv[i + 1]);
+    } else if (flag == "--passes") {
+      passes = static_cast<unsigned>(std::stoul(argv[i + 1]));
+    } else if (flag == "--seed") {
+      seed = std::stoull(argv[i + 1]);
+    } else {
+      std::println(stderr, "Usage: VariantBench [--rounds N] [--passes N] [--seed N]");
+      return EXIT_FAILURE;
+    }
+  }
+
+  const Hands hands = deal(rounds, seed);
+  std::println("ROUNDS: {}  PASSES: {} (BEST KEPT)", rounds, passes);
+  std::println("{:<32}  {:>12}  {:>12}  {:>7}  {:>12}", "VARIANT", "TEMPLATE NS", "RUNTIME NS", "SPEEDUP", "NET");
+
+  double template_total = 0;
+  double runtime_total = 0;
+  unsigned mismatches = 0;
+  for (int i = 0; i < acey_ducey::Variant::COUNT; ++i) {
+    const acey_ducey::Variant variant = acey_ducey::Variant::from_index(i);
+    std::int64_t net_template = 0;
+    std::int64_t net_runtime = 0;
+    double best_template = 1e300;
+    double best_runtime = 1e300;
+    for (unsigned p = 0; p < passes; ++p) {
+      best_template = std::min(best_template, seconds_for([&] {
+        net_template = acey_ducey::with_rules(variant, []<class Rules>(Rules) { return &settle_all<Rules>; })(hands);
+      }));
+      best_runtime = std::min(best_runtime, seconds_for([&] { net_runtime = settle_all_runtime(variant, hands); }));
+    }
+    if (net_template != net_runtime) ++mismatches;
+    template_total += best_template;
+    runtime_total += best_runtime;
+
+    const double per = 1e9 / static_cast<double>(rounds);
+    std::println("{:<32}  {:>12.2f}  {:>12.2f}  {:>6.2f}x  {:>12}", variant.name(), best_template * per,
+                 best_runtime * per, best_runtime / best_template, net_template);
+  }
+  std::println("ALL VARIANTS: {:.2f}x  MISMATCHES: {}", runtime_total / template_total, mismatches);
+  return mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,87 @@
+#ifndef ACEY_DUCEY_H
+#define ACEY_DUCEY_H
+
+/*
+ * Stable C interface to the Acey Ducey rules engine.
+ *
+ * Cards are numbered 2 to 14 (J = 11, Q = 12, K = 13, A = 14). Functions
+ * that can fail return a negative ACEY_E_* code; no C++ exception ever
+ * crosses this interface. Sessions are not thread-safe, but distinct
+ * sessions may be used from different threads at once.
+ *
+ * Compatibility: functions are only ever added, never changed. A caller
+ * built against ACEY_ABI_VERSION n works with any library whose
+ * acey_abi_version() is n or greater with the same major (high 16 bits).
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#  if defined(ACEY_DUCEY_BUILD)
+#    define ACEY_API __declspec(dllexport)
+#  else
+#    define ACEY_API __declspec(dllimport)
+#  endif
+#else
+#  define ACEY_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ACEY_ABI_VERSION 0x00010000u /* 1.0 */
+
+/* Round results from acey_session_settle. */
+#define ACEY_CHICKEN 0      /* Bet of zero: no third card, balance unchanged */
+#define ACEY_WIN 1          /* Third card was strictly between the first two */
+#define ACEY_LOSE 2         /* It was not */
+#define ACEY_BET_TOO_MUCH 3 /* Bet exceeds balance; the hand stays open for another bet */
+
+/* Error codes. */
+#define ACEY_E_INVALID (-1) /* Null pointer or argument out of range */
+#define ACEY_E_STATE (-2)   /* Settle without a dealt hand, or deal with one still open */
+
+typedef struct acey_session acey_session;
+
+/* Version of the library actually loaded, to compare with ACEY_ABI_VERSION. */
+ACEY_API uint32_t acey_abi_version(void);
+
+/*
+ * Creates a session with its own random stream. A starting balance of zero
+ * or less uses the game's $100. Returns NULL if memory runs out.
+ */
+ACEY_API acey_session* acey_session_create(uint64_t seed, int32_t balance);
+
+/* Destroys a session; NULL is ignored. */
+ACEY_API void acey_session_destroy(acey_session* session);
+
+/* Current balance, or ACEY_E_INVALID for NULL. */
+ACEY_API int32_t acey_session_balance(const acey_session* session);
+
+/* Deals the two face-up cards into *first and *second. */
+ACEY_API int acey_session_deal(acey_session* session, int32_t* first, int32_t* second);
+
+/*
+ * Bets on the open hand. On ACEY_WIN or ACEY_LOSE the third card is stored
+ * in *third (which may be NULL) and the hand is closed. Returns one of the
+ * round results above or a negative error code.
+ */
+ACEY_API int acey_session_settle(acey_session* session, int32_t bet, int32_t* third);
+
+/*
+ * Evaluates n independent rounds in one call, reading and writing the
+ * caller's arrays in place. delta[i] receives +bet[i], -bet[i] or 0 as
+ * acey_session_settle would change the balance. delta may be the same
+ * array as any input. Returns 0, or ACEY_E_INVALID without writing delta
+ * if a pointer is NULL or, as acey_session_settle, any bet is negative.
+ */
+ACEY_API int acey_evaluate_rounds(const int32_t* first, const int32_t* second, const int32_t* third,
+                                  const int32_t* bet, int32_t* delta, size_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ACEY_DUCEY_H */
@@ -1,11 +1,102 @@
 #include "AceyDucey.hpp"
+#include "FairDeck.hpp"
+#include "Leaderboard.hpp"
+#include "Ledger.hpp"
+#include "Trace.hpp"
+#include "agent.h"
+#include <cerrno>
+#include <cstdlib>
+#include <memory>
+#include <optional>
+#include <print>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
 
 /**
  * @brief Entry point for the Acey Ducey card game.
  *
- * Creates a game instance and starts the game loop.
+ * Creates a game instance and starts the game loop. With --ledger the
+ * balance is loaded from and settled into a durable ledger, so it survives
+ * restarts; games for different players may share one ledger directory.
+ * With --leaderboard every settlement is published to the named
+ * shared-memory leaderboard. --variant picks house rules from posts-push,
+ * pair-bonus, spread and retry (comma-separated); the default is classic.
+ * With --trace every round is recorded in a columnar trace file. With
+ * --agent a program plays through the headless agent protocol on "-"
+ * (stdin and stdout), "tcp:PORT" or "unix:PATH"; see agent.h. With
+ * --fair the deals are provably fair, committed ROUNDS at a time: each
+ * commitment to the server seeds is published before the player chooses
+ * the client seed for its batch, and the seeds are revealed when the
+ * batch is used up and at the end, for AceyDuceyFair to verify; see
+ * FairDeck.hpp.
+ *
+ * Usage: AceyDucey [--ledger DIR] [--player ID] [--leaderboard NAME] [--variant LIST] [--trace FILE]
+ *                  [--agent TRANSPORT] [--fair ROUNDS]
  */
-int main() {
-  AceyDucey game;
-  game.run();
-}
\ No newline at end of file
+int main(int argc, char* argv[]) {
+  std::optional<std::filesystem::path> ledger_dir;
+  std::uint64_t player = 0;
+  std::optional<std::string> leaderboard_name;
+  std::string_view variant_names = "classic";
+  std::optional<std::filesystem::path> trace_path;
+  std::optional<std::string> agent_transport;
+  std::optional<std::size_t> fair_rounds;
+
+  bool usage = false;
+  try {
+    for (int i = 1; i + 1 < argc; i += 2) {
+      std::string_view flag = argv[i];
+      if (flag == "--ledger") {
+        ledger_dir = argv[i + 1];
+      } else if (flag == "--player") {
+        player = std::stoull(argv[i + 1]);
+      } else if (flag == "--leaderboard") {
+        leaderboard_name = argv[i + 1];
+      } else if (flag == "--variant") {
+        variant_names = argv[i + 1];
+      } else if (flag == "--trace") {
+        trace_path = argv[i + 1];
+      } else if (flag == "--agent") {
+        agent_transport = argv[i + 1];
+      } else if (flag == "--fair") {
+        fair_rounds = std::stoull(argv[i + 1]);
+      } else {
+        usage = true;
+        break;
+      }
+    }
+  } catch (const std::invalid_argument&) {  // an ID or count that is not a number
+    usage = true;
+  } catch (const std::out_of_range&) {
+    usage = true;
+  }
+  if (usage) {
+    std::println(stderr, "Usage: AceyDucey [--ledger DIR] [--player ID] [--leaderboard NAME] [--variant LIST] "
+                         "[--trace FILE] [--agent TRANSPORT] [--fair ROUNDS]");
+    return EXIT_FAILURE;
+  }
+
+  try {
+    const acey_ducey::Variant variant = acey_ducey::Variant::parse(variant_names);
+    std::unique_ptr<Ledger> ledger;
+    std::unique_ptr<Leaderboard> leaderboard;
+    if (ledger_dir) ledger = std::make_unique<Ledger>(*ledger_dir);
+    std::unique_ptr<TraceWriter> trace;
+    if (leaderboard_name) leaderboard = std::make_unique<Leaderboard>(*leaderboard_name);
+    if (trace_path) trace = std::make_unique<TraceWriter>(*trace_path);
+    std::unique_ptr<agent, decltype(&agent_close)> session(nullptr, agent_close);
+    if (agent_transport) {
+      session.reset(agent_open(agent_transport->c_str(), "aceyducey"));
+      if (!session) throw std::system_error(errno, std::generic_category(), *agent_transport);
+    }
+    std::unique_ptr<FairDeck> fair;
+    if (fair_rounds) fair = std::make_unique<FairDeck>(*fair_rounds);
+    run_game(variant, ledger.get(), player, leaderboard.get(), trace.get(), session.get(), fair.get());
+    if (trace) trace->flush();
+  } catch (const std::exception& e) {
+    std::println(stderr, "Error: {}", e.what());
+    return EXIT_FAILURE;
+  }
+}
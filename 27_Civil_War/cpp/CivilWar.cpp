@@ -0,0 +1,293 @@
+#include "CivilWar.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace civil_war {
+
+namespace {
+
+constexpr int FIELDS_PER_BATTLE = 6;  ///< READ C$(D),M1(D),M2(D),C1(D),C2(D),M(D)
+
+std::string_view trim(std::string_view text) {
+  const auto first = text.find_first_not_of(" \t\r");
+  if (first == std::string_view::npos) return {};
+  return text.substr(first, text.find_last_not_of(" \t\r") - first + 1);
+}
+
+/**
+ * @brief Splits the items of one DATA statement; quoted items keep their commas.
+ */
+std::vector<std::string> data_items(std::string_view items) {
+  std::vector<std::string> result;
+  std::size_t i = 0;
+  while (i <= items.size()) {
+    const std::size_t comma = [&] {
+      const std::size_t start = items.find_first_not_of(' ', i);
+      if (start != std::string_view::npos && items[start] == '"') {
+        const std::size_t close = items.find('"', start + 1);
+        return close == std::string_view::npos ? std::string_view::npos : items.find(',', close);
+      }
+      return items.find(',', i);
+    }();
+    const std::size_t end = comma == std::string_view::npos ? items.size() : comma;
+    result.emplace_back(trim(items.substr(i, end - i)));
+    i = end + 1;
+  }
+  return result;
+}
+
+double number(const std::string& item, std::size_t line) {
+  std::size_t used = 0;
+  double value = 0;
+  try {
+    value = std::stod(item, &used);
+  } catch (const std::exception&) {
+    used = 0;
+  }
+  if (used == 0 || used != item.size()) {
+    throw std::runtime_error("line " + std::to_string(line) + ": expected a number, found \"" + item + "\"");
+  }
+  return value;
+}
+
+}  // namespace
+
+/**
+ * @brief Battle table from BASIC source text.
+ *
+ * DATA items are read in program order and taken six at a time, as the
+ * READ loop on lines 84-88 does.
+ */
+std::vector<Battle> parse_battles(std::string_view source) {
+  std::vector<std::pair<std::string, std::size_t>> items;
+  std::size_t line_number = 0;
+  std::istringstream lines{std::string(source)};
+  for (std::string line; std::getline(lines, line);) {
+    ++line_number;
+    std::string_view statement = trim(line);
+    statement = trim(statement.substr(std::min(statement.find_first_not_of("0123456789"), statement.size())));
+    if (!statement.starts_with("DATA")) continue;
+    for (std::string& item : data_items(statement.substr(4))) items.emplace_back(std::move(item), line_number);
+  }
+  if (items.empty() || items.size() % FIELDS_PER_BATTLE != 0) {
+    throw std::runtime_error("DATA statements hold " + std::to_string(items.size()) +
+                             " items, not six per battle");
+  }
+
+  std::vector<Battle> battles;
+  for (std::size_t i = 0; i < items.size(); i += FIELDS_PER_BATTLE) {
+    const auto& [name, line] = items[i];
+    if (name.size() < 2 || name.front() != '"' || name.back() != '"') {
+      throw std::runtime_error("line " + std::to_string(line) + ": expected a quoted battle name");
+    }
+    Battle battle{name.substr(1, name.size() - 2),
+                  number(items[i + 1].first, items[i + 1].second),
+                  number(items[i + 2].first, items[i + 2].second),
+                  number(items[i + 3].first, items[i + 3].second),
+                  number(items[i + 4].first, items[i + 4].second),
+                  static_cast<int>(number(items[i + 5].first, items[i + 5].second))};
+    if (battle.confederate_men <= 0 || battle.union_men <= 0 || battle.confederate_casualties <= 0 ||
+        battle.union_casualties <= 0) {
+      throw std::runtime_error("line " + std::to_string(line) + ": men and casualties must be positive");
+    }
+    battles.push_back(std::move(battle));
+  }
+  return battles;
+}
+
+std::vector<Battle> load_battles(const std::filesystem::path& program) {
+  std::ifstream in(program);
+  if (!in) throw std::runtime_error("cannot read " + program.string());
+  std::ostringstream source;
+  source << in.rdbuf();
+  return parse_battles(source.str());
+}
+
+/**
+ * @brief Parses FOOD,SALARIES,AMMUNITION,TACTIC.
+ */
+Plan Plan::parse(std::string_view spec) {
+  std::vector<std::string> fields = data_items(spec);
+  if (fields.size() != 4) throw std::invalid_argument("plan must be FOOD,SALARIES,AMMUNITION,TACTIC");
+  Plan plan;
+  plan.name = std::string(spec);
+  try {
+    plan.food = std::stod(fields[0]);
+    plan.salaries = std::stod(fields[1]);
+    plan.ammunition = std::stod(fields[2]);
+  } catch (const std::exception&) {
+    throw std::invalid_argument("plan shares must be numbers: " + std::string(spec));
+  }
+  if (plan.food < 0 || plan.salaries < 0 || plan.ammunition < 0 ||
+      plan.food + plan.salaries + plan.ammunition > 1 + 1e-9) {
+    throw std::invalid_argument("plan shares must be non-negative and sum to at most 1");
+  }
+  std::string& tactic = fields[3];
+  std::ranges::transform(tactic, tactic.begin(), [](unsigned char c) { return std::toupper(c); });
+  if (tactic == "RANDOM") {
+    plan.tactic = Tactic::Random;
+  } else if (tactic == "COUNTER") {
+    plan.tactic = Tactic::Counter;
+  } else if (tactic.size() == 1 && tactic[0] >= '1' && tactic[0] <= '0' + STRATEGIES) {
+    plan.tactic = Tactic::Fixed;
+    plan.strategy = tactic[0] - '0';
+  } else {
+    throw std::invalid_argument("tactic must be 1-4, RANDOM or COUNTER");
+  }
+  return plan;
+}
+
+double Campaign::money(const Battle& battle) const {
+  const double inflation = 10 + (losses - wins) * 2;  // I1
+  return 100 * std::floor((battle.confederate_men * (100 - inflation) / 2000) *
+                              (1 + (money_base - money_spent) / (money_base + 1)) +
+                          .5);
+}
+
+/**
+ * @brief Lines 1060-1080, 1620, 2200-2260, 2500-2510 and 2570-2780 for one general.
+ *
+ * Morale O comes from food and salaries, the Confederate losses C5 from the
+ * actual losses, the strategies, morale and ammunition, and the Union
+ * losses from C5. The Union's strategy is drawn from its weights as
+ * lines 3180-3270 do, and the weights then learn the South's choice.
+ */
+Campaign::Outcome Campaign::fight(const Battle& battle, double food, double salaries, double ammunition,
+                                  int strategy, double roll) {
+  const double inflation = 10 + (losses - wins) * 2;
+  const double f1 = 5 * battle.confederate_men / 6;
+  const double morale = (2 * food * food + salaries * salaries) / (f1 * f1) + 1;
+
+  // With no weight left above the roll the FOR loop falls through with I=5, as in the original.
+  int union_strategy = 1;
+  for (double s0 = 0; union_strategy <= STRATEGIES; ++union_strategy) {
+    s0 += weights[union_strategy - 1];
+    if (100 * roll < s0) break;
+  }
+
+  const double men = battle.confederate_men * (1 + (actual_losses - simulated_losses) / (men_fielded + 1));
+  double c5 = (2 * battle.confederate_casualties / 5) * (1 + 1 / (2 * (std::abs(union_strategy - strategy) + 1.0)));
+  c5 = std::floor(c5 * (1 + 1 / morale) * (1.28 + f1 / (ammunition + 1)) + .5);
+  double desertions = 100 / morale;  // E
+  bool routed = false;               // U
+  if (c5 + 100 / morale >= men) {
+    c5 = std::floor(13 * battle.confederate_men / 20 * (1 + (actual_losses - simulated_losses) / (men_fielded + 1)));
+    desertions = 7 * c5 / 13;
+    routed = true;
+  }
+  const double union_losses = 17 * battle.union_casualties * battle.confederate_casualties / (c5 * 20);
+  const bool won = !routed && c5 + desertions < union_losses + 5 * morale;
+
+  (won ? wins : losses)++;
+  simulated_losses += c5 + desertions;
+  actual_losses += battle.confederate_casualties;
+  money_spent += food + salaries + ammunition;
+  money_base += battle.confederate_men * (100 - inflation) / 20;
+  men_fielded += battle.confederate_men;
+
+  // Lines 3330-3400: the South's strategy gains what the others above the floor lose.
+  double gained = 0;
+  for (double& weight : weights) {
+    if (weight <= FORGET_FLOOR) continue;
+    weight -= LEARNING_STEP;
+    gained += LEARNING_STEP;
+  }
+  weights[strategy - 1] += gained;
+
+  return {c5, std::floor(union_losses), won, union_strategy};
+}
+
+int BattleStats::percentile(double q) const {
+  std::uint64_t total = 0;
+  for (std::uint64_t n : histogram) total += n;
+  const double target = q * static_cast<double>(total);
+  std::uint64_t seen = 0;
+  for (int b = 0; b < CASUALTY_BUCKETS; ++b) {
+    seen += histogram[b];
+    if (seen > 0 && static_cast<double>(seen) >= target) return (b + 1) * CASUALTY_BUCKET;
+  }
+  return CASUALTY_BUCKETS * CASUALTY_BUCKET;
+}
+
+/**
+ * @brief Plays complete campaigns on several threads.
+ *
+ * Each worker keeps its own per-battle totals, merged once at the end.
+ */
+CampaignResult simulate(const std::vector<Battle>& battles, const Plan& plan, std::uint64_t games,
+                        unsigned threads, std::uint64_t seed) {
+  if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+  struct Totals {
+    std::uint64_t games = 0, wars_won = 0;
+    std::vector<BattleStats> battles;
+    std::vector<std::uint64_t> battles_won;
+  };
+  std::vector<Totals> totals(threads);
+
+  const auto start = std::chrono::steady_clock::now();
+  {
+    std::vector<std::jthread> workers;
+    for (unsigned w = 0; w < threads; ++w) {
+      workers.emplace_back([&, w] {
+        std::mt19937_64 rng(seed + w);
+        std::uniform_real_distribution<double> rnd(0.0, 1.0);
+        Totals& t = totals[w];
+        t.battles.resize(battles.size());
+        t.battles_won.resize(battles.size() + 1);
+        const std::uint64_t my_games = games / threads + (w < games % threads ? 1 : 0);
+
+        for (std::uint64_t g = 0; g < my_games; ++g) {
+          Campaign campaign;
+          for (std::size_t b = 0; b < battles.size(); ++b) {
+            const Battle& battle = battles[b];
+            const double money = std::max(campaign.money(battle), 0.0);
+            const int strategy = campaign.choose(plan, rng);
+            const Campaign::Outcome outcome =
+                campaign.fight(battle, std::floor(plan.food * money), std::floor(plan.salaries * money),
+                               std::floor(plan.ammunition * money), strategy, rnd(rng));
+
+            BattleStats& stats = t.battles[b];
+            stats.won += outcome.won;
+            stats.confederate_casualties += outcome.confederate_casualties;
+            stats.union_casualties += outcome.union_casualties;
+            const double percent = 100 * outcome.confederate_casualties / battle.confederate_casualties;
+            const int bucket = static_cast<int>(std::clamp(percent / CASUALTY_BUCKET, 0.0,
+                                                           static_cast<double>(CASUALTY_BUCKETS - 1)));
+            ++stats.histogram[bucket];
+          }
+          ++t.games;
+          t.wars_won += campaign.won_war();
+          ++t.battles_won[campaign.won()];
+        }
+      });
+    }
+  }
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  CampaignResult result;
+  result.battles.resize(battles.size());
+  result.battles_won.resize(battles.size() + 1);
+  for (const Totals& t : totals) {
+    result.games += t.games;
+    result.wars_won += t.wars_won;
+    for (std::size_t b = 0; b < t.battles.size(); ++b) {
+      BattleStats& stats = result.battles[b];
+      stats.won += t.battles[b].won;
+      stats.confederate_casualties += t.battles[b].confederate_casualties;
+      stats.union_casualties += t.battles[b].union_casualties;
+      for (int i = 0; i < CASUALTY_BUCKETS; ++i) stats.histogram[i] += t.battles[b].histogram[i];
+    }
+    for (std::size_t n = 0; n < t.battles_won.size(); ++n) result.battles_won[n] += t.battles_won[n];
+  }
+  result.seconds = elapsed.count();
+  return result;
+}
+
+}  // namespace civil_war
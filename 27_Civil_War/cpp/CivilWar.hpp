@@ -0,0 +1,209 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Headless campaigns of CIVIL WAR (civilwar.bas) for one general
+ * against the computer's Union.
+ *
+ * The battle tables are read from the DATA statements of the BASIC program
+ * itself, so battles added there (as its line 3420 invites) are simulated
+ * too. Every formula keeps the original's floating-point arithmetic and its
+ * INT truncations, including the cumulative factors that make each battle's
+ * money and men depend on the battles before it.
+ */
+namespace civil_war {
+
+inline constexpr int STRATEGIES = 4;          ///< Artillery, frontal, flanking, encirclement
+inline constexpr double LEARNING_STEP = 3;    ///< Probability points moved to the South's last strategy (line 3330)
+inline constexpr double FORGET_FLOOR = 5;     ///< Strategies at or below this many points are not forgotten further
+inline constexpr int CASUALTY_BUCKET = 5;     ///< Width of a casualty histogram bucket in percent of the actual losses
+inline constexpr int CASUALTY_BUCKETS = 101;  ///< The last bucket holds 500% and above
+
+/**
+ * @brief One row of the DATA table (lines 3440-3570).
+ */
+struct Battle {
+  std::string name;
+  double confederate_men;          ///< M1
+  double union_men;                ///< M2
+  double confederate_casualties;   ///< C1, the actual losses
+  double union_casualties;         ///< C2
+  int situation;                   ///< M: 1 defensive, 2 both on the offensive, 3 offensive
+};
+
+/**
+ * @brief Reads the battle table from the DATA statements of a BASIC program.
+ *
+ * @param program Path to civilwar.bas
+ * @return Battles in program order
+ * @throws std::runtime_error if the file cannot be read or a row is malformed
+ */
+std::vector<Battle> load_battles(const std::filesystem::path& program);
+
+/**
+ * @brief Battle table from BASIC source text.
+ */
+std::vector<Battle> parse_battles(std::string_view source);
+
+/**
+ * @brief How the simulated general picks a strategy each battle.
+ */
+enum class Tactic {
+  Fixed,   ///< Always the same strategy
+  Random,  ///< Uniformly among the four
+  Counter  ///< The one farthest, on average, from what Union intelligence expects
+};
+
+/**
+ * @brief An allocation strategy: the share of the money available spent on
+ * each item every battle, and how the battle strategy is chosen.
+ */
+struct Plan {
+  std::string name;
+  double food = 0;        ///< Fractions of the money available; their sum is at most 1
+  double salaries = 0;
+  double ammunition = 0;
+  Tactic tactic = Tactic::Random;
+  int strategy = 1;       ///< Used by Tactic::Fixed
+
+  /**
+   * @brief Parses FOOD,SALARIES,AMMUNITION,TACTIC, where TACTIC is 1-4, RANDOM or COUNTER.
+   *
+   * @throws std::invalid_argument if the specification is malformed
+   */
+  static Plan parse(std::string_view spec);
+};
+
+/**
+ * @brief The state a campaign carries from battle to battle (lines 600-610,
+ * 2610-2780) and the Union's learned estimate of Southern strategy.
+ */
+class Campaign {
+public:
+  /**
+   * @brief What one battle did to both sides.
+   */
+  struct Outcome {
+    double confederate_casualties;  ///< C5
+    double union_casualties;        ///< C6
+    bool won;                       ///< For the Confederacy
+    int union_strategy;             ///< Y2
+  };
+
+  /**
+   * @brief Confederate money available for a battle (line 1010).
+   */
+  double money(const Battle& battle) const;
+
+  /**
+   * @brief Fights a battle and applies its cumulative effects.
+   *
+   * @param battle Battle to fight
+   * @param food Dollars spent on food; with salaries and ammunition at most money(battle)
+   * @param salaries Dollars spent on salaries
+   * @param ammunition Dollars spent on ammunition
+   * @param strategy Confederate strategy, 1 to 4
+   * @param roll RND(0) for the Union's choice of strategy
+   * @return Casualties and the winner
+   */
+  Outcome fight(const Battle& battle, double food, double salaries, double ammunition, int strategy,
+                double roll);
+
+  /**
+   * @brief Strategy the plan chooses against the current Union intelligence.
+   */
+  template <typename Rng>
+  int choose(const Plan& plan, Rng& rng) const;
+
+  /**
+   * @brief The Union's current weights for strategies 1 to 4, summing to 100.
+   */
+  const std::array<double, STRATEGIES>& intelligence() const { return weights; }
+
+  int won() const { return wins; }
+  int lost() const { return losses; }
+
+  /**
+   * @brief Line 2910: the Confederacy wins the war with more battles won than lost.
+   */
+  bool won_war() const { return wins > losses; }
+
+private:
+  std::array<double, STRATEGIES> weights{25, 25, 25, 25};  ///< S
+  int wins = 0;                                            ///< W
+  int losses = 0;                                          ///< L
+  double money_base = 0;                                   ///< R1, money the battles so far provided
+  double money_spent = 0;                                  ///< Q1
+  double actual_losses = 0;                                ///< P1
+  double simulated_losses = 0;                             ///< T1
+  double men_fielded = 0;                                  ///< M3
+};
+
+template <typename Rng>
+int Campaign::choose(const Plan& plan, Rng& rng) const {
+  switch (plan.tactic) {
+    case Tactic::Fixed:
+      return plan.strategy;
+    case Tactic::Random:
+      return std::uniform_int_distribution<int>(1, STRATEGIES)(rng);
+    case Tactic::Counter:
+      break;
+  }
+  // Casualties fall as the strategies drift apart (line 2200), so maximise the expected distance.
+  int best = 1;
+  double best_distance = -1;
+  for (int y = 1; y <= STRATEGIES; ++y) {
+    double distance = 0;
+    for (int i = 1; i <= STRATEGIES; ++i) distance += weights[i - 1] * std::abs(i - y);
+    if (distance > best_distance) best = y, best_distance = distance;
+  }
+  return best;
+}
+
+/**
+ * @brief Results for one battle across every simulated campaign.
+ */
+struct BattleStats {
+  std::uint64_t won = 0;
+  double confederate_casualties = 0;  ///< Sums over campaigns
+  double union_casualties = 0;
+  std::array<std::uint64_t, CASUALTY_BUCKETS> histogram{};  ///< Confederate casualties as % of the actual
+
+  /**
+   * @brief Confederate casualties as a percentage of the actual at quantile q, to the bucket's upper edge.
+   */
+  int percentile(double q) const;
+};
+
+/**
+ * @brief Aggregate results of simulated campaigns.
+ */
+struct CampaignResult {
+  std::uint64_t games = 0;
+  std::uint64_t wars_won = 0;
+  std::vector<BattleStats> battles;         ///< In table order
+  std::vector<std::uint64_t> battles_won;   ///< Campaigns by number of battles won, 0 to battles.size()
+  double seconds = 0;
+};
+
+/**
+ * @brief Plays complete campaigns, every battle of the table in order, on several threads.
+ *
+ * @param battles Battle table
+ * @param plan Allocation strategy of the Confederate general
+ * @param games Number of campaigns
+ * @param threads Worker count; 0 uses the hardware concurrency
+ * @param seed Base seed, each worker uses seed + worker index
+ */
+CampaignResult simulate(const std::vector<Battle>& battles, const Plan& plan, std::uint64_t games,
+                        unsigned threads = 0, std::uint64_t seed = 1);
+
+}  // namespace civil_war
@@ -0,0 +1,156 @@
+#include "CivilWar.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <format>
+#include <print>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifndef CIVIL_WAR_PROGRAM
+#define CIVIL_WAR_PROGRAM "../civilwar.bas"
+#endif
+
+/**
+ * @brief Prints the per-battle victory and casualty distributions of one plan.
+ *
+ * @param battles Battle table
+ * @param r Results of the plan
+ */
+void print_battles(const std::vector<civil_war::Battle>& battles, const civil_war::CampaignResult& r) {
+  std::println("{:<18}{:>8}{:>12}{:>7}{:>7}{:>7}{:>12}", "BATTLE", "WON", "CSA LOSSES", "P10", "P50", "P90",
+               "USA LOSSES");
+  for (std::size_t b = 0; b < battles.size(); ++b) {
+    const civil_war::BattleStats& s = r.battles[b];
+    std::println("{:<18}{:>7.1f}%{:>12.0f}{:>6}%{:>6}%{:>6}%{:>12.0f}", battles[b].name, 100.0 * s.won / r.games,
+                 s.confederate_casualties / r.games, s.percentile(0.1), s.percentile(0.5), s.percentile(0.9),
+                 s.union_casualties / r.games);
+  }
+  std::print("BATTLES WON:");
+  for (std::size_t n = 0; n < r.battles_won.size(); ++n) {
+    if (r.battles_won[n] > 0) std::print(" {}:{:.1f}%", n, 100.0 * r.battles_won[n] / r.games);
+  }
+  std::println("");
+}
+
+/**
+ * @brief Prints the summary line of one plan.
+ */
+void print_summary(std::string_view name, const civil_war::CampaignResult& r) {
+  double battles_won = 0;
+  for (std::size_t n = 0; n < r.battles_won.size(); ++n) battles_won += static_cast<double>(n * r.battles_won[n]);
+  std::println("{:<28}{:>9.2f}%{:>12.2f}{:>14.0f}", name, 100.0 * r.wars_won / r.games, battles_won / r.games,
+               r.games / r.seconds);
+}
+
+/**
+ * @brief Entry point for the CIVIL WAR campaign simulator.
+ *
+ * Plays every battle of civilwar.bas in order as the Confederacy against
+ * the computer's Union, once per campaign, under each allocation plan. A
+ * plan is FOOD,SALARIES,AMMUNITION,TACTIC: the share of the money
+ * available spent on each, and 1-4, RANDOM or COUNTER for the strategy.
+ * Without --plan a set of built-in plans is compared. --grid N instead
+ * tries every allocation in steps of 1/N with each tactic and lists the
+ * best.
+ *
+ * Usage: CivilWarSim [--program FILE] [--games N] [--threads N] [--seed N] [--plan SPEC]... [--grid N]
+ */
+int main(int argc, char* argv[]) {
+  std::string program = CIVIL_WAR_PROGRAM;
+  std::uint64_t games = 100'000;
+  unsigned threads = 0;
+  std::uint64_t seed = 1;
+  std::vector<std::string> specs;
+  int grid = 0;
+
+  for (int i = 1; i + 1 < argc; i += 2) {
+    std::string_view flag = argv[i];
+    if (flag == "--program") {
+      program = argv[i + 1];
+    } else if (flag == "--games") {
+      games = std::stoull(argv[i + 1]);
+    } else if (flag == "--threads") {
+      threads = static_cast<unsigned>(std::stoul(argv[i + 1]));
+    } else if (flag == "--seed") {
+      seed = std::stoull(argv[i + 1]);
+    } else if (flag == "--plan") {
+      specs.emplace_back(argv[i + 1]);
+    } else if (flag == "--grid") {
+      grid = std::stoi(argv[i + 1]);
+    } else {
+      std::println(stderr, "Usage: CivilWarSim [--program FILE] [--games N] [--threads N] [--seed N] "
+                           "[--plan SPEC]... [--grid N]");
+      return EXIT_FAILURE;
+    }
+  }
+  if (argc % 2 == 0 || games == 0) {
+    std::println(stderr, "Usage: CivilWarSim [--program FILE] [--games N] [--threads N] [--seed N] "
+                         "[--plan SPEC]... [--grid N]");
+    return EXIT_FAILURE;
+  }
+
+  try {
+    if (specs.empty()) {
+      specs = {"0.333,0.333,0.333,RANDOM", "0.333,0.333,0.333,COUNTER", "0.6,0.2,0.2,COUNTER",
+               "0.2,0.6,0.2,COUNTER",      "0.2,0.2,0.6,COUNTER",       "0,0,0,COUNTER"};
+    }
+    std::vector<civil_war::Plan> plans;
+    for (const std::string& spec : specs) plans.push_back(civil_war::Plan::parse(spec));
+    const std::vector<civil_war::Battle> battles = civil_war::load_battles(program);
+    std::println("{} BATTLES FROM {}, {} CAMPAIGNS PER PLAN", battles.size(), program, games);
+    std::println("");
+
+    if (grid > 0) {
+      struct Scored {
+        std::string name;
+        civil_war::CampaignResult result;
+      };
+      std::vector<Scored> scored;
+      double seconds = 0;
+      std::uint64_t played = 0;
+      for (std::string_view tactic : {"1", "2", "3", "4", "RANDOM", "COUNTER"}) {
+        for (int f = 0; f <= grid; ++f) {
+          for (int h = 0; f + h <= grid; ++h) {
+            for (int b = 0; f + h + b <= grid; ++b) {
+              const std::string spec = std::format("{:.3f},{:.3f},{:.3f},{}", static_cast<double>(f) / grid,
+                                                   static_cast<double>(h) / grid, static_cast<double>(b) / grid,
+                                                   tactic);
+              civil_war::CampaignResult r =
+                  civil_war::simulate(battles, civil_war::Plan::parse(spec), games, threads, seed);
+              seconds += r.seconds;
+              played += r.games;
+              scored.push_back({spec, std::move(r)});
+            }
+          }
+        }
+      }
+      std::ranges::sort(scored, [](const Scored& a, const Scored& b) { return a.result.wars_won > b.result.wars_won; });
+      std::println("{:<28}{:>10}{:>12}{:>14}", "PLAN", "WARS WON", "BATTLES", "GAMES/SEC");
+      for (std::size_t i = 0; i < std::min<std::size_t>(10, scored.size()); ++i) {
+        print_summary(scored[i].name, scored[i].result);
+      }
+      std::println("");
+      std::println("{} PLANS, {:.0f} GAMES/SEC OVERALL", scored.size(), played / seconds);
+      std::println("");
+      std::println("BEST PLAN {}", scored.front().name);
+      print_battles(battles, scored.front().result);
+      return EXIT_SUCCESS;
+    }
+
+    std::vector<civil_war::CampaignResult> results;
+    std::println("{:<28}{:>10}{:>12}{:>14}", "PLAN", "WARS WON", "BATTLES", "GAMES/SEC");
+    for (const civil_war::Plan& plan : plans) {
+      results.push_back(civil_war::simulate(battles, plan, games, threads, seed));
+      print_summary(plan.name, results.back());
+    }
+    for (std::size_t p = 0; p < specs.size(); ++p) {
+      std::println("");
+      std::println("PLAN {}", specs[p]);
+      print_battles(battles, results[p]);
+    }
+  } catch (const std::exception& e) {
+    std::println(stderr, "Error: {}", e.what());
+    return EXIT_FAILURE;
+  }
+}
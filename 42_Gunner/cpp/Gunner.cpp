@@ -0,0 +1,187 @@
+#include "Gunner.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace gunner {
+
+/**
+ * @brief Impact distance for one shot (line 450).
+ *
+ * @param max_range Maximum range of the gun in yards
+ * @param elevation Elevation in degrees
+ * @return Distance from the gun to the impact point in yards
+ */
+double range(double max_range, double elevation) {
+  return max_range * std::sin(2.0 * elevation / DEGREES_PER_RADIAN);
+}
+
+/**
+ * @brief Impact distances for many elevations.
+ *
+ * The loop has no branches or aliasing so the compiler can use its vector
+ * math library for the sine.
+ */
+void ranges(double max_range, std::span<const double> elevations, std::span<double> out) {
+  const std::size_t n = std::min(elevations.size(), out.size());
+  const double* __restrict in = elevations.data();
+  double* __restrict dst = out.data();
+  for (std::size_t i = 0; i < n; ++i) {
+    dst[i] = max_range * std::sin(2.0 * in[i] / DEGREES_PER_RADIAN);
+  }
+}
+
+/**
+ * @brief Inverts R*SIN(2*B/57.3) for the low trajectory.
+ *
+ * @param max_range Maximum range of the gun in yards
+ * @param target Distance to the target in yards
+ * @return Elevation in degrees, if a legal one exists
+ */
+std::optional<double> elevation_for(double max_range, double target) {
+  if (target <= 0 || target > max_range) return std::nullopt;
+  double elevation = 0.5 * DEGREES_PER_RADIAN * std::asin(target / max_range);
+  if (elevation < MIN_ELEVATION || elevation > MAX_ELEVATION) return std::nullopt;
+  return elevation;
+}
+
+/**
+ * @brief Batched inverse of the range formula.
+ */
+void elevations_for(double max_range, std::span<const double> targets, std::span<double> out) {
+  const std::size_t n = std::min(targets.size(), out.size());
+  const double* __restrict in = targets.data();
+  double* __restrict dst = out.data();
+  const double inv_range = 1.0 / max_range;
+  for (std::size_t i = 0; i < n; ++i) {
+    dst[i] = 0.5 * DEGREES_PER_RADIAN * std::asin(in[i] * inv_range);
+  }
+}
+
+/**
+ * @brief Applies the hit test from lines 450-460.
+ *
+ * E is INT(T - impact), so the miss distance is floored before comparing.
+ */
+bool is_hit(double max_range, double target, double elevation) {
+  double miss = std::floor(target - range(max_range, elevation));
+  return std::abs(miss) < BURST_RADIUS;
+}
+
+/**
+ * @brief Fires at one target until it is hit or the crew is destroyed.
+ *
+ * @param max_range Maximum range of the gun in yards
+ * @param target Distance to the target in yards
+ * @param strategy How each elevation is chosen
+ * @return Rounds expended, or SHOTS_PER_TARGET + 1 if the crew was destroyed
+ */
+int shots_to_destroy(double max_range, double target, Strategy strategy) {
+  double low = MIN_ELEVATION;
+  double high = 45.0;
+  double elevation = 0;
+
+  switch (strategy) {
+    case Strategy::Exact:
+      elevation = elevation_for(max_range, target).value_or(45.0);
+      break;
+    case Strategy::WholeDegrees:
+      elevation = std::clamp(std::round(elevation_for(max_range, target).value_or(45.0)),
+                             MIN_ELEVATION, MAX_ELEVATION);
+      break;
+    case Strategy::Bisection:
+      elevation = 0.5 * (low + high);
+      break;
+  }
+
+  for (int shot = 1; shot <= SHOTS_PER_TARGET; ++shot) {
+    double miss = std::floor(target - range(max_range, elevation));
+    if (std::abs(miss) < BURST_RADIUS) return shot;
+
+    bool short_of_target = miss > 0;
+    switch (strategy) {
+      case Strategy::Exact:
+        break;
+      case Strategy::WholeDegrees:
+        elevation += short_of_target ? 1.0 : -1.0;
+        break;
+      case Strategy::Bisection:
+        (short_of_target ? low : high) = elevation;
+        elevation = 0.5 * (low + high);
+        break;
+    }
+  }
+  return SHOTS_PER_TARGET + 1;
+}
+
+/**
+ * @brief Plays complete games on several threads.
+ *
+ * Each worker draws gun ranges and targets exactly as lines 170 and 200 do
+ * and keeps its own totals, which are merged once at the end.
+ */
+SimulationResult simulate(std::uint64_t games, Strategy strategy, unsigned threads,
+                          std::uint64_t seed) {
+  if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+  struct Totals {
+    std::uint64_t games = 0, destroyed = 0, nice = 0, rounds = 0, targets = 0;
+  };
+  std::vector<Totals> totals(threads);
+
+  auto start = std::chrono::steady_clock::now();
+  {
+    std::vector<std::jthread> workers;
+    for (unsigned w = 0; w < threads; ++w) {
+      workers.emplace_back([&, w] {
+        std::mt19937_64 rng(seed + w);
+        std::uniform_real_distribution<double> rnd(0.0, 1.0);
+        Totals& t = totals[w];
+        std::uint64_t my_games = games / threads + (w < games % threads ? 1 : 0);
+
+        for (std::uint64_t g = 0; g < my_games; ++g) {
+          double max_range = std::floor(40000 * rnd(rng) + 20000);
+          int s1 = 0;
+          bool destroyed = false;
+          for (int z = 0; z < TARGETS_PER_GAME && !destroyed; ++z) {
+            double target = std::floor(max_range * (0.1 + 0.8 * rnd(rng)));
+            int s = shots_to_destroy(max_range, target, strategy);
+            destroyed = s > SHOTS_PER_TARGET;
+            s1 += s;
+          }
+
+          ++t.games;
+          if (destroyed) {
+            ++t.destroyed;
+          } else {
+            t.rounds += s1;
+            t.targets += TARGETS_PER_GAME;
+            if (s1 <= NICE_SHOOTING_LIMIT) ++t.nice;
+          }
+        }
+      });
+    }
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  SimulationResult result;
+  std::uint64_t rounds = 0, targets = 0;
+  for (const Totals& t : totals) {
+    result.games += t.games;
+    result.destroyed += t.destroyed;
+    result.nice_shooting += t.nice;
+    rounds += t.rounds;
+    targets += t.targets;
+  }
+  std::uint64_t completed = result.games - result.destroyed;
+  result.mean_rounds_per_target = targets ? static_cast<double>(rounds) / targets : 0;
+  result.mean_s1 = completed ? static_cast<double>(rounds) / completed : 0;
+  result.seconds = elapsed.count();
+  return result;
+}
+
+}  // namespace gunner
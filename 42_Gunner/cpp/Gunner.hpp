@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+/**
+ * @brief Closed-form ballistics for GUNNER (gunner.bas lines 170-480).
+ *
+ * The BASIC program computes the impact distance as R*SIN(2*B/57.3) and
+ * counts a hit when INT(T - impact) is within 100 yards. Everything here uses
+ * the same 57.3 degrees-per-radian constant so that solved elevations land
+ * exactly where the original program would put them.
+ */
+namespace gunner {
+
+inline constexpr double DEGREES_PER_RADIAN = 57.3;  ///< Constant used by line 450
+inline constexpr double BURST_RADIUS = 100.0;       ///< Yards either side of the target
+inline constexpr double MIN_ELEVATION = 1.0;
+inline constexpr double MAX_ELEVATION = 89.0;
+inline constexpr int TARGETS_PER_GAME = 5;          ///< Z runs from 0 to 4
+inline constexpr int SHOTS_PER_TARGET = 5;          ///< The sixth round gets you destroyed
+inline constexpr int NICE_SHOOTING_LIMIT = 18;      ///< Line 492
+
+/**
+ * @brief How the simulated officer chooses each elevation.
+ */
+enum class Strategy {
+  Exact,         ///< Inverse of the range formula, always one round per target
+  WholeDegrees,  ///< Inverse rounded to whole degrees, corrected by a degree at a time
+  Bisection      ///< No formula: halves the bracket [1, 45] on OVER/SHORT reports
+};
+
+/**
+ * @brief Impact distance for one shot.
+ */
+double range(double max_range, double elevation);
+
+/**
+ * @brief Impact distances for many elevations; written to be auto-vectorised.
+ *
+ * @param max_range Maximum range of the gun in yards
+ * @param elevations Elevations in degrees
+ * @param out Impact distances, same length as elevations
+ */
+void ranges(double max_range, std::span<const double> elevations, std::span<double> out);
+
+/**
+ * @brief Low-trajectory elevation that lands exactly on the target.
+ *
+ * @return Elevation in degrees, or empty if the target is out of range or
+ *         needs less than the one-degree minimum elevation.
+ */
+std::optional<double> elevation_for(double max_range, double target);
+
+/**
+ * @brief Batched inverse of the range formula.
+ *
+ * Targets beyond max_range produce NaN.
+ */
+void elevations_for(double max_range, std::span<const double> targets, std::span<double> out);
+
+/**
+ * @brief Whether a shot counts as a hit under line 450-460 rules.
+ */
+bool is_hit(double max_range, double target, double elevation);
+
+/**
+ * @brief Rounds fired at one target, or SHOTS_PER_TARGET + 1 if the crew was destroyed first.
+ */
+int shots_to_destroy(double max_range, double target, Strategy strategy);
+
+/**
+ * @brief Aggregate results of simulated games.
+ */
+struct SimulationResult {
+  std::uint64_t games = 0;
+  std::uint64_t destroyed = 0;        ///< Games ending in "BOOM !!!!"
+  std::uint64_t nice_shooting = 0;    ///< Completed games with S1 <= 18
+  double mean_rounds_per_target = 0;  ///< Averaged over completed games
+  double mean_s1 = 0;                 ///< Total rounds for completed games
+  double seconds = 0;
+};
+
+/**
+ * @brief Plays complete games (gun range, five targets) on several threads.
+ *
+ * @param games Number of games to play
+ * @param strategy Elevation strategy
+ * @param threads Worker count; 0 uses the hardware concurrency
+ * @param seed Base seed, each worker uses seed + worker index
+ */
+SimulationResult simulate(std::uint64_t games, Strategy strategy, unsigned threads = 0,
+                          std::uint64_t seed = 1);
+
+}  // namespace gunner
@@ -0,0 +1,87 @@
+#include "Gunner.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <print>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Times the batched range formula and its inverse.
+ *
+ * @param shots Number of elevations (and targets) per batch
+ */
+void benchmark_batches(std::size_t shots) {
+  const double max_range = 45000;
+  std::mt19937_64 rng(7);
+  std::uniform_real_distribution<double> elevation(gunner::MIN_ELEVATION, gunner::MAX_ELEVATION);
+
+  std::vector<double> elevations(shots);
+  std::vector<double> impacts(shots);
+  std::vector<double> solved(shots);
+  for (double& e : elevations) e = elevation(rng);
+
+  auto start = std::chrono::steady_clock::now();
+  gunner::ranges(max_range, elevations, impacts);
+  std::chrono::duration<double> forward = std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  gunner::elevations_for(max_range, impacts, solved);
+  std::chrono::duration<double> inverse = std::chrono::steady_clock::now() - start;
+
+  // Fold the outputs into a checksum so neither loop can be optimised away.
+  double checksum = 0;
+  for (std::size_t i = 0; i < shots; ++i) checksum += impacts[i] + solved[i];
+
+  std::println("RANGE FORMULA:   {:.1f} M SHOTS/SEC", shots / forward.count() / 1e6);
+  std::println("INVERSE FORMULA: {:.1f} M SHOTS/SEC", shots / inverse.count() / 1e6);
+  std::println("CHECKSUM: {:.3f}", checksum);
+}
+
+/**
+ * @brief Entry point for the GUNNER solver benchmark.
+ *
+ * Usage: GunnerBench [--shots N] [--games N] [--threads N]
+ */
+int main(int argc, char* argv[]) {
+  std::size_t shots = 10'000'000;
+  std::uint64_t games = 1'000'000;
+  unsigned threads = 0;
+
+  for (int i = 1; i + 1 < argc; i += 2) {
+    std::string_view flag = argv[i];
+    if (flag == "--shots") {
+      shots = std::stoull(argv[i + 1]);
+    } else if (flag == "--games") {
+      games = std::stoull(argv[i + 1]);
+    } else if (flag == "--threads") {
+      threads = static_cast<unsigned>(std::stoul(argv[i + 1]));
+    } else {
+      std::println(stderr, "Usage: GunnerBench [--shots N] [--games N] [--threads N]");
+      return EXIT_FAILURE;
+    }
+  }
+
+  benchmark_batches(shots);
+  std::println("");
+
+  struct Named {
+    std::string_view name;
+    gunner::Strategy strategy;
+  };
+  constexpr Named strategies[] = {
+    {"EXACT", gunner::Strategy::Exact},
+    {"WHOLE DEGREES", gunner::Strategy::WholeDegrees},
+    {"BISECTION", gunner::Strategy::Bisection},
+  };
+
+  std::println("{:<14}{:>10}{:>12}{:>12}{:>12}{:>14}", "STRATEGY", "ROUNDS", "S1", "DESTROYED",
+               "NICE", "GAMES/SEC");
+  for (const auto& [name, strategy] : strategies) {
+    gunner::SimulationResult r = gunner::simulate(games, strategy, threads);
+    std::println("{:<14}{:>10.3f}{:>12.3f}{:>11.2f}%{:>11.2f}%{:>14.0f}", name,
+                 r.mean_rounds_per_target, r.mean_s1, 100.0 * r.destroyed / r.games,
+                 100.0 * r.nice_shooting / r.games, r.games / r.seconds);
+  }
+}
@@ -0,0 +1,203 @@
+#include "Tote.hpp"
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+namespace {
+
+unsigned worker_count(unsigned threads) {
+  return threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+}
+
+}  // namespace
+
+/**
+ * @brief Odds in the R/D(N):1 form printed at line 580.
+ *
+ * @param horse Horse number, 1-based
+ * @return Total pool divided by the horse's pool, or 0 if nothing is bet on it
+ */
+double Tote::Snapshot::odds(int horse) const {
+  std::uint64_t pool = pools[horse - 1];
+  return pool ? static_cast<double>(total) / pool : 0.0;
+}
+
+/**
+ * @brief Constructs a window writing to one shard.
+ */
+Tote::Window::Window(Tote& tote, Shard& shard) : tote(&tote), shard(&shard) {}
+
+Tote::Window::Window(Window&& other) noexcept
+  : tote(other.tote), shard(std::exchange(other.shard, nullptr)) {}
+
+/**
+ * @brief Closes the window if it is still open.
+ */
+Tote::Window::~Window() {
+  close();
+}
+
+/**
+ * @brief Records a bet in this window's shard.
+ *
+ * The pool counter is only ever written by this thread, so the relaxed add
+ * never contends; it is atomic only so that publish() can read it.
+ *
+ * @param bettor Caller-assigned bettor id
+ * @param horse Horse number, 1-based
+ * @param amount Stake in dollars, 1 to MAX_BET
+ * @return true if the bet was accepted
+ */
+bool Tote::Window::place(std::uint32_t bettor, int horse, std::uint32_t amount) {
+  if (!shard || horse < 1 || horse > HORSES || amount < 1 || amount > MAX_BET) return false;
+  shard->pools[horse - 1].fetch_add(amount, std::memory_order_relaxed);
+  shard->bets.push_back(Bet{bettor, amount, static_cast<std::uint8_t>(horse)});
+  return true;
+}
+
+/**
+ * @brief Stops taking bets; the release pairs with the acquire in settle().
+ */
+void Tote::Window::close() {
+  if (shard) {
+    shard = nullptr;
+    tote->open_windows.fetch_sub(1, std::memory_order_release);
+  }
+}
+
+/**
+ * @brief Creates an empty tote.
+ *
+ * @param takeout Fraction of the pool withheld before paying winners, 0 to 1
+ */
+Tote::Tote(double takeout) : takeout(takeout) {
+  if (takeout < 0 || takeout >= 1) throw std::invalid_argument("takeout must be in [0, 1)");
+}
+
+Tote::~Tote() = default;
+
+/**
+ * @brief Opens a betting window backed by a new shard.
+ */
+Tote::Window Tote::open_window() {
+  std::lock_guard lock(shards_mutex);
+  shards.push_back(std::make_unique<Shard>());
+  open_windows.fetch_add(1, std::memory_order_relaxed);
+  return Window(*this, *shards.back());
+}
+
+/**
+ * @brief Sums the shards and publishes the result under the seqlock.
+ *
+ * An odd sequence number marks a publish in progress; readers retry until
+ * they see the same even number before and after copying.
+ */
+void Tote::publish() {
+  std::array<std::uint64_t, HORSES> pools{};
+  {
+    std::lock_guard lock(shards_mutex);
+    for (const auto& shard : shards) {
+      for (int h = 0; h < HORSES; ++h) pools[h] += shard->pools[h].load(std::memory_order_relaxed);
+    }
+  }
+  std::uint64_t total = 0;
+  for (std::uint64_t p : pools) total += p;
+
+  const std::uint64_t s = seq.load(std::memory_order_relaxed);
+  seq.store(s + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  for (int h = 0; h < HORSES; ++h) published[h].store(pools[h], std::memory_order_relaxed);
+  published[HORSES].store(total, std::memory_order_relaxed);
+  seq.store(s + 2, std::memory_order_release);
+}
+
+/**
+ * @brief Reads a consistent copy of the last published totals.
+ */
+Tote::Snapshot Tote::snapshot() const {
+  Snapshot snap;
+  while (true) {
+    const std::uint64_t before = seq.load(std::memory_order_acquire);
+    if (before % 2) continue;
+    for (int h = 0; h < HORSES; ++h) snap.pools[h] = published[h].load(std::memory_order_relaxed);
+    snap.total = published[HORSES].load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (seq.load(std::memory_order_relaxed) == before) {
+      snap.sequence = before / 2;
+      return snap;
+    }
+  }
+}
+
+/**
+ * @brief Pays every bet on the winning horse.
+ *
+ * Winners are counted per shard first, so each worker knows where its
+ * payouts go and writes them straight into the output without locking.
+ *
+ * @param winner Winning horse, 1-based
+ * @param payouts If not null, receives every winning bet's payout
+ * @param threads Worker count; 0 uses the hardware concurrency
+ * @return Totals for the race
+ */
+Tote::Settlement Tote::settle(int winner, std::vector<Payout>* payouts, unsigned threads) {
+  if (winner < 1 || winner > HORSES) throw std::invalid_argument("winner must be 1 to 8");
+
+  auto start = std::chrono::steady_clock::now();
+  // Checked under the lock open_window() takes, so no window opens once settlement has begun.
+  std::lock_guard lock(shards_mutex);
+  if (open_windows.load(std::memory_order_acquire) != 0) {
+    throw std::logic_error("all betting windows must be closed before settlement");
+  }
+  const std::size_t n = shards.size();
+  const unsigned workers_wanted =
+    static_cast<unsigned>(std::clamp<std::size_t>(n, 1, worker_count(threads)));
+
+  std::uint64_t total = 0, winning_pool = 0;
+  std::vector<std::uint64_t> offsets(n + 1, 0);
+  for (std::size_t i = 0; i < n; ++i) {
+    for (int h = 0; h < HORSES; ++h) total += shards[i]->pools[h].load(std::memory_order_relaxed);
+    winning_pool += shards[i]->pools[winner - 1].load(std::memory_order_relaxed);
+  }
+  const double ratio = winning_pool ? total * (1.0 - takeout) / winning_pool : 0.0;
+
+  // Pass 1: winning bets per shard, then prefix sums for the output offsets.
+  std::vector<std::uint64_t> paid(workers_wanted, 0);
+  auto run = [&](auto&& body) {
+    std::vector<std::jthread> workers;
+    for (unsigned w = 0; w < workers_wanted; ++w) {
+      workers.emplace_back([&, w] {
+        for (std::size_t i = w; i < n; i += workers_wanted) body(w, i);
+      });
+    }
+  };
+  run([&](unsigned, std::size_t i) {
+    std::uint64_t count = 0;
+    for (const Bet& bet : shards[i]->bets) count += bet.horse == winner;
+    offsets[i + 1] = count;
+  });
+  for (std::size_t i = 0; i < n; ++i) offsets[i + 1] += offsets[i];
+
+  if (payouts) payouts->resize(offsets[n]);
+
+  // Pass 2: write payouts and total the winning stakes.
+  run([&](unsigned w, std::size_t i) {
+    std::uint64_t out = offsets[i];
+    std::uint64_t stakes = 0;
+    for (const Bet& bet : shards[i]->bets) {
+      if (bet.horse != winner) continue;
+      stakes += bet.amount;
+      if (payouts) (*payouts)[out++] = Payout{bet.bettor, bet.amount * ratio};
+    }
+    paid[w] += stakes;
+  });
+
+  Settlement result;
+  result.winner = winner;
+  result.winning_bets = offsets[n];
+  for (std::uint64_t stakes : paid) result.paid += stakes * ratio;
+  result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  return result;
+}
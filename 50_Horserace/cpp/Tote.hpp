@@ -0,0 +1,157 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief Pari-mutuel betting pools for HORSERACE (horserace.bas lines 380-1370).
+ *
+ * The BASIC program quotes each horse at R/D(N):1 and pays a winning bet
+ * (R/D(N))*P(J). The tote keeps the same shape with R replaced by the total
+ * pool and D(N) by the amount bet on horse N, so the odds come from the bets.
+ *
+ * Bets are taken through Window objects, one per ingesting thread. Each
+ * window adds to its own cache-line-aligned pool counters and keeps its own
+ * bet log, so ingestion never contends. Display odds are published as
+ * seqlock-protected snapshots that readers copy without blocking writers.
+ */
+class Tote {
+  struct Shard;
+
+public:
+  static constexpr int HORSES = 8;                  ///< DIM S(8)
+  static constexpr std::uint32_t MAX_BET = 99'999;  ///< Bets must be under 100000 (line 660)
+
+  /**
+   * @brief One accepted bet.
+   */
+  struct Bet {
+    std::uint32_t bettor;
+    std::uint32_t amount;
+    std::uint8_t horse;  ///< 1-based, as typed at line 640
+  };
+
+  /**
+   * @brief Pool totals and odds at one instant.
+   */
+  struct Snapshot {
+    std::uint64_t sequence = 0;  ///< Number of publishes so far
+    std::uint64_t total = 0;
+    std::array<std::uint64_t, HORSES> pools{};
+
+    /**
+     * @brief Odds for a horse in the R/D(N):1 form, or 0 if nothing is bet on it.
+     */
+    double odds(int horse) const;
+  };
+
+  /**
+   * @brief A single thread's betting window.
+   *
+   * Not thread-safe: each ingesting thread opens its own window. Closing
+   * (or destroying) the window hands its bets over for settlement.
+   */
+  class Window {
+  public:
+    Window(Window&&) noexcept;
+    Window& operator=(Window&&) = delete;
+    ~Window();
+
+    /**
+     * @brief Accepts a bet; false if the amount or horse is out of range.
+     */
+    bool place(std::uint32_t bettor, int horse, std::uint32_t amount);
+
+    /**
+     * @brief Stops taking bets through this window.
+     */
+    void close();
+
+  private:
+    friend class Tote;
+    Window(Tote& tote, Shard& shard);
+
+    Tote* tote;
+    Shard* shard;  ///< Null once closed
+  };
+
+  /**
+   * @brief Result of settling a race.
+   */
+  struct Settlement {
+    int winner = 0;
+    std::uint64_t winning_bets = 0;
+    double paid = 0;
+    double seconds = 0;
+  };
+
+  /**
+   * @brief Creates an empty tote.
+   *
+   * @param takeout Fraction of the pool kept by the track; the BASIC odds imply 0
+   */
+  explicit Tote(double takeout = 0.0);
+  ~Tote();
+
+  Tote(const Tote&) = delete;
+  Tote& operator=(const Tote&) = delete;
+
+  /**
+   * @brief Opens a betting window for the calling thread.
+   */
+  Window open_window();
+
+  /**
+   * @brief Sums every shard and publishes the totals for display.
+   *
+   * Intended for one publisher thread, e.g. once per display refresh.
+   */
+  void publish();
+
+  /**
+   * @brief Copies the most recently published snapshot without blocking the publisher.
+   */
+  Snapshot snapshot() const;
+
+  /**
+   * @brief One winning bet's payout.
+   */
+  struct Payout {
+    std::uint32_t bettor;
+    double amount;  ///< (total pool / winner's pool) * stake, less takeout
+  };
+
+  /**
+   * @brief Pays every winning bet, in parallel over the window bet logs.
+   *
+   * All windows must be closed first.
+   *
+   * @param winner Winning horse, 1-based
+   * @param payouts If not null, receives every winning bet's payout
+   * @param threads Worker count; 0 uses the hardware concurrency
+   */
+  Settlement settle(int winner, std::vector<Payout>* payouts = nullptr, unsigned threads = 0);
+
+private:
+  /**
+   * @brief Per-window counters, kept on their own cache lines.
+   */
+  struct alignas(64) Shard {
+    std::array<std::atomic<std::uint64_t>, HORSES> pools{};
+    std::vector<Bet> bets;
+  };
+
+  double takeout;
+  std::mutex shards_mutex;                   ///< Guards the shard list, not the shards
+  std::vector<std::unique_ptr<Shard>> shards;  ///< Addresses stay stable as windows open
+  std::atomic<int> open_windows{0};
+
+  // Seqlock-protected published snapshot
+  std::atomic<std::uint64_t> seq{0};
+  std::array<std::atomic<std::uint64_t>, HORSES + 1> published{};
+};
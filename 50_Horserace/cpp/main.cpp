@@ -0,0 +1,110 @@
+#include "Tote.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <print>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Horse names from lines 150-220.
+ */
+constexpr std::string_view NAMES[Tote::HORSES] = {"JOE MAW", "L.B.J.", "MR.WASHBURN", "MISS KAREN",
+                                                  "JOLLY", "HORSE", "JELLY DO NOT", "MIDNIGHT"};
+
+}  // namespace
+
+/**
+ * @brief Entry point for the tote benchmark.
+ *
+ * Ingest threads place random bets through their own windows while one
+ * thread publishes snapshots and another keeps reading them, as a display
+ * board would. The race is then settled in parallel.
+ *
+ * Usage: ToteBench [--bets N] [--threads N]
+ */
+int main(int argc, char* argv[]) {
+  std::uint64_t bets = 1'000'000;
+  unsigned threads = 0;
+
+  for (int i = 1; i + 1 < argc; i += 2) {
+    std::string_view flag = argv[i];
+    if (flag == "--bets") {
+      bets = std::stoull(argv[i + 1]);
+    } else if (flag == "--threads") {
+      threads = static_cast<unsigned>(std::stoul(argv[i + 1]));
+    } else {
+      std::println(stderr, "Usage: ToteBench [--bets N] [--threads N]");
+      return EXIT_FAILURE;
+    }
+  }
+  const unsigned ingest = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+
+  try {
+    Tote tote;
+    std::atomic<bool> betting{true};
+    std::atomic<std::uint64_t> reads{0};
+    std::atomic<std::uint64_t> torn{0};
+
+    auto start = std::chrono::steady_clock::now();
+    {
+      std::jthread board([&] {
+        while (betting.load(std::memory_order_relaxed)) {
+          tote.publish();
+          std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        tote.publish();
+      });
+      std::jthread reader([&] {
+        while (betting.load(std::memory_order_relaxed)) {
+          Tote::Snapshot snap = tote.snapshot();
+          std::uint64_t sum = 0;
+          for (std::uint64_t p : snap.pools) sum += p;
+          if (sum != snap.total) torn.fetch_add(1, std::memory_order_relaxed);
+          reads.fetch_add(1, std::memory_order_relaxed);
+        }
+      });
+
+      {
+        std::vector<std::jthread> windows;
+        for (unsigned w = 0; w < ingest; ++w) {
+          windows.emplace_back([&, w] {
+            Tote::Window window = tote.open_window();
+            std::mt19937_64 rng(w + 1);
+            std::uniform_int_distribution<int> horse(1, Tote::HORSES);
+            std::uniform_int_distribution<std::uint32_t> amount(1, 500);
+            for (std::uint64_t b = w; b < bets; b += ingest) {
+              window.place(static_cast<std::uint32_t>(b), horse(rng), amount(rng));
+            }
+          });
+        }
+      }
+      betting.store(false, std::memory_order_relaxed);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    Tote::Snapshot snap = tote.snapshot();
+    std::println("BETS: {}  WINDOWS: {}  TIME: {:.3f}s  ({:.1f} M BETS/SEC)", bets, ingest, seconds,
+                 bets / seconds / 1e6);
+    std::println("SNAPSHOTS PUBLISHED: {}  READ: {}  INCONSISTENT: {}", snap.sequence, reads.load(),
+                 torn.load());
+    std::println("TOTAL POOL: ${}", snap.total);
+    std::println("HORSE\t\tNUMBER\tODDS");
+    for (int h = 1; h <= Tote::HORSES; ++h) {
+      std::println("{:<16}{}\t{:.2f}:1", NAMES[h - 1], h, snap.odds(h));
+    }
+
+    std::vector<Tote::Payout> payouts;
+    Tote::Settlement result = tote.settle(1, &payouts, threads);
+    std::println("SETTLED {}: {} WINNING BETS, PAID ${:.2f} IN {:.4f}s", NAMES[result.winner - 1],
+                 result.winning_bets, result.paid, result.seconds);
+  } catch (const std::exception& e) {
+    std::println(stderr, "Error: {}", e.what());
+    return EXIT_FAILURE;
+  }
+}
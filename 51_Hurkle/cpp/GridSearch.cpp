@@ -0,0 +1,554 @@
+#include "GridSearch.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <thread>
+
+namespace grid_search {
+
+namespace {
+
+unsigned worker_count(unsigned threads) {
+  return threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+}
+
+/**
+ * @brief Adds one found target to a histogram indexed by guess number.
+ */
+void record(std::vector<std::uint64_t>& histogram, int guesses) {
+  if (histogram.size() <= static_cast<std::size_t>(guesses)) histogram.resize(guesses + 1);
+  ++histogram[guesses];
+}
+
+/**
+ * @brief Fills in the totals of a SearchStats from its histogram.
+ */
+void summarise(SearchStats& stats) {
+  std::uint64_t total = 0;
+  stats.targets = 0;
+  for (std::size_t g = 0; g < stats.histogram.size(); ++g) {
+    stats.targets += stats.histogram[g];
+    total += g * stats.histogram[g];
+    if (stats.histogram[g]) stats.worst = static_cast<int>(g);
+  }
+  stats.average = stats.targets ? static_cast<double>(total) / stats.targets : 0;
+}
+
+/**
+ * @brief Combines outcome sizes into a score; lower is better.
+ */
+std::uint64_t score(Objective objective, std::uint64_t previous, std::uint64_t count) {
+  return objective == Objective::Minimax ? std::max(previous, count) : previous + count * count;
+}
+
+}  // namespace
+
+// ---------------------------------------------------------------------------
+// CellSet
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief Constructs an empty or full set of cells.
+ *
+ * @param cells Number of cells in the grid
+ * @param full Whether every cell starts as a member
+ */
+CellSet::CellSet(std::size_t cells, bool full)
+  : n(cells), words((cells + 63) / 64, 0) {
+  if (full && cells) {
+    std::ranges::fill(words, ~std::uint64_t{0});
+    if (cells % 64) words.back() = (std::uint64_t{1} << (cells % 64)) - 1;
+    last_word = words.size();
+  }
+}
+
+/**
+ * @brief Number of members.
+ */
+std::size_t CellSet::count() const {
+  std::size_t total = 0;
+  for (std::size_t w = first_word; w < last_word; ++w) total += std::popcount(words[w]);
+  return total;
+}
+
+/**
+ * @brief Replaces this set with the members of other inside the given ranges.
+ *
+ * Only the previously active words are cleared, so the cost is proportional
+ * to the area covered rather than to the whole grid.
+ *
+ * @param other Source set, at least as large as this one
+ * @param ranges Sorted, disjoint, half-open cell ranges to keep
+ */
+void CellSet::assign_ranges(const CellSet& other,
+                            std::span<const std::pair<std::size_t, std::size_t>> ranges) {
+  std::fill(words.begin() + first_word, words.begin() + last_word, 0);
+  first_word = last_word = 0;
+  if (ranges.empty()) return;
+
+  for (auto [begin, end] : ranges) {
+    if (begin >= end) continue;
+    std::size_t w_first = begin / 64;
+    std::size_t w_last = (end - 1) / 64;
+    for (std::size_t w = w_first; w <= w_last; ++w) {
+      std::uint64_t mask = ~std::uint64_t{0};
+      if (w == w_first) mask &= ~std::uint64_t{0} << (begin % 64);
+      if (w == w_last && end % 64) mask &= (std::uint64_t{1} << (end % 64)) - 1;
+      words[w] |= other.words[w] & mask;
+    }
+  }
+  first_word = ranges.front().first / 64;
+  last_word = (ranges.back().second + 63) / 64;
+}
+
+// ---------------------------------------------------------------------------
+// DirectionGrid
+// ---------------------------------------------------------------------------
+
+template <int Dims>
+std::size_t DirectionGrid<Dims>::cells() const {
+  std::size_t total = 1;
+  for (int d = 0; d < Dims; ++d) total *= static_cast<std::size_t>(g);
+  return total;
+}
+
+template <int Dims>
+typename DirectionGrid<Dims>::Point DirectionGrid<Dims>::point(std::size_t cell) const {
+  Point p;
+  for (int d = 0; d < Dims; ++d) {
+    p[d] = static_cast<int>(cell % g);
+    cell /= g;
+  }
+  return p;
+}
+
+template <int Dims>
+std::size_t DirectionGrid<Dims>::index(const Point& p) const {
+  std::size_t cell = 0;
+  for (int d = Dims - 1; d >= 0; --d) cell = cell * g + p[d];
+  return cell;
+}
+
+/**
+ * @brief Encodes the sonar/direction report as a base-3 number, axis 0 first.
+ */
+template <int Dims>
+int DirectionGrid<Dims>::outcome(const Point& guess, const Point& hidden) const {
+  int code = 0;
+  for (int d = Dims - 1; d >= 0; --d) {
+    code = code * 3 + (hidden[d] < guess[d] ? 0 : hidden[d] == guess[d] ? 1 : 2);
+  }
+  return code;
+}
+
+/**
+ * @brief Shrinks [lo, hi] to the cells that would have produced a clue.
+ */
+template <int Dims>
+void DirectionGrid<Dims>::narrow(const Point& guess, int clue, Point& lo, Point& hi) const {
+  for (int d = 0; d < Dims; ++d, clue /= 3) {
+    switch (clue % 3) {
+      case 0: hi[d] = std::min(hi[d], guess[d] - 1); break;
+      case 1: lo[d] = std::max(lo[d], guess[d]); hi[d] = std::min(hi[d], guess[d]); break;
+      case 2: lo[d] = std::max(lo[d], guess[d] + 1); break;
+    }
+  }
+}
+
+/**
+ * @brief Copies the members of `from` that lie inside [lo, hi] into `to`.
+ *
+ * Each row of the box along axis 0 is one contiguous run of bits.
+ */
+template <int Dims>
+void DirectionGrid<Dims>::restrict(const CellSet& from, const Point& lo, const Point& hi,
+                                   CellSet& to) const {
+  std::vector<std::pair<std::size_t, std::size_t>> rows;
+  Point p = lo;
+  while (true) {
+    std::size_t begin = index(p);
+    rows.emplace_back(begin, begin + (hi[0] - lo[0] + 1));
+
+    int d = 1;
+    for (; d < Dims; ++d) {
+      if (++p[d] <= hi[d]) break;
+      p[d] = lo[d];
+    }
+    if (d == Dims) break;
+  }
+  to.assign_ranges(from, rows);
+}
+
+/**
+ * @brief Scores every guess in the box with a summed-area table.
+ *
+ * The table has one extra leading plane per axis, so the count of any
+ * sub-box is an inclusion-exclusion over its 2^Dims corners.
+ */
+template <int Dims>
+typename DirectionGrid<Dims>::Point DirectionGrid<Dims>::best_guess(
+    const CellSet& candidates, const Point& lo, const Point& hi, Objective objective) const {
+  std::array<std::size_t, Dims> extent{};
+  std::array<std::size_t, Dims> stride{};
+  std::size_t volume = 1;
+  for (int d = 0; d < Dims; ++d) {
+    extent[d] = static_cast<std::size_t>(hi[d] - lo[d] + 1);
+    stride[d] = volume;
+    volume *= extent[d] + 1;
+  }
+
+  std::vector<std::uint32_t> table(volume, 0);
+  {
+    Point p = lo;
+    while (true) {
+      std::size_t t = 0;
+      for (int d = 0; d < Dims; ++d) t += (p[d] - lo[d] + 1) * stride[d];
+      table[t] = candidates.test(index(p));
+
+      int d = 0;
+      for (; d < Dims; ++d) {
+        if (++p[d] <= hi[d]) break;
+        p[d] = lo[d];
+      }
+      if (d == Dims) break;
+    }
+  }
+  for (int d = 0; d < Dims; ++d) {
+    for (std::size_t t = 0; t < volume; ++t) {
+      if ((t / stride[d]) % (extent[d] + 1) != 0) table[t] += table[t - stride[d]];
+    }
+  }
+
+  // Count of cells with local coordinates in [a, b) on every axis.
+  auto box_sum = [&](const std::array<std::size_t, Dims>& a, const std::array<std::size_t, Dims>& b) {
+    std::int64_t sum = 0;
+    for (int corner = 0; corner < (1 << Dims); ++corner) {
+      std::size_t t = 0;
+      int lows = 0;
+      for (int d = 0; d < Dims; ++d) {
+        bool high = corner >> d & 1;
+        t += (high ? b[d] : a[d]) * stride[d];
+        lows += !high;
+      }
+      sum += (lows % 2 ? -1 : 1) * static_cast<std::int64_t>(table[t]);
+    }
+    return static_cast<std::uint64_t>(sum);
+  };
+
+  Point best = lo;
+  std::uint64_t best_score = std::numeric_limits<std::uint64_t>::max();
+  bool best_is_candidate = false;
+
+  std::array<std::size_t, Dims> c{};
+  while (true) {
+    std::uint64_t s = 0;
+    for (int o = 0; o < OUTCOMES; ++o) {
+      std::array<std::size_t, Dims> a{}, b{};
+      int code = o;
+      for (int d = 0; d < Dims; ++d, code /= 3) {
+        switch (code % 3) {
+          case 0: a[d] = 0; b[d] = c[d]; break;
+          case 1: a[d] = c[d]; b[d] = c[d] + 1; break;
+          case 2: a[d] = c[d] + 1; b[d] = extent[d]; break;
+        }
+      }
+      s = score(objective, s, box_sum(a, b));
+      if (s > best_score) break;
+    }
+
+    Point guess;
+    for (int d = 0; d < Dims; ++d) guess[d] = lo[d] + static_cast<int>(c[d]);
+    bool is_candidate = candidates.test(index(guess));
+    if (s < best_score || (s == best_score && is_candidate && !best_is_candidate)) {
+      best = guess;
+      best_score = s;
+      best_is_candidate = is_candidate;
+    }
+
+    int d = 0;
+    for (; d < Dims; ++d) {
+      if (++c[d] < extent[d]) break;
+      c[d] = 0;
+    }
+    if (d == Dims) break;
+  }
+  return best;
+}
+
+/**
+ * @brief Plays every hiding place by walking the decision tree once.
+ *
+ * Each node is a candidate set; its guess splits the candidates by clue
+ * and every non-empty clue is a child. The top of the tree is expanded
+ * breadth-first until there are enough subtrees to keep every worker busy,
+ * then workers walk whole subtrees depth-first with one scratch set per level.
+ */
+template <int Dims>
+SearchStats DirectionGrid<Dims>::search_all(Objective objective, unsigned threads) const {
+  struct Node {
+    CellSet candidates;
+    Point lo, hi;
+    int depth;  ///< Guesses already made
+  };
+
+  const unsigned workers_wanted = worker_count(threads);
+  SearchStats stats;
+  auto start = std::chrono::steady_clock::now();
+
+  // Calls child(clue, lo, hi) for every clue of the node's guess that some candidate produces.
+  auto expand = [&](const CellSet& candidates, const Point& lo, const Point& hi, int depth,
+                    std::vector<std::uint64_t>& histogram, auto&& child) {
+    Point guess = best_guess(candidates, lo, hi, objective);
+    if (candidates.test(index(guess))) record(histogram, depth + 1);
+    for (int o = 0; o < OUTCOMES; ++o) {
+      if (o == FOUND) continue;
+      Point child_lo = lo, child_hi = hi;
+      narrow(guess, o, child_lo, child_hi);
+      bool empty = false;
+      for (int d = 0; d < Dims; ++d) empty |= child_lo[d] > child_hi[d];
+      if (!empty) child(child_lo, child_hi);
+    }
+  };
+
+  Point lo{}, hi{};
+  hi.fill(g - 1);
+  std::vector<Node> frontier;
+  frontier.push_back({CellSet(cells(), true), lo, hi, 0});
+
+  while (!frontier.empty() && frontier.size() < 4 * workers_wanted) {
+    std::vector<Node> next;
+    for (const Node& node : frontier) {
+      expand(node.candidates, node.lo, node.hi, node.depth, stats.histogram,
+             [&](const Point& l, const Point& h) {
+               Node child{CellSet(cells()), l, h, node.depth + 1};
+               restrict(node.candidates, l, h, child.candidates);
+               if (child.candidates.count()) next.push_back(std::move(child));
+             });
+    }
+    frontier = std::move(next);
+  }
+
+  std::mutex merge;
+  {
+    std::atomic<std::size_t> next_node{0};
+    std::vector<std::jthread> workers;
+    for (unsigned w = 0; w < workers_wanted; ++w) {
+      workers.emplace_back([&] {
+        std::vector<std::uint64_t> histogram;
+        std::deque<CellSet> scratch;  // stable references while the walk deepens
+
+        auto walk = [&](auto&& self, const CellSet& candidates, const Point& l, const Point& h,
+                        int depth) -> void {
+          expand(candidates, l, h, depth, histogram, [&](const Point& cl, const Point& ch) {
+            if (scratch.size() <= static_cast<std::size_t>(depth + 1)) scratch.emplace_back(cells());
+            CellSet& child = scratch[depth + 1];
+            restrict(candidates, cl, ch, child);
+            if (child.count()) self(self, child, cl, ch, depth + 1);
+          });
+        };
+
+        for (std::size_t i = next_node++; i < frontier.size(); i = next_node++) {
+          const Node& node = frontier[i];
+          while (scratch.size() <= static_cast<std::size_t>(node.depth)) scratch.emplace_back(cells());
+          walk(walk, node.candidates, node.lo, node.hi, node.depth);
+        }
+
+        std::lock_guard lock(merge);
+        if (stats.histogram.size() < histogram.size()) stats.histogram.resize(histogram.size());
+        for (std::size_t i = 0; i < histogram.size(); ++i) stats.histogram[i] += histogram[i];
+      });
+    }
+  }
+
+  stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  summarise(stats);
+  return stats;
+}
+
+template class DirectionGrid<2>;
+template class DirectionGrid<3>;
+
+// ---------------------------------------------------------------------------
+// MugwumpGrid
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief Constructs a G-by-G MUGWUMP grid.
+ */
+MugwumpGrid::MugwumpGrid(int size, std::size_t guess_budget)
+  : g(size), guess_budget(std::max<std::size_t>(1, guess_budget)) {}
+
+/**
+ * @brief The distance report for one mugwump, in tenths; 0 means found.
+ *
+ * @param guess Guessed cell, x + G*y
+ * @param hidden Mugwump cell
+ * @return INT(D*10) as printed by line 390
+ */
+int MugwumpGrid::clue(std::size_t guess, std::size_t hidden) const {
+  const long dx = static_cast<long>(guess % g) - static_cast<long>(hidden % g);
+  const long dy = static_cast<long>(guess / g) - static_cast<long>(hidden / g);
+  return static_cast<int>(std::sqrt(static_cast<double>(dx * dx + dy * dy)) * 10);
+}
+
+/**
+ * @brief Clears every candidate inconsistent with a reported distance.
+ */
+void MugwumpGrid::apply(std::size_t guess, int clue_value, CellSet& candidates) const {
+  candidates.for_each([&](std::size_t cell) {
+    if (clue(guess, cell) != clue_value) candidates.reset(cell);
+  });
+}
+
+/**
+ * @brief Chooses the next guess for all mugwumps still hidden.
+ *
+ * A mugwump whose position is already certain is guessed straight away.
+ * Otherwise up to guess_budget cells, spread evenly over the union of the
+ * candidate sets, are scored by summing each mugwump's score.
+ *
+ * @param candidates Candidate set per mugwump
+ * @param found Which mugwumps have been found
+ * @param objective Guess scoring
+ * @param counts Scratch counters indexed by clue, left zeroed
+ * @return Cell to guess
+ */
+std::size_t MugwumpGrid::best_guess(std::span<const CellSet> candidates,
+                                    const std::array<bool, TARGETS>& found, Objective objective,
+                                    std::vector<std::uint32_t>& counts) const {
+  std::vector<std::size_t> pool;
+  for (int t = 0; t < TARGETS; ++t) {
+    if (found[t]) continue;
+    if (candidates[t].count() == 1) {
+      std::size_t only = 0;
+      candidates[t].for_each([&](std::size_t cell) { only = cell; });
+      return only;
+    }
+    candidates[t].for_each([&](std::size_t cell) { pool.push_back(cell); });
+  }
+  std::ranges::sort(pool);
+  pool.erase(std::ranges::unique(pool).begin(), pool.end());
+  if (pool.size() > guess_budget) {
+    std::vector<std::size_t> sampled(guess_budget);
+    for (std::size_t i = 0; i < guess_budget; ++i) sampled[i] = pool[i * pool.size() / guess_budget];
+    pool = std::move(sampled);
+  }
+
+  counts.resize(static_cast<std::size_t>(std::sqrt(2.0) * g * 10) + 2);
+
+  std::size_t best = pool.empty() ? 0 : pool.front();
+  double best_score = std::numeric_limits<double>::infinity();
+  for (std::size_t guess : pool) {
+    double total = 0;
+    for (int t = 0; t < TARGETS; ++t) {
+      if (found[t]) continue;
+      std::uint64_t s = 0;
+      std::size_t n = 0;
+      candidates[t].for_each([&](std::size_t cell) { ++counts[clue(guess, cell)]; ++n; });
+      candidates[t].for_each([&](std::size_t cell) {
+        std::uint32_t& bucket = counts[clue(guess, cell)];
+        if (bucket) {
+          s = score(objective, s, bucket);
+          bucket = 0;
+        }
+      });
+      total += objective == Objective::Minimax ? static_cast<double>(s) : static_cast<double>(s) / n;
+    }
+    if (total < best_score) {
+      best = guess;
+      best_score = total;
+    }
+  }
+  return best;
+}
+
+/**
+ * @brief The first guess, computed once because every game starts identically.
+ */
+std::size_t MugwumpGrid::opening_guess(Objective objective) const {
+  std::array<CellSet, TARGETS> candidates;
+  candidates.fill(CellSet(cells(), true));
+  std::vector<std::uint32_t> counts;
+
+  // All four sets are identical, so scoring one of them picks the same cell.
+  std::array<bool, TARGETS> only_first{};
+  only_first.fill(true);
+  only_first[0] = false;
+  return best_guess(candidates, only_first, objective, counts);
+}
+
+/**
+ * @brief Plays one game of MUGWUMP (lines 240-470).
+ *
+ * @return Turn on which the last mugwump was found, or TURNS + 1
+ */
+int MugwumpGrid::play(std::span<const std::size_t> hidden, Objective objective,
+                      std::size_t opening) const {
+  std::array<CellSet, TARGETS> candidates;
+  candidates.fill(CellSet(cells(), true));
+  std::array<bool, TARGETS> found{};
+  std::vector<std::uint32_t> counts;
+
+  for (int turn = 1; turn <= TURNS; ++turn) {
+    std::size_t guess = turn == 1 ? opening : best_guess(candidates, found, objective, counts);
+    bool all_found = true;
+    for (int t = 0; t < TARGETS; ++t) {
+      if (found[t]) continue;
+      int c = clue(guess, hidden[t]);
+      found[t] = c == 0 && guess == hidden[t];
+      if (!found[t]) apply(guess, c, candidates[t]);
+      all_found &= found[t];
+    }
+    if (all_found) return turn;
+  }
+  return TURNS + 1;
+}
+
+/**
+ * @brief Plays random games in parallel; mugwumps are placed as lines 1000-1050 place them.
+ */
+SearchStats MugwumpGrid::simulate(std::uint64_t games, Objective objective, unsigned threads,
+                                  std::uint64_t seed) const {
+  const unsigned workers_wanted = worker_count(threads);
+  SearchStats stats;
+  auto start = std::chrono::steady_clock::now();
+  const std::size_t opening = opening_guess(objective);
+
+  std::mutex merge;
+  {
+    std::vector<std::jthread> workers;
+    for (unsigned w = 0; w < workers_wanted; ++w) {
+      workers.emplace_back([&, w] {
+        std::mt19937_64 rng(seed + w);
+        std::uniform_int_distribution<int> coordinate(0, g - 1);
+        std::vector<std::uint64_t> histogram;
+        std::uint64_t my_games = games / workers_wanted + (w < games % workers_wanted ? 1 : 0);
+
+        for (std::uint64_t i = 0; i < my_games; ++i) {
+          std::array<std::size_t, TARGETS> hidden;
+          for (std::size_t& h : hidden) {
+            int x = coordinate(rng);
+            int y = coordinate(rng);
+            h = static_cast<std::size_t>(y) * g + x;
+          }
+          record(histogram, play(hidden, objective, opening));
+        }
+
+        std::lock_guard lock(merge);
+        if (stats.histogram.size() < histogram.size()) stats.histogram.resize(histogram.size());
+        for (std::size_t i = 0; i < histogram.size(); ++i) stats.histogram[i] += histogram[i];
+      });
+    }
+  }
+
+  stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  summarise(stats);
+  return stats;
+}
+
+}  // namespace grid_search
@@ -0,0 +1,205 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Optimal-query search for the hide-and-seek grid games.
+ *
+ * HURKLE (51_Hurkle/hurkle.bas) and DEPTH CHARGE (31_Depth_Charge/depthcharge.bas)
+ * answer every guess with a direction per axis; MUGWUMP (62_Mugwump/mugwump.bas)
+ * answers with a truncated distance to each hidden mugwump. In all three the
+ * cells that could still hold a target are kept as a bitset, each clue is
+ * applied to it incrementally, and the next guess is the one that minimises
+ * either the worst-case or the expected number of cells left.
+ */
+namespace grid_search {
+
+/**
+ * @brief How a guess is scored.
+ */
+enum class Objective {
+  Minimax,  ///< Smallest worst-case number of candidates left
+  Expected  ///< Smallest expected number of candidates left
+};
+
+/**
+ * @brief A set of grid cells stored one bit per cell.
+ *
+ * Only the words between first_word and last_word can be non-zero, so set
+ * operations on a shrinking candidate set touch a shrinking range of memory.
+ */
+class CellSet {
+public:
+  explicit CellSet(std::size_t cells = 0, bool full = false);
+
+  std::size_t cells() const { return n; }
+  std::size_t count() const;
+  bool test(std::size_t cell) const { return words[cell / 64] >> (cell % 64) & 1; }
+  void reset(std::size_t cell) { words[cell / 64] &= ~(std::uint64_t{1} << (cell % 64)); }
+
+  /**
+   * @brief Replaces this set with the members of other inside the given cell ranges.
+   *
+   * Ranges are half-open, sorted and disjoint. Whole words are copied and
+   * only the partial words at each end of a range are masked.
+   */
+  void assign_ranges(const CellSet& other, std::span<const std::pair<std::size_t, std::size_t>> ranges);
+
+  /**
+   * @brief Calls f(cell) for every member in increasing order.
+   */
+  template <class F>
+  void for_each(F&& f) const {
+    for (std::size_t w = first_word; w < last_word; ++w) {
+      for (std::uint64_t bits = words[w]; bits; bits &= bits - 1) {
+        f(w * 64 + static_cast<std::size_t>(std::countr_zero(bits)));
+      }
+    }
+  }
+
+private:
+  std::size_t n;
+  std::vector<std::uint64_t> words;
+  std::size_t first_word = 0;  ///< Words outside [first_word, last_word) are zero
+  std::size_t last_word = 0;
+};
+
+/**
+ * @brief Statistics from searching for every possible hiding place.
+ */
+struct SearchStats {
+  std::uint64_t targets = 0;
+  std::vector<std::uint64_t> histogram;  ///< histogram[g] targets found on guess g
+  int worst = 0;
+  double average = 0;
+  double seconds = 0;
+};
+
+/**
+ * @brief A G^Dims grid where each clue gives the direction per axis.
+ *
+ * Dims = 2 is HURKLE (lines 610-730) and Dims = 3 is DEPTH CHARGE (lines
+ * 500-590). Cell (x, y[, z]) has index x + G*y [+ G*G*z].
+ */
+template <int Dims>
+class DirectionGrid {
+public:
+  using Point = std::array<int, Dims>;
+
+  static constexpr int OUTCOMES = Dims == 2 ? 9 : 27;
+  static constexpr int FOUND = (OUTCOMES - 1) / 2;  ///< Every axis "equal"
+
+  explicit DirectionGrid(int size) : g(size) {}
+
+  int size() const { return g; }
+  std::size_t cells() const;
+  Point point(std::size_t cell) const;
+  std::size_t index(const Point& p) const;
+
+  /**
+   * @brief Clue for a guess: per axis 0 if the target is lower, 1 if equal, 2 if higher.
+   */
+  int outcome(const Point& guess, const Point& hidden) const;
+
+  /**
+   * @brief Box of cells consistent with a clue, intersected with an existing box.
+   */
+  void narrow(const Point& guess, int clue, Point& lo, Point& hi) const;
+
+  /**
+   * @brief Keeps only the cells of `from` inside [lo, hi] and writes them to `to`.
+   */
+  void restrict(const CellSet& from, const Point& lo, const Point& hi, CellSet& to) const;
+
+  /**
+   * @brief Best guess for the candidates inside the box [lo, hi].
+   *
+   * Counts for every outcome of every guess come from a summed-area table
+   * over the candidate bits, so each guess is scored in O(OUTCOMES).
+   */
+  Point best_guess(const CellSet& candidates, const Point& lo, const Point& hi,
+                   Objective objective) const;
+
+  /**
+   * @brief Walks the full decision tree once, which plays every hiding place.
+   *
+   * @param objective Guess scoring
+   * @param threads Worker count; 0 uses the hardware concurrency
+   */
+  SearchStats search_all(Objective objective, unsigned threads = 0) const;
+
+private:
+  int g;
+};
+
+/**
+ * @brief MUGWUMP: several targets, each clue a distance truncated to tenths.
+ */
+class MugwumpGrid {
+public:
+  static constexpr int TARGETS = 4;  ///< DIM P(4,2)
+  static constexpr int TURNS = 10;   ///< Line 470
+
+  /**
+   * @brief Constructs a G-by-G grid.
+   *
+   * @param size G
+   * @param guess_budget Largest number of guesses scored per turn
+   */
+  MugwumpGrid(int size, std::size_t guess_budget = 256);
+
+  std::size_t cells() const { return static_cast<std::size_t>(g) * g; }
+
+  /**
+   * @brief The printed distance INT(D*10), in tenths (line 390).
+   */
+  int clue(std::size_t guess, std::size_t hidden) const;
+
+  /**
+   * @brief Removes every candidate that would have produced a different clue.
+   */
+  void apply(std::size_t guess, int clue_value, CellSet& candidates) const;
+
+  /**
+   * @brief Best guess for the remaining targets' candidate sets.
+   */
+  std::size_t best_guess(std::span<const CellSet> candidates, const std::array<bool, TARGETS>& found,
+                         Objective objective, std::vector<std::uint32_t>& counts) const;
+
+  /**
+   * @brief First guess, which is the same in every game.
+   */
+  std::size_t opening_guess(Objective objective) const;
+
+  /**
+   * @brief Guesses taken to find every mugwump, or TURNS + 1 if any survived.
+   *
+   * @param hidden Cell of each mugwump
+   * @param objective Guess scoring
+   * @param opening Result of opening_guess()
+   */
+  int play(std::span<const std::size_t> hidden, Objective objective, std::size_t opening) const;
+
+  /**
+   * @brief Plays random games in parallel.
+   *
+   * @param games Games to play
+   * @param objective Guess scoring
+   * @param threads Worker count; 0 uses the hardware concurrency
+   * @param seed Base seed, each worker uses seed + worker index
+   */
+  SearchStats simulate(std::uint64_t games, Objective objective, unsigned threads = 0,
+                       std::uint64_t seed = 1) const;
+
+private:
+  int g;
+  std::size_t guess_budget;
+};
+
+}  // namespace grid_search
@@ -0,0 +1,81 @@
+#include "GridSearch.hpp"
+#include <cmath>
+#include <cstdlib>
+#include <print>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Prints the guesses-to-find distribution.
+ *
+ * @param stats Search results
+ * @param limit Guesses the game allows; results past it are losses
+ */
+void report(const grid_search::SearchStats& stats, int limit) {
+  std::uint64_t within = 0;
+  for (std::size_t g = 1; g < stats.histogram.size(); ++g) {
+    if (static_cast<int>(g) <= limit) within += stats.histogram[g];
+    if (stats.histogram[g]) std::println("  {:>3} GUESSES: {}", g, stats.histogram[g]);
+  }
+  std::println("TARGETS: {}  AVERAGE: {:.4f}  WORST: {}  WITHIN {} GUESSES: {:.2f}%", stats.targets,
+               stats.average, stats.worst, limit, 100.0 * within / stats.targets);
+  std::println("TIME: {:.3f}s  ({:.0f} TARGETS/SEC)", stats.seconds, stats.targets / stats.seconds);
+}
+
+/**
+ * @brief Entry point for the grid search benchmark.
+ *
+ * Usage: GridSearch [--game hurkle|depthcharge|mugwump] [--size G]
+ *                   [--objective minimax|expected] [--games N] [--threads N]
+ */
+int main(int argc, char* argv[]) {
+  std::string game = "hurkle";
+  int size = 10;
+  auto objective = grid_search::Objective::Minimax;
+  std::uint64_t games = 10000;
+  unsigned threads = 0;
+
+  for (int i = 1; i + 1 < argc; i += 2) {
+    std::string_view flag = argv[i];
+    std::string_view value = argv[i + 1];
+    if (flag == "--game") {
+      game = value;
+    } else if (flag == "--size") {
+      size = std::stoi(std::string(value));
+    } else if (flag == "--objective") {
+      objective = value == "expected" ? grid_search::Objective::Expected : grid_search::Objective::Minimax;
+    } else if (flag == "--games") {
+      games = std::stoull(std::string(value));
+    } else if (flag == "--threads") {
+      threads = static_cast<unsigned>(std::stoul(std::string(value)));
+    } else {
+      std::println(stderr, "Usage: GridSearch [--game hurkle|depthcharge|mugwump] [--size G]");
+      std::println(stderr, "                  [--objective minimax|expected] [--games N] [--threads N]");
+      return EXIT_FAILURE;
+    }
+  }
+  if (size < 1) {
+    std::println(stderr, "Error: size must be positive");
+    return EXIT_FAILURE;
+  }
+
+  if (game == "hurkle") {
+    // hurkle.bas lines 110-120: N=5 tries on a G=10 grid
+    grid_search::DirectionGrid<2> grid(size);
+    std::println("HURKLE {}x{} ({} CELLS), EXHAUSTIVE", size, size, grid.cells());
+    report(grid.search_all(objective, threads), 5);
+  } else if (game == "depthcharge") {
+    // depthcharge.bas line 30: N=INT(LOG(G)/LOG(2))+1
+    grid_search::DirectionGrid<3> grid(size);
+    int shots = static_cast<int>(std::log2(size)) + 1;
+    std::println("DEPTH CHARGE {}x{}x{} ({} CELLS), EXHAUSTIVE", size, size, size, grid.cells());
+    report(grid.search_all(objective, threads), shots);
+  } else if (game == "mugwump") {
+    grid_search::MugwumpGrid grid(size);
+    std::println("MUGWUMP {}x{} ({} CELLS), {} RANDOM GAMES", size, size, grid.cells(), games);
+    report(grid.simulate(games, objective, threads), grid_search::MugwumpGrid::TURNS);
+  } else {
+    std::println(stderr, "Error: unknown game {}", game);
+    return EXIT_FAILURE;
+  }
+}
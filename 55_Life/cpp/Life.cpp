@@ -0,0 +1,85 @@
+#include "Life.hpp"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Centres the pattern the way life.bas does (lines 80-180).
+ *
+ * The width is that of the longest row but the last, as in the original.
+ *
+ * @param pattern Pattern rows
+ */
+Life::Life(const std::vector<std::string>& pattern) : bottom(ROWS), right(COLUMNS) {
+  const int count = static_cast<int>(pattern.size());
+  std::size_t width = 0;
+  for (int x = 0; x + 1 < count; ++x) width = std::max(width, pattern[x].size());
+  top = static_cast<int>(std::floor(11 - count / 2.0));
+  left = static_cast<int>(std::floor(33 - static_cast<double>(width) / 2.0));
+  for (int x = 0; x < count; ++x) {
+    for (std::size_t y = 0; y < pattern[x].size(); ++y) {
+      const int row = top + x + 1, column = left + static_cast<int>(y) + 1;
+      if (pattern[x][y] == ' ' || row < 1 || row > ROWS || column < 1 || column > COLUMNS) continue;
+      cells[row][column] = 1;
+      ++live;
+    }
+  }
+  top = std::max(top, 1);
+  left = std::max(left, 1);
+}
+
+/**
+ * @brief Lines 215-309: settles the box, then shrinks it to the live cells.
+ */
+void Life::settle() {
+  int min_row = ROWS, max_row = 1, min_column = COLUMNS, max_column = 1;
+  ++generations;
+  for (int x = top; x <= bottom; ++x) {
+    for (int y = left; y <= right; ++y) {
+      char& cell = cells[x][y];
+      if (cell == 2) cell = 0;
+      if (cell == 3) cell = 1;
+      if (cell != 1) continue;
+      min_row = std::min(min_row, x);
+      max_row = std::max(max_row, x);
+      min_column = std::min(min_column, y);
+      max_column = std::max(max_column, y);
+    }
+  }
+  top = min_row;
+  bottom = max_row;
+  left = min_column;
+  right = max_column;
+  if (top < 3) top = 3, out_of_bounds = true;
+  if (bottom > 22) bottom = 22, out_of_bounds = true;
+  if (left < 3) left = 3, out_of_bounds = true;
+  if (right > 68) right = 68, out_of_bounds = true;
+}
+
+/**
+ * @brief Lines 500-635: counts neighbours around the box and marks births and deaths.
+ *
+ * The count includes the cell itself, so a live cell survives with 3 or 4.
+ */
+void Life::evolve() {
+  live = 0;
+  for (int x = top - 1; x <= bottom + 1; ++x) {
+    for (int y = left - 1; y <= right + 1; ++y) {
+      int count = 0;
+      for (int i = x - 1; i <= x + 1; ++i) {
+        for (int j = y - 1; j <= y + 1; ++j) count += cells[i][j] == 1 || cells[i][j] == 2;
+      }
+      char& cell = cells[x][y];
+      if (cell == 0) {
+        if (count == 3) cell = 3, ++live;
+      } else if (count < 3 || count > 4) {
+        cell = 2;
+      } else {
+        ++live;
+      }
+    }
+  }
+  --top;
+  --left;
+  ++bottom;
+  ++right;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include <string>
+#include <vector>
+
+/**
+ * @brief The LIFE board of life.bas: a 24 by 70 field, evolved only inside
+ * the box around the live cells.
+ *
+ * Cells hold the values of the BASIC array A: 0 empty, 1 alive, 2 dying
+ * (alive until the board is next settled) and 3 born (alive from then on).
+ * A pattern that reaches row 2 or 22 or column 2 or 68 is kept inside
+ * those bounds and the board is marked invalid, as in the original.
+ */
+class Life {
+public:
+  static constexpr int ROWS = 24;
+  static constexpr int COLUMNS = 70;
+
+  /**
+   * @brief Places a pattern, as typed at ENTER YOUR PATTERN, centred on the board.
+   *
+   * @param pattern Pattern rows; any character other than a space is a live cell
+   */
+  explicit Life(const std::vector<std::string>& pattern);
+
+  /**
+   * @brief Applies the births and deaths of the last evolve() and starts the next generation.
+   */
+  void settle();
+
+  /**
+   * @brief Marks the births and deaths that make the next generation.
+   */
+  void evolve();
+
+  /**
+   * @brief Whether the cell is alive once the board is settled.
+   *
+   * @param row 1 to ROWS
+   * @param column 1 to COLUMNS
+   */
+  bool alive(int row, int column) const { return cells[row][column] == 1; }
+
+  int generation() const { return generations; }
+  int population() const { return live; }
+  bool invalid() const { return out_of_bounds; }
+
+private:
+  std::array<std::array<char, COLUMNS + 2>, ROWS + 2> cells{};
+  int top, bottom, left, right;  ///< Box to settle and evolve (X1, X2, Y1, Y2)
+  int generations = 0;
+  int live = 0;
+  bool out_of_bounds = false;
+};
@@ -0,0 +1,141 @@
+#include "Life.hpp"
+#include "screen.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <print>
+#include <string>
+#include <string_view>
+#include <sys/ioctl.h>
+#include <thread>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Reads the pattern rows up to DONE; a leading '.' stands for a space, as in the original.
+ *
+ * @return The pattern rows
+ */
+std::vector<std::string> read_pattern() {
+  std::vector<std::string> pattern;
+  std::string line;
+  while (std::getline(std::cin, line) && line != "DONE") {
+    if (line.starts_with('.')) line[0] = ' ';
+    pattern.push_back(line);
+  }
+  return pattern;
+}
+
+/**
+ * @brief Rows and columns of the frame: the header line and the board,
+ * clipped to the terminal when standard output is one.
+ *
+ * A frame taller than the terminal would scroll it, and the screen would
+ * no longer know what the terminal shows.
+ */
+std::pair<int, int> frame_size() {
+  int rows = Life::ROWS + 1;
+  int columns = Life::COLUMNS + 10;
+  winsize size{};
+  if (::isatty(STDOUT_FILENO) && ::ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_row > 0 &&
+      size.ws_col > 0) {
+    rows = std::min<int>(rows, size.ws_row);
+    columns = std::min<int>(columns, size.ws_col);
+  }
+  return {rows, columns};
+}
+
+/**
+ * @brief Draws a settled generation with its header line, as lines 210-295
+ * print it, leaving out whatever falls outside the frame.
+ *
+ * @param screen Frame to draw into
+ * @param rows Rows in the frame
+ * @param columns Columns in the frame
+ * @param life Board to draw
+ */
+void draw(screen* screen, int rows, int columns, const Life& life) {
+  screen_clear(screen);
+  const std::string header = std::format("GENERATION: {}     POPULATION: {} {}", life.generation() - 1,
+                                         life.population(), life.invalid() ? "INVALID!" : "");
+  screen_write(screen, header.data(), std::min<std::size_t>(header.size(), columns));
+  for (int row = 1; row <= Life::ROWS && row < rows; ++row) {
+    for (int column = 1; column <= Life::COLUMNS && column < columns; ++column) {
+      if (!life.alive(row, column)) continue;
+      screen_move(screen, row, column);
+      screen_write(screen, "*", 1);
+    }
+  }
+}
+
+}  // namespace
+
+/**
+ * @brief Entry point for Life.
+ *
+ * Every generation is drawn as a frame of the damage-tracking renderer in
+ * screen.h, which sends only the cells that changed since the last one
+ * instead of reprinting all 24 rows. --full clears and redraws every frame
+ * for comparison. At the end the frame rate and the bytes per frame, next
+ * to what clearing and reprinting would have sent, go to stderr.
+ *
+ * Usage: Life [--generations N] [--delay MS] [--full]
+ */
+int main(int argc, char* argv[]) {
+  long generations = -1;
+  int delay = 0;
+  bool full = false;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string_view flag = argv[i];
+    if (flag == "--full") {
+      full = true;
+    } else if (flag == "--generations" && i + 1 < argc) {
+      generations = std::stol(argv[++i]);
+    } else if (flag == "--delay" && i + 1 < argc) {
+      delay = std::stoi(argv[++i]);
+    } else {
+      std::println(stderr, "Usage: Life [--generations N] [--delay MS] [--full]");
+      return EXIT_FAILURE;
+    }
+  }
+
+  try {
+    std::println("{:>37}", "LIFE");
+    std::println("{:>56}", "CREATIVE COMPUTING  MORRISTOWN, NEW JERSEY");
+    std::println("\n\n");
+    std::println("ENTER YOUR PATTERN:");
+    Life life(read_pattern());
+    std::fflush(stdout);
+
+    const auto [rows, columns] = frame_size();
+    screen* screen = screen_open(STDOUT_FILENO, rows, columns);
+    if (!screen) throw std::bad_alloc();
+    const auto start = std::chrono::steady_clock::now();
+    do {
+      life.settle();
+      draw(screen, rows, columns, life);
+      if (full) screen_invalidate(screen);
+      screen_flush(screen);
+      life.evolve();
+      if (delay > 0) std::this_thread::sleep_for(std::chrono::milliseconds(delay));
+    } while (life.population() > 0 && life.generation() != generations);
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    const screen_stats stats = screen_get_stats(screen);
+    screen_close(screen);
+    std::println(stderr, "GENERATIONS: {}  FRAMES/SEC: {:.0f}", stats.frames, stats.frames / elapsed.count());
+    std::println(stderr, "BYTES/FRAME: {:.1f}  (CLEARING AND REPRINTING: {:.1f})",
+                 static_cast<double>(stats.bytes) / stats.frames,
+                 static_cast<double>(stats.full_bytes) / stats.frames);
+  } catch (const std::exception& e) {
+    std::println(stderr, "Error: {}", e.what());
+    return EXIT_FAILURE;
+  }
+}
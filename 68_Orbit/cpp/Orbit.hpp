@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/**
+ * @brief Intercept solver for ORBIT (orbit.bas lines 270-460).
+ *
+ * The Romulan ship starts at a whole-degree angle A (0-359), a distance D
+ * (200-399 hundred miles) and moves R (10-29) degrees per hour. That is only
+ * 1.44 million possible orbits, so the solver keeps every orbit that is still
+ * consistent with the reported miss distances and aims the next bomb at one
+ * of them.
+ */
+namespace orbit {
+
+inline constexpr int HOURS = 7;              ///< Line 310
+inline constexpr double KILL_RADIUS = 50.0;  ///< Line 450, in hundreds of miles
+inline constexpr double PI = 3.14159;        ///< The approximation used by line 430
+
+inline constexpr int ANGLES = 360;
+inline constexpr int MIN_DISTANCE = 200;
+inline constexpr int DISTANCES = 200;
+inline constexpr int MIN_RATE = 10;
+inline constexpr int RATES = 20;
+inline constexpr std::uint32_t ORBITS = ANGLES * DISTANCES * RATES;
+
+/**
+ * @brief A bomb aimed at an angle and detonation distance.
+ */
+struct Shot {
+  double angle;
+  double distance;
+};
+
+/**
+ * @brief One possible Romulan orbit.
+ */
+struct Ship {
+  int angle;     ///< Starting angle A in degrees
+  int distance;  ///< D in hundreds of miles
+  int rate;      ///< R in degrees per hour
+
+  static Ship from_index(std::uint32_t index);
+  double angle_at(int hour) const;
+};
+
+/**
+ * @brief Distance between the bomb and the ship, exactly as lines 400-430 compute it.
+ */
+double miss_distance(double ship_angle, double ship_distance, Shot shot);
+
+/**
+ * @brief Miss distances for many ship positions; written to be auto-vectorised.
+ */
+void miss_distances(std::span<const double> ship_angles, std::span<const double> ship_distances,
+                    Shot shot, std::span<double> out);
+
+/**
+ * @brief Set of orbits still consistent with every reported miss distance.
+ */
+class Tracker {
+public:
+  /**
+   * @brief The bomb fired in hour 1 before anything is known.
+   */
+  static constexpr Shot OPENING_SHOT{0.0, 300.0};
+
+  Tracker();
+
+  /**
+   * @brief Bomb to fire in the given hour (1-based).
+   */
+  Shot next_shot(int hour) const;
+
+  /**
+   * @brief Removes every orbit whose miss distance for this shot differs from the report.
+   *
+   * @param hour Hour the bomb was fired (1-based)
+   * @param shot The bomb that was fired
+   * @param reported Miss distance printed by the game
+   */
+  void observe(int hour, Shot shot, double reported);
+
+  std::size_t remaining() const { return candidates.size(); }
+
+  /**
+   * @brief Total number of miss distances evaluated by this tracker.
+   */
+  std::uint64_t evaluations() const { return evaluated; }
+
+private:
+  std::vector<std::uint32_t> candidates;  ///< Orbit indices, empty until the first report
+  bool started = false;
+  std::uint64_t evaluated = 0;
+
+  // Scratch buffers for the batched distance loop
+  std::vector<double> angles;
+  std::vector<double> distances;
+  std::vector<double> misses;
+};
+
+/**
+ * @brief Aggregate results of simulated games.
+ */
+struct SimulationResult {
+  std::uint64_t games = 0;
+  std::uint64_t destroyed_in_hour[HOURS + 1] = {};  ///< Index 0 counts escapes
+  double mean_hours = 0;                            ///< Over destroyed ships
+  std::uint64_t evaluations = 0;                    ///< Miss distances computed
+  double seconds = 0;
+};
+
+/**
+ * @brief Plays many games with the tracker on several threads.
+ *
+ * @param games Number of ships to hunt
+ * @param threads Worker count; 0 uses the hardware concurrency
+ * @param seed Base seed, each worker uses seed + worker index
+ */
+SimulationResult simulate(std::uint64_t games, unsigned threads = 0, std::uint64_t seed = 1);
+
+}  // namespace orbit
@@ -0,0 +1,38 @@
+#include "Orbit.hpp"
+#include <cstdlib>
+#include <print>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Entry point for the ORBIT intercept benchmark.
+ *
+ * Usage: OrbitBench [--games N] [--threads N]
+ */
+int main(int argc, char* argv[]) {
+  std::uint64_t games = 2000;
+  unsigned threads = 0;
+
+  for (int i = 1; i + 1 < argc; i += 2) {
+    std::string_view flag = argv[i];
+    if (flag == "--games") {
+      games = std::stoull(argv[i + 1]);
+    } else if (flag == "--threads") {
+      threads = static_cast<unsigned>(std::stoul(argv[i + 1]));
+    } else {
+      std::println(stderr, "Usage: OrbitBench [--games N] [--threads N]");
+      return EXIT_FAILURE;
+    }
+  }
+
+  orbit::SimulationResult r = orbit::simulate(games, threads);
+
+  std::println("SHIPS HUNTED: {}  TIME: {:.3f}s  GAMES/SEC: {:.1f}", r.games, r.seconds,
+               r.games / r.seconds);
+  std::println("INTERCEPTS EVALUATED: {:.1f} M/SEC", r.evaluations / r.seconds / 1e6);
+  std::println("MEAN HOUR OF DESTRUCTION: {:.3f}", r.mean_hours);
+  for (int h = 1; h <= orbit::HOURS; ++h) {
+    std::println("  HOUR {}: {:6.2f}%", h, 100.0 * r.destroyed_in_hour[h] / r.games);
+  }
+  std::println("  ESCAPED: {:6.2f}%", 100.0 * r.destroyed_in_hour[0] / r.games);
+}
@@ -0,0 +1,254 @@
+#include "ReverseSolver.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+
+/**
+ * @brief Factorials up to 20!, the largest that fits in 64 bits.
+ */
+constexpr std::array<std::uint64_t, ReverseSolver::MAX_N + 1> FACTORIAL = [] {
+  std::array<std::uint64_t, ReverseSolver::MAX_N + 1> f{};
+  f[0] = 1;
+  for (std::size_t i = 1; i < f.size(); ++i) f[i] = f[i - 1] * i;
+  return f;
+}();
+
+void check_list(ReverseSolver::List list) {
+  if (list.empty() || list.size() > ReverseSolver::MAX_N) {
+    throw std::invalid_argument("list size must be between 1 and 20");
+  }
+  std::array<bool, ReverseSolver::MAX_N + 1> seen{};
+  for (int v : list) {
+    if (v < 1 || v > static_cast<int>(list.size()) || seen[v]) {
+      throw std::invalid_argument("list must be a permutation of 1..N");
+    }
+    seen[v] = true;
+  }
+}
+
+}  // namespace
+
+/**
+ * @brief Constructs a solver with a bound on bidirectional search memory.
+ *
+ * @param max_bfs_states Maximum number of ranked states held across both frontiers
+ */
+ReverseSolver::ReverseSolver(std::size_t max_bfs_states)
+  : max_bfs_states(max_bfs_states) {}
+
+/**
+ * @brief Ranks a permutation of 1..N into [0, N!).
+ *
+ * @param list Permutation to rank
+ * @return Lehmer-code rank
+ */
+std::uint64_t ReverseSolver::rank(List list) {
+  const std::size_t n = list.size();
+  std::uint64_t r = 0;
+  for (std::size_t i = 0; i < n; ++i) {
+    std::uint64_t smaller = 0;
+    for (std::size_t j = i + 1; j < n; ++j) {
+      if (list[j] < list[i]) ++smaller;
+    }
+    r += smaller * FACTORIAL[n - 1 - i];
+  }
+  return r;
+}
+
+/**
+ * @brief Writes the permutation of 1..n with rank r.
+ *
+ * @param r Rank produced by rank()
+ * @param n Number of elements
+ * @param out Destination, at least n elements
+ */
+void ReverseSolver::unrank(std::uint64_t r, std::size_t n, std::span<int> out) {
+  std::array<int, MAX_N> pool{};
+  for (std::size_t i = 0; i < n; ++i) pool[i] = static_cast<int>(i + 1);
+
+  std::size_t remaining = n;
+  for (std::size_t i = 0; i < n; ++i) {
+    const std::uint64_t f = FACTORIAL[n - 1 - i];
+    const auto idx = static_cast<std::size_t>(r / f);
+    r %= f;
+    out[i] = pool[idx];
+    std::copy(pool.begin() + idx + 1, pool.begin() + remaining, pool.begin() + idx);
+    --remaining;
+  }
+}
+
+/**
+ * @brief Counts gaps, i.e. adjacent values that are not consecutive.
+ *
+ * A sentinel N+1 is appended so that the largest value must end up last.
+ * Each reversal can remove at most one gap, making this an admissible
+ * lower bound for the number of moves left.
+ *
+ * @param list Current list
+ * @return Number of gaps
+ */
+int ReverseSolver::gap_count(List list) {
+  int gaps = 0;
+  const std::size_t n = list.size();
+  for (std::size_t i = 0; i < n; ++i) {
+    const int next = i + 1 < n ? list[i + 1] : static_cast<int>(n) + 1;
+    if (std::abs(list[i] - next) != 1) ++gaps;
+  }
+  return gaps;
+}
+
+/**
+ * @brief Returns the minimum number of reversals needed to sort a list.
+ *
+ * IDA* is used because the gap heuristic is tight enough that it beats the
+ * bidirectional search at every list size while using no table at all.
+ *
+ * @param list Permutation of 1..N
+ * @return Par score for the list
+ */
+int ReverseSolver::par(List list) {
+  return par_ida_star(list);
+}
+
+/**
+ * @brief Returns one optimal move sequence for a list.
+ *
+ * @param list Permutation of 1..N
+ * @return Reversal counts to enter, in order
+ */
+std::vector<int> ReverseSolver::solve(List list) {
+  check_list(list);
+  std::vector<int> moves;
+  par_ida_star(list, &moves);
+  return moves;
+}
+
+/**
+ * @brief Bidirectional breadth-first search between the list and 1..N.
+ *
+ * Both sides store states as ranks. The smaller frontier is expanded one
+ * full layer at a time, and the best meeting point in that layer is kept,
+ * so the first layer with any meeting yields the optimum.
+ *
+ * @param list Permutation of 1..N
+ * @return Par score, or empty if more than max_bfs_states would be stored
+ */
+std::optional<int> ReverseSolver::par_bidirectional(List list) {
+  check_list(list);
+  const std::size_t n = list.size();
+
+  std::array<int, MAX_N> identity{};
+  for (std::size_t i = 0; i < n; ++i) identity[i] = static_cast<int>(i + 1);
+
+  const std::uint64_t start = rank(list);
+  const std::uint64_t goal = rank(std::span<const int>(identity.data(), n));
+  if (start == goal) return 0;
+
+  std::unordered_map<std::uint64_t, int> seen[2];
+  std::vector<std::uint64_t> frontier[2] = {{start}, {goal}};
+  seen[0].emplace(start, 0);
+  seen[1].emplace(goal, 0);
+  int depth[2] = {0, 0};
+
+  std::array<int, MAX_N> perm{};
+  std::vector<std::uint64_t> next;
+
+  while (!frontier[0].empty() && !frontier[1].empty()) {
+    const int side = frontier[0].size() <= frontier[1].size() ? 0 : 1;
+    const int other = 1 - side;
+    int best = std::numeric_limits<int>::max();
+    next.clear();
+
+    for (std::uint64_t r : frontier[side]) {
+      unrank(r, n, perm);
+      for (std::size_t k = 2; k <= n; ++k) {
+        std::reverse(perm.begin(), perm.begin() + k);
+        const std::uint64_t child = rank(std::span<const int>(perm.data(), n));
+        std::reverse(perm.begin(), perm.begin() + k);
+
+        if (auto hit = seen[other].find(child); hit != seen[other].end()) {
+          best = std::min(best, depth[side] + 1 + hit->second);
+        }
+        if (seen[side].emplace(child, depth[side] + 1).second) {
+          next.push_back(child);
+        }
+      }
+    }
+
+    if (best != std::numeric_limits<int>::max()) return best;
+    if (seen[0].size() + seen[1].size() > max_bfs_states) return std::nullopt;
+
+    frontier[side].swap(next);
+    ++depth[side];
+  }
+
+  return std::nullopt;
+}
+
+/**
+ * @brief Iterative-deepening A* with the gap heuristic.
+ *
+ * @param list Permutation of 1..N
+ * @param moves If not null, receives one optimal move sequence
+ * @return Par score for the list
+ */
+int ReverseSolver::par_ida_star(List list, std::vector<int>* moves) {
+  check_list(list);
+  const int n = static_cast<int>(list.size());
+
+  State s{};
+  for (int i = 0; i < n; ++i) s[i] = static_cast<std::int8_t>(list[i]);
+  s[n] = static_cast<std::int8_t>(n + 1);
+
+  std::vector<int> path;
+  const int h = gap_count(list);
+  int bound = h;
+  while (true) {
+    const int t = ida_search(s, n, 0, h, bound, 0, path);
+    if (t < 0) break;
+    bound = t;
+  }
+
+  if (moves) *moves = path;
+  return static_cast<int>(path.size());
+}
+
+/**
+ * @brief One bounded depth-first pass of IDA*.
+ *
+ * Only the gap at the reversal boundary can change, so the heuristic is
+ * updated incrementally instead of recounted.
+ *
+ * @return -1 when solved, otherwise the smallest f-cost that exceeded the bound
+ */
+int ReverseSolver::ida_search(State& s, int n, int g, int h, int bound, int last, std::vector<int>& path) {
+  if (h == 0) return -1;
+  if (g + h > bound) return g + h;
+
+  int min_exceeded = std::numeric_limits<int>::max();
+  for (int k = n; k >= 2; --k) {
+    if (k == last) continue;
+
+    // Reversing the prefix swaps which value sits next to s[k].
+    const bool gap_before = std::abs(s[k - 1] - s[k]) != 1;
+    const bool gap_after = std::abs(s[0] - s[k]) != 1;
+    const int child_h = h - gap_before + gap_after;
+    if (g + 1 + child_h > bound) {
+      min_exceeded = std::min(min_exceeded, g + 1 + child_h);
+      continue;
+    }
+
+    std::reverse(s.begin(), s.begin() + k);
+    path.push_back(k);
+    const int t = ida_search(s, n, g + 1, child_h, bound, k, path);
+    if (t < 0) return -1;
+    path.pop_back();
+    std::reverse(s.begin(), s.begin() + k);
+    min_exceeded = std::min(min_exceeded, t);
+  }
+  return min_exceeded;
+}
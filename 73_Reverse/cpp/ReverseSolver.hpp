@@ -0,0 +1,75 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+/**
+ * @brief Finds the minimum number of prefix reversals that sorts a REVERSE list.
+ *
+ * Lists hold the numbers 1..N (N <= 20, matching DIM A(20) in reverse.bas).
+ * Par scores come from IDA* with the gap heuristic, whose memory use is
+ * bounded by the search depth. A bidirectional breadth-first search over
+ * permutation ranks is also provided, capped by a state budget, as an
+ * independent exact check for small lists.
+ */
+class ReverseSolver {
+public:
+  static constexpr std::size_t MAX_N = 20;
+
+  using List = std::span<const int>;
+
+  /**
+   * @brief Constructs a solver.
+   *
+   * @param max_bfs_states Upper bound on states stored by the bidirectional search
+   */
+  explicit ReverseSolver(std::size_t max_bfs_states = 4'000'000);
+
+  /**
+   * @brief Returns the par score (minimum number of reversals) for a list.
+   */
+  int par(List list);
+
+  /**
+   * @brief Returns one optimal sequence of reversal counts for a list.
+   *
+   * Each entry is the R the player would type at "HOW MANY SHALL I REVERSE".
+   */
+  std::vector<int> solve(List list);
+
+  /**
+   * @brief Bidirectional BFS; empty if the state budget was exhausted.
+   */
+  std::optional<int> par_bidirectional(List list);
+
+  /**
+   * @brief IDA* search with the gap heuristic.
+   */
+  int par_ida_star(List list, std::vector<int>* moves = nullptr);
+
+  /**
+   * @brief Ranks a permutation of 1..N into [0, N!) using its Lehmer code.
+   */
+  static std::uint64_t rank(List list);
+
+  /**
+   * @brief Inverse of rank(): writes the permutation of 1..n with the given rank.
+   */
+  static void unrank(std::uint64_t r, std::size_t n, std::span<int> out);
+
+  /**
+   * @brief Number of adjacent pairs (including the end sentinel) that differ by more than one.
+   */
+  static int gap_count(List list);
+
+private:
+  using State = std::array<std::int8_t, MAX_N + 1>;
+
+  std::size_t max_bfs_states;   ///< Memory bound for the bidirectional search
+
+  int ida_search(State& s, int n, int g, int h, int bound, int last, std::vector<int>& path);
+};
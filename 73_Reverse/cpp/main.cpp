@@ -0,0 +1,131 @@
+#include "ReverseSolver.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <print>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Deals a list the way reverse.bas does (lines 210-260).
+ *
+ * The first number is never 1, so the dealt list is never already sorted.
+ */
+std::vector<int> deal_list(int n, std::mt19937& rng) {
+  std::vector<int> list(n);
+  std::uniform_int_distribution<int> first(2, n);
+  std::uniform_int_distribution<int> any(1, n);
+  std::vector<bool> used(n + 1, false);
+
+  list[0] = n > 1 ? first(rng) : 1;
+  used[list[0]] = true;
+  for (int k = 1; k < n; ++k) {
+    int value;
+    do {
+      value = any(rng);
+    } while (used[value]);
+    list[k] = value;
+    used[value] = true;
+  }
+  return list;
+}
+
+void print_list(const std::vector<int>& list) {
+  for (int v : list) std::print(" {}", v);
+  std::println("");
+}
+
+/**
+ * @brief Solves many dealt lists and reports throughput.
+ */
+int run_benchmark(int n, int count) {
+  ReverseSolver solver;
+  std::mt19937 rng(12345);
+
+  std::vector<std::vector<int>> lists;
+  lists.reserve(count);
+  for (int i = 0; i < count; ++i) lists.push_back(deal_list(n, rng));
+
+  long total_par = 0;
+  int max_par = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (const auto& list : lists) {
+    int p = solver.par(list);
+    total_par += p;
+    max_par = std::max(max_par, p);
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  std::println("N={} LISTS={} TIME={:.3f}s", n, count, elapsed.count());
+  std::println("IDA* SOLVES/SEC: {:.1f}", count / elapsed.count());
+  std::println("AVERAGE PAR: {:.3f}  WORST PAR: {}", static_cast<double>(total_par) / count, max_par);
+
+  if (n > 10) return 0;
+
+  int mismatches = 0;
+  int exhausted = 0;
+  start = std::chrono::steady_clock::now();
+  for (const auto& list : lists) {
+    auto p = solver.par_bidirectional(list);
+    if (!p) {
+      ++exhausted;
+    } else if (*p != solver.par_ida_star(list)) {
+      ++mismatches;
+    }
+  }
+  elapsed = std::chrono::steady_clock::now() - start;
+  std::println("BIDIRECTIONAL BFS SOLVES/SEC: {:.1f} (OVER BUDGET: {}, MISMATCHES: {})",
+               count / elapsed.count(), exhausted, mismatches);
+  return mismatches == 0 ? 0 : 1;
+}
+
+/**
+ * @brief Entry point for the REVERSE par-score solver.
+ *
+ * Usage:
+ *   ReverseSolver [N]                 deal a list of N (default 9) and show its par
+ *   ReverseSolver --list A1 A2 ...    show par and an optimal solution for a list
+ *   ReverseSolver --bench N COUNT     solve COUNT dealt lists and report solves/sec
+ */
+int main(int argc, char* argv[]) {
+  std::vector<std::string_view> args(argv + 1, argv + argc);
+
+  try {
+    if (!args.empty() && args[0] == "--bench") {
+      int n = args.size() > 1 ? std::stoi(std::string(args[1])) : 9;
+      int count = args.size() > 2 ? std::stoi(std::string(args[2])) : 1000;
+      if (n < 1 || n > static_cast<int>(ReverseSolver::MAX_N) || count < 1) {
+        std::println(stderr, "N MUST BE BETWEEN 1 AND {} AND COUNT AT LEAST 1", ReverseSolver::MAX_N);
+        return EXIT_FAILURE;
+      }
+      return run_benchmark(n, count);
+    }
+
+    std::vector<int> list;
+    if (!args.empty() && args[0] == "--list") {
+      for (std::size_t i = 1; i < args.size(); ++i) list.push_back(std::stoi(std::string(args[i])));
+    } else {
+      int n = args.empty() ? 9 : std::stoi(std::string(args[0]));
+      if (n < 1 || n > static_cast<int>(ReverseSolver::MAX_N)) {
+        std::println(stderr, "N MUST BE BETWEEN 1 AND {}", ReverseSolver::MAX_N);
+        return EXIT_FAILURE;
+      }
+      std::mt19937 rng(std::random_device{}());
+      list = deal_list(n, rng);
+    }
+
+    ReverseSolver solver;
+    std::println("HERE WE GO ... THE LIST IS:");
+    print_list(list);
+    std::println("PAR FOR THIS LIST: {} MOVES", solver.par(list));
+
+    std::print("ONE OPTIMAL SOLUTION: REVERSE");
+    for (int r : solver.solve(list)) std::print(" {}", r);
+    std::println("");
+  } catch (const std::exception& e) {
+    std::println(stderr, "Error: {}", e.what());
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,169 @@
+#include "Predictor.hpp"
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+namespace rps {
+
+namespace {
+
+std::uint64_t mix(std::uint64_t x) {
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+}  // namespace
+
+/**
+ * @brief Creates an empty predictor.
+ *
+ * @param budget_bytes Size of the shared count table; rounded down to a power of two
+ * @param max_order Longest context used, 0 to MAX_ORDER
+ */
+Predictor::Predictor(std::size_t budget_bytes, int max_order) : max_order(max_order) {
+  if (max_order < 0 || max_order > MAX_ORDER) throw std::invalid_argument("order must be 0 to 15");
+  const std::size_t count = std::bit_floor(budget_bytes / sizeof(Bucket));
+  if (count == 0) throw std::invalid_argument("memory budget is smaller than one bucket");
+  buckets.resize(count);
+  bucket_mask = count - 1;
+}
+
+/**
+ * @brief Starts modelling a new player.
+ */
+std::uint32_t Predictor::add_player() {
+  histories.emplace_back();
+  return static_cast<std::uint32_t>(histories.size() - 1);
+}
+
+/**
+ * @brief Hashes one context: a player, an order and that many recent rounds.
+ */
+std::uint64_t Predictor::hash(std::uint32_t player, int order, std::uint64_t rounds) const {
+  const std::uint64_t recent = order ? rounds & (~std::uint64_t{0} >> (64 - 4 * order)) : 0;
+  return mix(mix(recent ^ static_cast<std::uint64_t>(order) << 60) ^ player);
+}
+
+/**
+ * @brief Looks up a context's counts.
+ *
+ * @return The entry, or null if the context has not been seen or was evicted
+ */
+const Predictor::Entry* Predictor::find(std::uint64_t h) const {
+  const std::uint32_t tag = static_cast<std::uint32_t>(h >> 32) | 1;
+  for (const Entry& e : buckets[h & bucket_mask].entries) {
+    if (e.tag == tag) return &e;
+  }
+  return nullptr;
+}
+
+/**
+ * @brief Looks up a context's counts, replacing the bucket's least-used entry if absent.
+ */
+Predictor::Entry& Predictor::find_or_insert(std::uint64_t h) {
+  const std::uint32_t tag = static_cast<std::uint32_t>(h >> 32) | 1;
+  Bucket& bucket = buckets[h & bucket_mask];
+  Entry* victim = &bucket.entries[0];
+  int victim_total = 1 << 30;
+  for (Entry& e : bucket.entries) {
+    if (e.tag == tag) return e;
+    const int total = e.tag ? e.counts[0] + e.counts[1] + e.counts[2] : -1;
+    if (total < victim_total) {
+      victim = &e;
+      victim_total = total;
+    }
+  }
+  *victim = Entry{tag, {}, 0};
+  return *victim;
+}
+
+/**
+ * @brief Estimated probability of each throw for the player's next move.
+ *
+ * All buckets are prefetched before the first is read, so the lookups'
+ * cache misses overlap. Every order with data votes with its observed
+ * frequencies. Longer contexts are more specific, so their weight doubles
+ * with each order, and a context seen only once counts for half as much as
+ * a well-established one.
+ *
+ * @param player Id from add_player()
+ * @return Probabilities indexed by Throw
+ */
+std::array<double, 3> Predictor::predict(std::uint32_t player) const {
+  const History& history = histories[player];
+  std::array<double, 3> score{1.0 / 3, 1.0 / 3, 1.0 / 3};
+  double weight_sum = 1;
+
+  const int top = std::min<int>(max_order, history.length);
+  std::array<std::uint64_t, MAX_ORDER + 1> hashes;
+  for (int order = 0; order <= top; ++order) {
+    hashes[order] = hash(player, order, history.rounds);
+    __builtin_prefetch(&buckets[hashes[order] & bucket_mask]);
+  }
+  for (int order = 0; order <= top; ++order) {
+    const Entry* e = find(hashes[order]);
+    if (!e) continue;
+    const double total = e->counts[0] + e->counts[1] + e->counts[2];
+    if (total == 0) continue;
+    const double weight = static_cast<double>(1 << order) * total / (total + 1);
+    for (int t = 0; t < 3; ++t) score[t] += weight * e->counts[t] / total;
+    weight_sum += weight;
+  }
+
+  for (double& s : score) s /= weight_sum;
+  return score;
+}
+
+/**
+ * @brief The computer's throw with the best expected result against predict().
+ *
+ * Throw c wins against the throw it beats and loses to winner_over(c), so
+ * its expected result is P(beaten by c) - P(winner over c).
+ */
+Throw Predictor::respond(std::uint32_t player) const {
+  const std::array<double, 3> p = predict(player);
+  int best = 0;
+  double best_value = -2;
+  for (int c = 0; c < 3; ++c) {
+    const double value = p[(c + 2) % 3] - p[(c + 1) % 3];
+    if (value > best_value) {
+      best = c;
+      best_value = value;
+    }
+  }
+  return static_cast<Throw>(best);
+}
+
+/**
+ * @brief Records a finished round in every context that preceded it.
+ *
+ * @param player Id from add_player()
+ * @param player_throw What the player threw
+ * @param computer_throw What the computer threw
+ */
+void Predictor::update(std::uint32_t player, Throw player_throw, Throw computer_throw) {
+  History& history = histories[player];
+  const int t = static_cast<int>(player_throw);
+
+  const int top = std::min<int>(max_order, history.length);
+  std::array<std::uint64_t, MAX_ORDER + 1> hashes;
+  for (int order = 0; order <= top; ++order) {
+    hashes[order] = hash(player, order, history.rounds);
+    __builtin_prefetch(&buckets[hashes[order] & bucket_mask]);
+  }
+  for (int order = 0; order <= top; ++order) {
+    Entry& e = find_or_insert(hashes[order]);
+    if (++e.counts[t] > COUNT_LIMIT) {
+      for (std::uint8_t& c : e.counts) c /= 2;
+    }
+  }
+
+  const std::uint64_t round = static_cast<std::uint64_t>(t * 3 + static_cast<int>(computer_throw));
+  history.rounds = history.rounds << 4 | round;
+  history.length = static_cast<std::uint8_t>(std::min(history.length + 1, MAX_ORDER));
+}
+
+}  // namespace rps
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Opponent modelling for ROCK, SCISSORS, PAPER (rockscissors.bas).
+ *
+ * The BASIC program picks its throw with RND at line 80. The predictor
+ * instead learns each player's habits from the rounds played so far and
+ * answers with the throw that does best against the predicted one.
+ */
+namespace rps {
+
+/**
+ * @brief A throw, numbered as in the program less one (line 90).
+ */
+enum class Throw : std::uint8_t { Paper = 0, Scissors = 1, Rock = 2 };
+
+/**
+ * @brief The throw that beats t.
+ */
+constexpr Throw winner_over(Throw t) {
+  return static_cast<Throw>((static_cast<int>(t) + 1) % 3);
+}
+
+/**
+ * @brief Result for the computer: 1 if it wins, -1 if it loses, 0 for a tie (lines 170-250).
+ */
+constexpr int outcome(Throw computer, Throw player) {
+  if (computer == player) return 0;
+  return computer == winner_over(player) ? 1 : -1;
+}
+
+/**
+ * @brief Variable-order context tree over many players' throw histories.
+ *
+ * A context is the last k rounds of one player's game, each round being the
+ * pair (player throw, computer throw), for every k from 0 to the maximum
+ * order. Contexts are never stored as tree nodes; each is hashed into one
+ * shared, fixed-size table of throw counts, so the memory used does not grow
+ * with the number of players or rounds. A bucket holds four entries on one
+ * cache line and evicts its least-used entry when a new context arrives.
+ *
+ * Prediction and update each touch max_order + 1 buckets, independent of how
+ * long the game has run. Not thread-safe.
+ */
+class Predictor {
+public:
+  static constexpr int MAX_ORDER = 15;  ///< Rounds that fit the packed history
+
+  /**
+   * @brief Creates an empty predictor.
+   *
+   * @param budget_bytes Size of the shared count table; rounded down to a power of two
+   * @param max_order Longest context used, 0 to MAX_ORDER
+   */
+  explicit Predictor(std::size_t budget_bytes, int max_order = 6);
+
+  /**
+   * @brief Starts modelling a new player.
+   *
+   * @return Player id for predict(), respond() and update()
+   */
+  std::uint32_t add_player();
+
+  /**
+   * @brief Estimated probability of each throw for the player's next move.
+   */
+  std::array<double, 3> predict(std::uint32_t player) const;
+
+  /**
+   * @brief The computer's throw with the best expected result against predict().
+   */
+  Throw respond(std::uint32_t player) const;
+
+  /**
+   * @brief Records a finished round in every context that preceded it.
+   */
+  void update(std::uint32_t player, Throw player_throw, Throw computer_throw);
+
+  std::size_t players() const { return histories.size(); }
+  std::size_t table_bytes() const { return buckets.size() * sizeof(Bucket); }
+
+private:
+  static constexpr std::uint8_t COUNT_LIMIT = 60;  ///< Counts halve past this, forgetting old habits
+
+  struct Entry {
+    std::uint32_t tag = 0;  ///< 0 marks an empty entry
+    std::array<std::uint8_t, 3> counts{};
+    std::uint8_t unused = 0;
+  };
+
+  struct alignas(32) Bucket {
+    std::array<Entry, 4> entries;
+  };
+
+  /**
+   * @brief Packed recent rounds, four bits per round, newest in the low bits.
+   */
+  struct History {
+    std::uint64_t rounds = 0;
+    std::uint8_t length = 0;  ///< Rounds recorded, saturating at MAX_ORDER
+  };
+
+  std::uint64_t hash(std::uint32_t player, int order, std::uint64_t rounds) const;
+  const Entry* find(std::uint64_t h) const;
+  Entry& find_or_insert(std::uint64_t h);
+
+  int max_order;
+  std::uint64_t bucket_mask;
+  std::vector<Bucket> buckets;
+  std::vector<History> histories;
+};
+
+}  // namespace rps
@@ -0,0 +1,153 @@
+#include "Predictor.hpp"
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <print>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+using rps::Throw;
+
+/**
+ * @brief Scripted opponents that behave like people rather than RND.
+ */
+enum class Style { Cycle, Favourite, WinStayLoseShift, CopyComputer, BeatLast, Pattern, Random, COUNT };
+
+constexpr std::array<std::string_view, static_cast<int>(Style::COUNT)> STYLE_NAMES = {
+  "CYCLE", "FAVOURITE", "WIN-STAY LOSE-SHIFT", "COPY COMPUTER", "BEAT LAST", "PATTERN OF 5", "RANDOM"};
+
+/**
+ * @brief One scripted player: a style, a little noise and the last round played.
+ */
+struct Opponent {
+  Style style;
+  std::mt19937 rng;
+  Throw mine = Throw::Rock;
+  Throw theirs = Throw::Rock;
+  int result = 0;  ///< Computer's result last round
+  int round = 0;
+
+  Throw next() {
+    std::uniform_int_distribution<int> any(0, 2);
+    std::uniform_real_distribution<double> unit(0, 1);
+    // People stray from their habit now and then.
+    if (style != Style::Random && unit(rng) < 0.1) return static_cast<Throw>(any(rng));
+
+    switch (style) {
+      case Style::Cycle:
+        return static_cast<Throw>(round % 3);
+      case Style::Favourite:
+        return unit(rng) < 0.5 ? Throw::Rock : static_cast<Throw>(any(rng));
+      case Style::WinStayLoseShift:
+        return result < 0 ? mine : rps::winner_over(mine);
+      case Style::CopyComputer:
+        return theirs;
+      case Style::BeatLast:
+        return rps::winner_over(theirs);
+      case Style::Pattern: {
+        constexpr std::array<Throw, 5> pattern = {Throw::Rock, Throw::Rock, Throw::Paper, Throw::Scissors,
+                                                  Throw::Paper};
+        return pattern[round % 5];
+      }
+      default:
+        return static_cast<Throw>(any(rng));
+    }
+  }
+
+  void record(Throw player, Throw computer) {
+    mine = player;
+    theirs = computer;
+    result = rps::outcome(computer, player);
+    ++round;
+  }
+};
+
+struct Tally {
+  std::uint64_t won = 0, lost = 0, tied = 0;
+
+  void add(int result) { (result > 0 ? won : result < 0 ? lost : tied)++; }
+  std::uint64_t games() const { return won + lost + tied; }
+};
+
+}  // namespace
+
+/**
+ * @brief Entry point for the predictor benchmark.
+ *
+ * Plays every scripted player in interleaved rounds, as a server hosting
+ * many games at once would, and compares the predictor's record with the
+ * one-in-three the BASIC program's RND choice gets.
+ *
+ * Usage: PredictorBench [--players N] [--rounds N] [--budget MB] [--order N]
+ */
+int main(int argc, char* argv[]) {
+  std::uint32_t players = 10'000;
+  int rounds = 200;
+  std::size_t budget_mb = 16;
+  int order = 6;
+
+  for (int i = 1; i + 1 < argc; i += 2) {
+    std::string_view flag = argv[i];
+    if (flag == "--players") {
+      players = static_cast<std::uint32_t>(std::stoul(argv[i + 1]));
+    } else if (flag == "--rounds") {
+      rounds = std::stoi(argv[i + 1]);
+    } else if (flag == "--budget") {
+      budget_mb = std::stoul(argv[i + 1]);
+    } else if (flag == "--order") {
+      order = std::stoi(argv[i + 1]);
+    } else {
+      std::println(stderr, "Usage: PredictorBench [--players N] [--rounds N] [--budget MB] [--order N]");
+      return EXIT_FAILURE;
+    }
+  }
+
+  try {
+    rps::Predictor predictor(budget_mb << 20, order);
+    std::vector<Opponent> opponents;
+    for (std::uint32_t p = 0; p < players; ++p) {
+      predictor.add_player();
+      opponents.push_back(Opponent{static_cast<Style>(p % static_cast<int>(Style::COUNT)), std::mt19937(p)});
+    }
+
+    std::array<Tally, static_cast<int>(Style::COUNT)> tallies{};
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+      for (std::uint32_t p = 0; p < players; ++p) {
+        Opponent& opponent = opponents[p];
+        const Throw computer = predictor.respond(p);
+        const Throw player = opponent.next();
+        predictor.update(p, player, computer);
+        opponent.record(player, computer);
+        tallies[static_cast<int>(opponent.style)].add(rps::outcome(computer, player));
+      }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const double moves = static_cast<double>(players) * rounds;
+    std::println("PLAYERS: {}  ROUNDS: {}  TABLE: {} MB  ORDER: {}", players, rounds,
+                 predictor.table_bytes() >> 20, order);
+    std::println("TIME: {:.3f}s  ({:.2f} M PREDICTIONS/SEC)", seconds, moves / seconds / 1e6);
+
+    Tally overall;
+    std::println("{:<22}{:>8}{:>8}{:>8}", "OPPONENT", "I WIN", "YOU WIN", "TIE");
+    for (int s = 0; s < static_cast<int>(Style::COUNT); ++s) {
+      const Tally& t = tallies[s];
+      if (!t.games()) continue;
+      std::println("{:<22}{:>7.1f}%{:>7.1f}%{:>7.1f}%", STYLE_NAMES[s], 100.0 * t.won / t.games(),
+                   100.0 * t.lost / t.games(), 100.0 * t.tied / t.games());
+      overall.won += t.won;
+      overall.lost += t.lost;
+      overall.tied += t.tied;
+    }
+    std::println("{:<22}{:>7.1f}%{:>7.1f}%{:>7.1f}%", "ALL", 100.0 * overall.won / overall.games(),
+                 100.0 * overall.lost / overall.games(), 100.0 * overall.tied / overall.games());
+  } catch (const std::exception& e) {
+    std::println(stderr, "Error: {}", e.what());
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,255 @@
+#include "JumpRanks.hpp"
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cmath>
+#include <fcntl.h>
+#include <format>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+constexpr std::uint64_t MAGIC = 0x534B4E5254414C53ULL;  // "SLATRNKS"
+
+[[noreturn]] void throw_errno(const std::string& what) {
+  throw std::system_error(errno, std::generic_category(), what);
+}
+
+}  // namespace
+
+/**
+ * @brief Start of the store file; the Fenwick tree follows it.
+ *
+ * The counters are address-free lock-free atomics, so processes may map
+ * the file at different addresses.
+ */
+struct alignas(64) JumpRanks::Header {
+  std::atomic<std::uint64_t> magic;  ///< Set last by the creating process
+  std::uint64_t buckets;
+  std::uint32_t per_foot;
+  double ceiling;
+  alignas(64) std::atomic<std::uint64_t> jumps;
+};
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "mapped counters must be lock-free");
+
+/**
+ * @brief Opens the store, creating it if the file does not exist.
+ *
+ * The creator sizes the file (which zero-fills the tree), writes the
+ * geometry and finally the magic number; other processes wait for the
+ * magic before reading the geometry and mapping the whole tree.
+ */
+JumpRanks::JumpRanks(const std::filesystem::path& path, double ceiling, std::uint32_t per_foot) {
+  if (!(ceiling > 0) || per_foot == 0) throw std::invalid_argument("ceiling and resolution must be positive");
+
+  bool creator = true;
+  int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0666);
+  if (fd < 0 && errno == EEXIST) {
+    creator = false;
+    fd = ::open(path.c_str(), O_RDWR);
+  }
+  if (fd < 0) throw_errno("open " + path.string());
+
+  std::uint64_t buckets = static_cast<std::uint64_t>(std::ceil(ceiling * per_foot)) + 1;
+  if (creator) {
+    if (::ftruncate(fd, static_cast<off_t>(sizeof(Header) + (buckets + 1) * sizeof(std::uint64_t))) != 0) {
+      const int err = errno;
+      ::close(fd);
+      throw std::system_error(err, std::generic_category(), "ftruncate " + path.string());
+    }
+  } else {
+    // The creator may not have sized the file or written the header yet.
+    Header* existing = nullptr;
+    for (struct stat st {}; existing == nullptr;) {
+      if (::fstat(fd, &st) != 0) {
+        const int err = errno;
+        ::close(fd);
+        throw std::system_error(err, std::generic_category(), "fstat " + path.string());
+      }
+      if (static_cast<std::size_t>(st.st_size) < sizeof(Header)) {
+        std::this_thread::yield();
+        continue;
+      }
+      void* p = ::mmap(nullptr, sizeof(Header), PROT_READ, MAP_SHARED, fd, 0);
+      if (p == MAP_FAILED) {
+        const int err = errno;
+        ::close(fd);
+        throw std::system_error(err, std::generic_category(), "mmap " + path.string());
+      }
+      existing = static_cast<Header*>(p);
+    }
+    std::uint64_t magic;
+    while ((magic = existing->magic.load(std::memory_order_acquire)) == 0) std::this_thread::yield();
+    buckets = existing->buckets;
+    per_foot = existing->per_foot;
+    ::munmap(existing, sizeof(Header));
+    if (magic != MAGIC || buckets == 0 || per_foot == 0) {
+      ::close(fd);
+      throw std::runtime_error(path.string() + " is not a jump store");
+    }
+  }
+
+  mapped = sizeof(Header) + (buckets + 1) * sizeof(std::uint64_t);
+  void* p = ::mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  const int err = errno;
+  ::close(fd);
+  if (p == MAP_FAILED) throw std::system_error(err, std::generic_category(), "mmap " + path.string());
+  header = static_cast<Header*>(p);
+  tree = reinterpret_cast<std::atomic<std::uint64_t>*>(static_cast<char*>(p) + sizeof(Header));
+  size = buckets;
+  this->per_foot = per_foot;
+  top_bit = std::uint64_t{1} << (63 - std::countl_zero(size));
+
+  if (creator) {
+    header->buckets = buckets;
+    header->per_foot = per_foot;
+    header->ceiling = ceiling;
+    header->magic.store(MAGIC, std::memory_order_release);
+  }
+}
+
+JumpRanks::~JumpRanks() {
+  ::munmap(header, mapped);
+}
+
+std::uint64_t JumpRanks::bucket(double altitude) const {
+  if (!(altitude > 0)) return 0;
+  const double scaled = altitude * per_foot;
+  return scaled >= static_cast<double>(size - 1) ? size - 1 : static_cast<std::uint64_t>(scaled);
+}
+
+std::uint64_t JumpRanks::jumps() const {
+  return header->jumps.load(std::memory_order_acquire);
+}
+
+/**
+ * @brief Jumps in buckets 0 to bucket, summing at most log2(buckets) tree nodes.
+ */
+std::uint64_t JumpRanks::prefix(std::uint64_t bucket) const {
+  std::uint64_t sum = 0;
+  for (std::uint64_t i = bucket + 1; i > 0; i &= i - 1) sum += tree[i].load(std::memory_order_relaxed);
+  return sum;
+}
+
+/**
+ * @brief Ranks an altitude against every recorded jump.
+ *
+ * The jump count is read first: recorders update the tree before the
+ * count, so the tree holds at least those jumps, and any it holds beyond
+ * them are clamped away.
+ */
+JumpRanks::Rank JumpRanks::rank(double altitude) const {
+  Rank r;
+  r.jumps = jumps();
+  r.lower = std::min(prefix(bucket(altitude)), r.jumps);
+  return r;
+}
+
+JumpRanks::Rank JumpRanks::record(double altitude) {
+  const std::uint64_t b = bucket(altitude);
+  Rank r;
+  r.jumps = jumps();
+  r.lower = std::min(prefix(b), r.jumps);
+  for (std::uint64_t i = b + 1; i <= size; i += i & (~i + 1)) tree[i].fetch_add(1, std::memory_order_relaxed);
+  header->jumps.fetch_add(1, std::memory_order_release);
+  return r;
+}
+
+/**
+ * @brief Adds per-bucket counts in O(buckets).
+ *
+ * The counts are turned into tree nodes locally, each node adding itself
+ * to its parent once, and then every non-zero node is added to the store.
+ */
+void JumpRanks::merge(std::span<const std::uint64_t> counts) {
+  if (counts.size() != size) {
+    throw std::invalid_argument(std::format("{} counts for {} buckets", counts.size(), size));
+  }
+  std::vector<std::uint64_t> nodes(size + 1);
+  std::copy(counts.begin(), counts.end(), nodes.begin() + 1);
+  std::uint64_t total = 0;
+  for (std::uint64_t i = 1; i <= size; ++i) {
+    total += counts[i - 1];
+    const std::uint64_t parent = i + (i & (~i + 1));
+    if (parent <= size) nodes[parent] += nodes[i];
+  }
+  for (std::uint64_t i = 1; i <= size; ++i) {
+    if (nodes[i] != 0) tree[i].fetch_add(nodes[i], std::memory_order_relaxed);
+  }
+  header->jumps.fetch_add(total, std::memory_order_release);
+}
+
+/**
+ * @brief Walks down the tree from its highest power of two, as a binary
+ * search over prefix sums that reads each level once.
+ */
+double JumpRanks::altitude_at(double fraction) const {
+  const std::uint64_t total = jumps();
+  if (total == 0) return 0;
+  std::uint64_t wanted = static_cast<std::uint64_t>(std::ceil(std::clamp(fraction, 0.0, 1.0) * total));
+  wanted = std::clamp<std::uint64_t>(wanted, 1, total);
+
+  std::uint64_t position = 0;
+  for (std::uint64_t step = top_bit; step > 0; step >>= 1) {
+    if (position + step > size) continue;
+    const std::uint64_t count = tree[position + step].load(std::memory_order_relaxed);
+    if (count < wanted) {
+      position += step;
+      wanted -= count;
+    }
+  }
+  // Buckets before position hold fewer jumps than wanted, so the wanted jump is in bucket position.
+  return static_cast<double>(std::min(position + 1, size)) / per_foot;
+}
+
+void JumpRanks::sync() const {
+  if (::msync(header, mapped, MS_SYNC) != 0) throw_errno("msync");
+}
+
+/**
+ * @brief Lines 630-752, with K jumps before this one of which K-K1 opened lower.
+ */
+std::string rank_message(const JumpRanks::Rank& rank) {
+  static constexpr const char* ORDINALS[] = {"1ST", "2ND", "3RD"};
+  const std::uint64_t k = rank.jumps, lower = rank.lower, k1 = k - lower;
+  const double share = static_cast<double>(lower);
+  if (k <= 2) return std::format("AMAZING!!! NOT BAD FOR YOUR {} SUCCESSFUL JUMP!!!", ORDINALS[k]);
+  if (share <= .1 * k) {
+    return std::format("WOW!  THAT'S SOME JUMPING.  OF THE {} SUCCESSFUL JUMPS\n"
+                       "BEFORE YOURS, ONLY {} OPENED THEIR CHUTES LOWER THAN\n"
+                       "YOU DID.",
+                       k, lower);
+  }
+  if (share <= .25 * k) {
+    return std::format("PRETTY GOOD!  {} SUCCESSFUL JUMPS PRECEDED YOURS AND ONLY\n"
+                       "{} OF THEM GOT LOWER THAN YOU DID BEFORE THEIR CHUTES\n"
+                       "OPENED.",
+                       k, lower);
+  }
+  if (share <= .5 * k) {
+    return std::format("NOT BAD.  THERE HAVE BEEN {} SUCCESSFUL JUMPS BEFORE YOURS.\n"
+                       "YOU WERE BEATEN OUT BY {} OF THEM.",
+                       k, lower);
+  }
+  if (share <= .75 * k) {
+    return std::format("CONSERVATIVE, AREN'T YOU?  YOU RANKED ONLY {} IN THE\n"
+                       "{} SUCCESSFUL JUMPS BEFORE YOURS.",
+                       lower, k);
+  }
+  if (share <= .9 * k) {
+    return std::format("HUMPH!  DON'T YOU HAVE ANY SPORTING BLOOD?  THERE WERE\n"
+                       "{} SUCCESSFUL JUMPS BEFORE YOURS AND YOU CAME IN {} JUMPS\n"
+                       "BETTER THAN THE WORST.  SHAPE UP!!!",
+                       k, k1);
+  }
+  return std::format("HEY!  YOU PULLED THE RIP CORD MUCH TOO SOON.  {} SUCCESSFUL\n"
+                     "JUMPS BEFORE YOURS AND YOU CAME IN NUMBER {}!  GET WITH IT!",
+                     k, lower);
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+
+/**
+ * @brief Every successful SPLAT jump ever made, ranked by the altitude at
+ * which the chute opened.
+ *
+ * splat.bas keeps the last 42 altitudes in DIM A(42) and scans them for
+ * each new jump (lines 510-620). Here altitudes are quantized into fixed
+ * buckets (64 per foot by default) and counted in a Fenwick tree, so a jump
+ * is ranked against all history in O(log buckets) whatever the number of
+ * jumps, and the counts never overflow below 2^64 jumps.
+ *
+ * The tree lives in a memory-mapped file shared by every process that
+ * opens it: recording a jump is a handful of atomic additions, and ranking
+ * reads the tree without locks. A rank taken while another process records
+ * may or may not include that jump, but is never inconsistent with itself.
+ * Two altitudes in the same bucket count as equal, which the game treats as
+ * "lower" (line 570).
+ */
+class JumpRanks {
+public:
+  static constexpr double DEFAULT_CEILING = 10000;  ///< Highest starting altitude, INT(9001*RND(1)+1000)
+  static constexpr std::uint32_t DEFAULT_PER_FOOT = 64;
+
+  /**
+   * @brief K and K-K1 of lines 560-580.
+   */
+  struct Rank {
+    std::uint64_t jumps = 0;  ///< Successful jumps before this one (K)
+    std::uint64_t lower = 0;  ///< Of those, how many opened their chutes at this altitude or lower (K-K1)
+  };
+
+  /**
+   * @brief Opens the store, creating it if the file does not exist.
+   *
+   * An existing store keeps the ceiling and resolution it was created with.
+   *
+   * @param path Store file
+   * @param ceiling Highest altitude kept apart; anything above shares the top bucket
+   * @param per_foot Buckets per foot
+   * @throws std::system_error if the file cannot be opened or mapped
+   * @throws std::runtime_error if the file is not a jump store
+   */
+  explicit JumpRanks(const std::filesystem::path& path, double ceiling = DEFAULT_CEILING,
+                     std::uint32_t per_foot = DEFAULT_PER_FOOT);
+
+  ~JumpRanks();
+
+  JumpRanks(const JumpRanks&) = delete;
+  JumpRanks& operator=(const JumpRanks&) = delete;
+
+  /**
+   * @brief Ranks an altitude against every recorded jump.
+   */
+  Rank rank(double altitude) const;
+
+  /**
+   * @brief Ranks an altitude, then records it.
+   *
+   * @return The rank against the jumps before this one
+   */
+  Rank record(double altitude);
+
+  /**
+   * @brief Adds jumps already counted per bucket, such as another store's or a batch's.
+   *
+   * Costs O(buckets) however many jumps the counts hold.
+   *
+   * @param counts Jumps per bucket; must have buckets() entries
+   * @throws std::invalid_argument on a size mismatch
+   */
+  void merge(std::span<const std::uint64_t> counts);
+
+  /**
+   * @brief Lowest bucket altitude with at least the given fraction of jumps at or below it.
+   *
+   * @param fraction 0 to 1
+   * @return Altitude in feet at the top of that bucket, or 0 with no jumps recorded
+   */
+  double altitude_at(double fraction) const;
+
+  /**
+   * @brief Bucket holding an altitude.
+   */
+  std::uint64_t bucket(double altitude) const;
+
+  std::uint64_t buckets() const { return size; }
+  std::uint64_t jumps() const;
+
+  /**
+   * @brief Writes the mapped tree back to the file.
+   */
+  void sync() const;
+
+private:
+  struct Header;
+
+  std::uint64_t prefix(std::uint64_t bucket) const;
+
+  Header* header = nullptr;
+  std::atomic<std::uint64_t>* tree = nullptr;  ///< 1-based Fenwick tree, tree[0] unused
+  std::uint64_t size = 0;
+  std::uint64_t top_bit = 0;                   ///< Highest power of two not above size
+  double per_foot = 0;
+  std::size_t mapped = 0;
+};
+
+/**
+ * @brief What splat.bas prints after a successful jump (lines 630-752).
+ *
+ * @param rank Rank of the jump against those before it
+ * @return The message, lines separated by '\n'
+ */
+std::string rank_message(const JumpRanks::Rank& rank);
@@ -0,0 +1,132 @@
+#include "JumpRanks.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <optional>
+#include <print>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Loads simulated history into the store, then times ranking against it.
+ *
+ * Jumps start from INT(9001*RND(1)+1000) feet, as line 118 draws the
+ * altitude, and open their chutes at a uniformly random height below it.
+ * They are counted per bucket in memory and merged into the store at
+ * once; the timed ranks and records then run against the full history.
+ *
+ * @param ranks Empty store to load
+ * @param jumps Simulated jumps to add
+ * @param queries Ranks and records to time
+ * @param seed Random seed
+ * @throws std::runtime_error if the store already holds jumps, which simulated ones would mix with
+ */
+void benchmark(JumpRanks& ranks, std::uint64_t jumps, std::uint64_t queries, std::uint64_t seed) {
+  if (ranks.jumps() != 0) {
+    throw std::runtime_error(std::format("the store already holds {} jumps; bench against a new one",
+                                         ranks.jumps()));
+  }
+  std::mt19937_64 rng(seed);
+  std::uniform_real_distribution<double> rnd(0.0, 1.0);
+  auto altitude = [&] { return std::floor(9001 * rnd(rng) + 1000) * rnd(rng); };
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::uint64_t> counts(ranks.buckets());
+  for (std::uint64_t j = 0; j < jumps; ++j) ++counts[ranks.bucket(altitude())];
+  std::chrono::duration<double> counted = std::chrono::steady_clock::now() - start;
+  start = std::chrono::steady_clock::now();
+  ranks.merge(counts);
+  std::chrono::duration<double> merged = std::chrono::steady_clock::now() - start;
+
+  std::vector<double> altitudes(queries);
+  for (double& a : altitudes) a = altitude();
+
+  std::uint64_t checksum = 0;
+  start = std::chrono::steady_clock::now();
+  for (double a : altitudes) checksum += ranks.rank(a).lower;
+  std::chrono::duration<double> ranked = std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  for (double a : altitudes) checksum += ranks.record(a).lower;
+  std::chrono::duration<double> recorded = std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  double sum = 0;
+  for (std::uint64_t q = 0; q < queries; ++q) sum += ranks.altitude_at(static_cast<double>(q) / queries);
+  std::chrono::duration<double> percentiles = std::chrono::steady_clock::now() - start;
+
+  std::println("JUMPS STORED:  {}", ranks.jumps());
+  std::println("BUCKETS:       {} ({:.1f} MB)", ranks.buckets(), ranks.buckets() * 8 / 1e6);
+  std::println("LOAD:          {:.2f} S TO COUNT, {:.3f} S TO MERGE", counted.count(), merged.count());
+  std::println("RANK:          {:.0f} NS", ranked.count() / queries * 1e9);
+  std::println("RECORD:        {:.0f} NS", recorded.count() / queries * 1e9);
+  std::println("PERCENTILE:    {:.0f} NS", percentiles.count() / queries * 1e9);
+  std::println("MEDIAN:        {:.2f} FT", ranks.altitude_at(0.5));
+  std::println("CHECKSUM:      {} {:.1f}", checksum, sum);
+}
+
+/**
+ * @brief Entry point for the SPLAT jump ranking store.
+ *
+ * --record ranks a successful jump against every one before it, records
+ * it and prints what splat.bas would say; --rank only ranks. --bench loads
+ * N simulated jumps into a new store, never the default splat.ranks, and
+ * times ranking against them.
+ *
+ * Usage: SplatRanks [--store FILE] (--record ALTITUDE | --rank ALTITUDE)
+ *        SplatRanks --store FILE --bench JUMPS [--queries N] [--seed N]
+ */
+int main(int argc, char* argv[]) {
+  std::optional<std::filesystem::path> store;
+  std::optional<double> record, rank;
+  std::optional<std::uint64_t> bench;
+  std::uint64_t queries = 1'000'000;
+  std::uint64_t seed = 1;
+
+  for (int i = 1; i + 1 < argc; i += 2) {
+    std::string_view flag = argv[i];
+    if (flag == "--store") {
+      store = argv[i + 1];
+    } else if (flag == "--record") {
+      record = std::stod(argv[i + 1]);
+    } else if (flag == "--rank") {
+      rank = std::stod(argv[i + 1]);
+    } else if (flag == "--bench") {
+      bench = std::stoull(argv[i + 1]);
+    } else if (flag == "--queries") {
+      queries = std::stoull(argv[i + 1]);
+    } else if (flag == "--seed") {
+      seed = std::stoull(argv[i + 1]);
+    } else {
+      argc = 0;
+      break;
+    }
+  }
+  if (argc % 2 == 0 || record.has_value() + rank.has_value() + bench.has_value() != 1 || queries == 0 ||
+      (bench && !store)) {
+    std::println(stderr, "Usage: SplatRanks [--store FILE] (--record ALTITUDE | --rank ALTITUDE)");
+    std::println(stderr, "       SplatRanks --store FILE --bench JUMPS [--queries N] [--seed N]");
+    return EXIT_FAILURE;
+  }
+
+  try {
+    JumpRanks ranks(store.value_or("splat.ranks"));
+    if (record) {
+      std::println("{}", rank_message(ranks.record(*record)));
+    } else if (rank) {
+      const JumpRanks::Rank r = ranks.rank(*rank);
+      std::println("K={}  K-K1={}  ({:.2f}% OPENED AT OR BELOW {} FT)", r.jumps, r.lower,
+                   r.jumps ? 100.0 * r.lower / r.jumps : 0.0, *rank);
+    } else {
+      benchmark(ranks, *bench, queries, seed);
+    }
+    ranks.sync();
+  } catch (const std::exception& e) {
+    std::println(stderr, "Error: {}", e.what());
+    return EXIT_FAILURE;
+  }
+}
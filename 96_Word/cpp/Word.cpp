@@ -0,0 +1,341 @@
+#include "Word.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <fcntl.h>
+#include <limits>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <system_error>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+
+namespace word {
+
+namespace {
+
+/**
+ * @brief One more than the largest Feedback value (5 base-6 digits, then 5 mask bits).
+ */
+constexpr std::size_t FEEDBACK_VALUES = 7776u << LENGTH;
+
+/**
+ * @brief Letter index that never matches a real letter, used to pad guesses.
+ */
+constexpr std::uint8_t NO_LETTER = 0xFF;
+
+/**
+ * @brief The distinct letters of a guess, padded to LENGTH with NO_LETTER.
+ */
+Code distinct_letters(const Code& guess) {
+  Code distinct;
+  distinct.fill(NO_LETTER);
+  std::size_t count = 0;
+  for (std::uint8_t letter : guess) {
+    if (std::find(distinct.begin(), distinct.begin() + count, letter) == distinct.begin() + count) {
+      distinct[count++] = letter;
+    }
+  }
+  return distinct;
+}
+
+unsigned worker_count(unsigned threads) {
+  return threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+}
+
+}  // namespace
+
+/**
+ * @brief Returns the secret words from the program's DATA statements.
+ */
+std::vector<std::string> default_words() {
+  return {"DINKY", "SMOKE", "WATER", "GRASS", "TRAIN", "MIGHT",
+          "FIRST", "CANDY", "CHAMP", "WOULD", "CLUMP", "DOPEY"};
+}
+
+/**
+ * @brief Packs a word into letter indices.
+ *
+ * @param word Candidate word, upper or lower case
+ * @return Packed word, or empty if it is not exactly five letters
+ */
+std::optional<Code> pack(std::string_view word) {
+  if (word.size() != LENGTH) return std::nullopt;
+  Code code;
+  for (std::size_t i = 0; i < LENGTH; ++i) {
+    char c = word[i];
+    if (c >= 'a' && c <= 'z') c = static_cast<char>(c - 'a' + 'A');
+    if (c < 'A' || c > 'Z') return std::nullopt;
+    code[i] = static_cast<std::uint8_t>(c - 'A');
+  }
+  return code;
+}
+
+/**
+ * @brief Computes the clues for one guess against one answer.
+ *
+ * Mirrors the nested loops at lines 210-265: secret letters are visited in
+ * order and every one that occurs in the guess contributes to P$.
+ *
+ * @param guess Packed guess
+ * @param answer Packed secret word
+ * @return Packed clues
+ */
+Feedback feedback(const Code& guess, const Code& answer) {
+  const Code distinct = distinct_letters(guess);
+  Feedback mask = 0;
+  Feedback sequence = 0;
+  for (std::size_t i = 0; i < LENGTH; ++i) {
+    if (answer[i] == guess[i]) mask |= 1u << i;
+    auto it = std::find(distinct.begin(), distinct.end(), answer[i]);
+    if (it != distinct.end()) {
+      sequence = sequence * 6 + static_cast<Feedback>(it - distinct.begin()) + 1;
+    }
+  }
+  return mask | sequence << LENGTH;
+}
+
+/**
+ * @brief Builds the full guess-by-answer table.
+ *
+ * Answers are transposed into one column of letters per position so that
+ * each row is computed by a branch-free loop over contiguous bytes, which
+ * the compiler turns into vector compares and selects. Rows are handed out
+ * to workers through a shared counter.
+ */
+FeedbackMatrix::FeedbackMatrix(std::span<const Code> words, unsigned threads,
+                               const std::optional<std::filesystem::path>& backing_file)
+  : n(words.size()) {
+  if (backing_file) {
+    int fd = ::open(backing_file->c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) throw std::system_error(errno, std::generic_category(), backing_file->string());
+    if (::ftruncate(fd, static_cast<off_t>(bytes())) != 0) {
+      int err = errno;
+      ::close(fd);
+      throw std::system_error(err, std::generic_category(), "ftruncate");
+    }
+    void* p = bytes() ? ::mmap(nullptr, bytes(), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : nullptr;
+    ::close(fd);
+    if (p == MAP_FAILED) throw std::system_error(errno, std::generic_category(), "mmap");
+    data = static_cast<Feedback*>(p);
+    mapped = true;
+  } else {
+    heap.resize(n * n);
+    data = heap.data();
+  }
+
+  Columns answers;
+  for (std::size_t p = 0; p < LENGTH; ++p) {
+    answers[p].resize(n);
+    for (std::size_t k = 0; k < n; ++k) answers[p][k] = words[k][p];
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  {
+    std::atomic<std::size_t> next_row{0};
+    std::vector<std::jthread> workers;
+    for (unsigned w = 0; w < worker_count(threads); ++w) {
+      workers.emplace_back([&] {
+        for (std::size_t g = next_row++; g < n; g = next_row++) {
+          fill_row(answers, words[g], data + g * n);
+        }
+      });
+    }
+  }
+  seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * @brief Releases the mapping, if any.
+ */
+FeedbackMatrix::~FeedbackMatrix() {
+  if (mapped && data) ::munmap(data, bytes());
+}
+
+/**
+ * @brief Computes one row of the table.
+ *
+ * @param answers Answer letters, one column per position
+ * @param guess Packed guess for this row
+ * @param out Destination for the row
+ */
+void FeedbackMatrix::fill_row(const Columns& answers, const Code& guess, Feedback* out) {
+  const Code distinct = distinct_letters(guess);
+  const std::size_t count = answers[0].size();
+
+  for (std::size_t k = 0; k < count; ++k) {
+    Feedback mask = 0;
+    Feedback sequence = 0;
+    for (std::size_t i = 0; i < LENGTH; ++i) {
+      const std::uint8_t letter = answers[i][k];
+      mask |= static_cast<Feedback>(letter == guess[i]) << i;
+
+      Feedback digit = 0;
+      for (std::size_t d = 0; d < LENGTH; ++d) {
+        digit = letter == distinct[d] ? static_cast<Feedback>(d + 1) : digit;
+      }
+      sequence = digit ? sequence * 6 + digit : sequence;
+    }
+    out[k] = mask | sequence << LENGTH;
+  }
+}
+
+/**
+ * @brief Constructs a solver over a prebuilt matrix.
+ */
+Solver::Solver(const FeedbackMatrix& matrix) : matrix(matrix) {}
+
+/**
+ * @brief Picks the guess whose clues split the candidates most evenly.
+ *
+ * Maximising entropy is the same as minimising the sum of c*log2(c) over
+ * the clue buckets. Ties go to guesses that could themselves be the answer.
+ *
+ * @param candidates Answers still possible
+ * @param counts Scratch buffer of FEEDBACK_VALUES counters, left zeroed
+ * @return Row index of the chosen guess
+ */
+std::size_t Solver::best_guess(std::span<const std::uint32_t> candidates,
+                               std::vector<std::uint32_t>& counts) const {
+  if (candidates.size() == 1) return candidates.front();
+  counts.resize(FEEDBACK_VALUES);
+
+  std::vector<bool> is_candidate(matrix.size(), false);
+  for (std::uint32_t c : candidates) is_candidate[c] = true;
+
+  std::size_t best = candidates.front();
+  double best_score = std::numeric_limits<double>::infinity();
+  for (std::size_t g = 0; g < matrix.size(); ++g) {
+    std::span<const Feedback> row = matrix.row(g);
+    for (std::uint32_t c : candidates) ++counts[row[c]];
+
+    double score = 0;
+    for (std::uint32_t c : candidates) {
+      std::uint32_t& bucket = counts[row[c]];
+      if (bucket) {
+        score += bucket * std::log2(static_cast<double>(bucket));
+        bucket = 0;
+      }
+    }
+
+    if (score < best_score || (score == best_score && is_candidate[g] && !is_candidate[best])) {
+      best = g;
+      best_score = score;
+    }
+  }
+  return best;
+}
+
+/**
+ * @brief Plays one game against a known answer.
+ *
+ * @param answer Column index of the secret word
+ * @param counts Scratch buffer for best_guess
+ * @param opening First guess, if already known
+ * @return Number of guesses taken
+ */
+int Solver::solve(std::size_t answer, std::vector<std::uint32_t>& counts,
+                  std::optional<std::size_t> opening) const {
+  std::vector<std::uint32_t> candidates(matrix.size());
+  for (std::uint32_t i = 0; i < candidates.size(); ++i) candidates[i] = i;
+
+  std::size_t guess = opening ? *opening : best_guess(candidates, counts);
+  return play(answer, std::move(candidates), guess, 1, 0, counts);
+}
+
+/**
+ * @brief Continues a game from a known position.
+ *
+ * The game ends when the accumulated exact matches cover every position,
+ * which includes guessing the word itself (line 286).
+ *
+ * @param answer Column index of the secret word
+ * @param candidates Answers consistent with the clues so far
+ * @param guess Guess to make next
+ * @param guesses Number of that guess in the game, 1-based
+ * @param known Exact-match mask accumulated so far
+ * @param counts Scratch buffer for best_guess
+ * @return Number of guesses taken
+ */
+int Solver::play(std::size_t answer, std::vector<std::uint32_t> candidates, std::size_t guess,
+                 int guesses, Feedback known, std::vector<std::uint32_t>& counts) const {
+  for (;; ++guesses) {
+    Feedback clue = matrix.at(guess, answer);
+    known |= clue & EXACT_MASK;
+    if (known == EXACT_MASK) return guesses;
+
+    std::span<const Feedback> row = matrix.row(guess);
+    std::erase_if(candidates, [&](std::uint32_t c) { return row[c] != clue; });
+    guess = best_guess(candidates, counts);
+  }
+}
+
+/**
+ * @brief Solves every answer, spreading the work over worker threads.
+ *
+ * The opening guess does not depend on the answer, so it is chosen once.
+ * Answers are then bucketed by the opening clue: every answer in a bucket
+ * shares the same candidate set and therefore the same second guess, which
+ * is also chosen once per bucket. Workers take whole buckets.
+ */
+SolveStats Solver::solve_all(unsigned threads) const {
+  const unsigned workers_wanted = worker_count(threads);
+  std::vector<std::vector<std::uint64_t>> histograms(workers_wanted);
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::uint32_t> all(matrix.size());
+  for (std::uint32_t i = 0; i < all.size(); ++i) all[i] = i;
+  std::vector<std::uint32_t> counts;
+  const std::size_t opening = all.empty() ? 0 : best_guess(all, counts);
+
+  std::unordered_map<Feedback, std::vector<std::uint32_t>> by_clue;
+  for (std::uint32_t a : all) by_clue[matrix.at(opening, a)].push_back(a);
+  std::vector<std::pair<Feedback, std::vector<std::uint32_t>>> buckets(by_clue.begin(), by_clue.end());
+
+  {
+    std::atomic<std::size_t> next_bucket{0};
+    std::vector<std::jthread> workers;
+    for (unsigned w = 0; w < workers_wanted; ++w) {
+      workers.emplace_back([&, w] {
+        std::vector<std::uint32_t> scratch;
+        auto record = [&](std::size_t g) {
+          if (histograms[w].size() <= g) histograms[w].resize(g + 1);
+          ++histograms[w][g];
+        };
+
+        for (std::size_t b = next_bucket++; b < buckets.size(); b = next_bucket++) {
+          const auto& [clue, group] = buckets[b];
+          const Feedback known = clue & EXACT_MASK;
+          if (known == EXACT_MASK) {
+            for (std::size_t i = 0; i < group.size(); ++i) record(1);
+            continue;
+          }
+
+          const std::size_t second = best_guess(group, scratch);
+          for (std::uint32_t a : group) {
+            record(static_cast<std::size_t>(play(a, group, second, 2, known, scratch)));
+          }
+        }
+      });
+    }
+  }
+
+  SolveStats stats;
+  stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::uint64_t total = 0;
+  for (const auto& h : histograms) {
+    if (stats.histogram.size() < h.size()) stats.histogram.resize(h.size());
+    for (std::size_t g = 0; g < h.size(); ++g) {
+      stats.histogram[g] += h[g];
+      total += g * h[g];
+      if (h[g]) stats.worst_guesses = std::max(stats.worst_guesses, static_cast<int>(g));
+    }
+  }
+  stats.average_guesses = matrix.size() ? static_cast<double>(total) / matrix.size() : 0;
+  return stats;
+}
+
+}  // namespace word
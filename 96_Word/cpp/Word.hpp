@@ -0,0 +1,156 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Feedback matrix and entropy solver for WORD (word.bas lines 170-290).
+ *
+ * After each guess the BASIC program prints the letters of the secret word
+ * that also occur in the guess (P$, in secret-word order, each repeated once
+ * per occurrence in the guess) and adds exact positional matches to the
+ * running pattern A$. The game is won as soon as A$ spells the secret word.
+ */
+namespace word {
+
+inline constexpr std::size_t LENGTH = 5;
+
+/**
+ * @brief A word packed as five letter indices (0 = 'A').
+ */
+using Code = std::array<std::uint8_t, LENGTH>;
+
+/**
+ * @brief Everything one guess reveals, packed into an integer.
+ *
+ * Bits 0-4 hold the exact-match mask. The remaining bits hold the secret's
+ * letters that occur in the guess, in secret order, as base-6 digits 1-5
+ * naming which distinct guess letter each one is. Two answers get the same
+ * Feedback exactly when the game would print the same clues for them.
+ */
+using Feedback = std::uint32_t;
+
+inline constexpr Feedback EXACT_MASK = (1u << LENGTH) - 1;
+
+/**
+ * @brief The twelve words from the DATA statements at lines 530-540.
+ */
+std::vector<std::string> default_words();
+
+/**
+ * @brief Packs a five-letter word; empty if it is not five letters A-Z.
+ */
+std::optional<Code> pack(std::string_view word);
+
+/**
+ * @brief Scalar reference implementation of the game's clues.
+ */
+Feedback feedback(const Code& guess, const Code& answer);
+
+/**
+ * @brief Guess-by-answer table of Feedback values.
+ *
+ * Rows are guesses and columns are answers. Small tables live on the heap;
+ * when a backing file is given the table is written to and read from a
+ * memory-mapped file instead, so large lists need not fit in RAM.
+ */
+class FeedbackMatrix {
+public:
+  /**
+   * @brief Builds the matrix for every word against every word.
+   *
+   * @param words Packed word list
+   * @param threads Worker count; 0 uses the hardware concurrency
+   * @param backing_file If set, the table is memory-mapped from this file
+   */
+  FeedbackMatrix(std::span<const Code> words, unsigned threads = 0,
+                 const std::optional<std::filesystem::path>& backing_file = std::nullopt);
+  ~FeedbackMatrix();
+
+  FeedbackMatrix(const FeedbackMatrix&) = delete;
+  FeedbackMatrix& operator=(const FeedbackMatrix&) = delete;
+
+  std::size_t size() const { return n; }
+  Feedback at(std::size_t guess, std::size_t answer) const { return data[guess * n + answer]; }
+  std::span<const Feedback> row(std::size_t guess) const { return {data + guess * n, n}; }
+
+  /**
+   * @brief Seconds spent filling the table.
+   */
+  double build_seconds() const { return seconds; }
+
+  /**
+   * @brief Bytes occupied by the table.
+   */
+  std::size_t bytes() const { return n * n * sizeof(Feedback); }
+
+private:
+  std::size_t n;
+  Feedback* data = nullptr;
+  std::vector<Feedback> heap;  ///< Storage when not memory-mapped
+  bool mapped = false;
+  double seconds = 0;
+
+  using Columns = std::array<std::vector<std::uint8_t>, LENGTH>;
+
+  static void fill_row(const Columns& answers, const Code& guess, Feedback* out);
+};
+
+/**
+ * @brief Summary of solving every answer in the list.
+ */
+struct SolveStats {
+  double average_guesses = 0;
+  int worst_guesses = 0;
+  std::vector<std::uint64_t> histogram;  ///< histogram[g] answers solved in g guesses
+  double seconds = 0;
+};
+
+/**
+ * @brief Greedy solver that picks the guess with the most informative clues.
+ */
+class Solver {
+public:
+  explicit Solver(const FeedbackMatrix& matrix);
+
+  /**
+   * @brief Guess that maximises the entropy of the clues over the candidates.
+   *
+   * @param candidates Answers still consistent with every clue so far
+   * @param counts Scratch buffer reused between calls
+   */
+  std::size_t best_guess(std::span<const std::uint32_t> candidates,
+                         std::vector<std::uint32_t>& counts) const;
+
+  /**
+   * @brief Number of guesses needed for one answer.
+   *
+   * @param answer Column index of the secret word
+   * @param counts Scratch buffer for best_guess
+   * @param opening First guess, if already known; it is the same for every answer
+   */
+  int solve(std::size_t answer, std::vector<std::uint32_t>& counts,
+            std::optional<std::size_t> opening = std::nullopt) const;
+
+  /**
+   * @brief Solves every answer in parallel.
+   *
+   * @param threads Worker count; 0 uses the hardware concurrency
+   */
+  SolveStats solve_all(unsigned threads = 0) const;
+
+private:
+  const FeedbackMatrix& matrix;
+
+  int play(std::size_t answer, std::vector<std::uint32_t> candidates, std::size_t guess,
+           int guesses, Feedback known, std::vector<std::uint32_t>& counts) const;
+};
+
+}  // namespace word
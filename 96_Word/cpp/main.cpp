@@ -0,0 +1,87 @@
+#include "Word.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <print>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Reads one word per line, keeping only five-letter words.
+ */
+std::vector<word::Code> load_words(const std::vector<std::string>& lines) {
+  std::vector<word::Code> words;
+  for (const std::string& line : lines) {
+    if (auto code = word::pack(line)) words.push_back(*code);
+  }
+  std::ranges::sort(words);
+  auto [first, last] = std::ranges::unique(words);
+  words.erase(first, last);
+  return words;
+}
+
+/**
+ * @brief Entry point for the WORD solver benchmark.
+ *
+ * Usage: WordSolver [--words FILE] [--map FILE] [--threads N]
+ */
+int main(int argc, char* argv[]) {
+  std::vector<std::string> lines = word::default_words();
+  std::optional<std::filesystem::path> map_file;
+  unsigned threads = 0;
+
+  for (int i = 1; i + 1 < argc; i += 2) {
+    std::string_view flag = argv[i];
+    if (flag == "--words") {
+      std::ifstream in(argv[i + 1]);
+      if (!in) {
+        std::println(stderr, "Error: cannot open {}", argv[i + 1]);
+        return EXIT_FAILURE;
+      }
+      lines.clear();
+      for (std::string line; std::getline(in, line);) lines.push_back(line);
+    } else if (flag == "--map") {
+      map_file = argv[i + 1];
+    } else if (flag == "--threads") {
+      threads = static_cast<unsigned>(std::stoul(argv[i + 1]));
+    } else {
+      std::println(stderr, "Usage: WordSolver [--words FILE] [--map FILE] [--threads N]");
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::vector<word::Code> words = load_words(lines);
+  if (words.empty()) {
+    std::println(stderr, "Error: no five-letter words");
+    return EXIT_FAILURE;
+  }
+
+  try {
+    word::FeedbackMatrix matrix(words, threads, map_file);
+    std::println("WORDS: {}  MATRIX: {:.1f} MB{}", words.size(), matrix.bytes() / 1e6,
+                 map_file ? " (MEMORY-MAPPED)" : "");
+    std::println("MATRIX BUILD: {:.4f}s  ({:.1f} M CLUES/SEC)", matrix.build_seconds(),
+                 words.size() * words.size() / matrix.build_seconds() / 1e6);
+
+    // Spot-check the vectorised rows against the scalar clue rules.
+    for (std::size_t g = 0; g < words.size(); g += std::max<std::size_t>(1, words.size() / 64)) {
+      for (std::size_t a = 0; a < words.size(); ++a) {
+        if (matrix.at(g, a) != word::feedback(words[g], words[a])) {
+          std::println(stderr, "Error: matrix mismatch at guess {} answer {}", g, a);
+          return EXIT_FAILURE;
+        }
+      }
+    }
+
+    word::Solver solver(matrix);
+    word::SolveStats stats = solver.solve_all(threads);
+    std::println("AVERAGE GUESSES: {:.4f}  WORST: {}  SOLVE TIME: {:.3f}s",
+                 stats.average_guesses, stats.worst_guesses, stats.seconds);
+    for (std::size_t g = 1; g < stats.histogram.size(); ++g) {
+      std::println("  {} GUESSES: {}", g, stats.histogram[g]);
+    }
+  } catch (const std::exception& e) {
+    std::println(stderr, "Error: {}", e.what());
+    return EXIT_FAILURE;
+  }
+}